@@ -0,0 +1,159 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include <higs/runtime.hpp>
+#include "AllocationCounter.hpp"
+
+using namespace higs;
+
+namespace {
+
+enum class Dispatch { Later, WithPriority, InBackground, After };
+
+void dispatch(jsrt::Agent& agent, Dispatch method, jsrt::Agent::Func func)
+{
+    switch (method) {
+    case Dispatch::Later: agent.runLater(std::move(func)); break;
+    case Dispatch::WithPriority: agent.runWithPriority(std::move(func), 0); break;
+    case Dispatch::InBackground: agent.runInBackground(std::move(func)); break;
+    case Dispatch::After: agent.runAfter(std::move(func), std::chrono::milliseconds { 0 }); break;
+    }
+}
+
+}
+
+/**
+ * Round trip of a single task: time from dispatch until the dispatching thread learns it ran.
+ */
+static void BM_AgentLatency(benchmark::State& state, Dispatch method)
+{
+    auto host = Runtime::create();
+    auto& agent = host->createEnvironment("bench").agent();
+
+    for (auto _ : state) {
+        folly::Baton<> done;
+        dispatch(agent, method, [&done] { done.post(); });
+        done.wait();
+    }
+}
+BENCHMARK_CAPTURE(BM_AgentLatency, runLater, Dispatch::Later)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentLatency, runWithPriority, Dispatch::WithPriority)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentLatency, runInBackground, Dispatch::InBackground)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentLatency, runAfter, Dispatch::After)->UseRealTime();
+
+static void BM_AgentLatencyRunNowBlocking(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& agent = host->createEnvironment("bench").agent();
+
+    for (auto _ : state) {
+        agent.runNowBlocking([] {});
+    }
+}
+BENCHMARK(BM_AgentLatencyRunNowBlocking)->UseRealTime();
+
+/**
+ * Dispatches a burst of tasks and waits for all of them, measuring sustained task throughput.
+ */
+static void BM_AgentThroughput(benchmark::State& state, Dispatch method)
+{
+    auto host = Runtime::create();
+    auto& agent = host->createEnvironment("bench").agent();
+    const auto tasks = state.range(0);
+
+    // Padding makes the task as large as a typical environment task (scheduled function and its environment)
+    std::array<std::byte, 64> payload {};
+    auto allocationsBefore = bench::allocationCount();
+
+    for (auto _ : state) {
+        folly::Baton<> done;
+        std::atomic<int64_t> remaining = tasks;
+        for (int64_t i = 0; i < tasks; ++i) {
+            dispatch(agent, method, [&, payload] {
+                benchmark::DoNotOptimize(payload);
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    done.post();
+                }
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+    state.counters["allocs_per_task"] = static_cast<double>(bench::allocationCount() - allocationsBefore)
+        / static_cast<double>(state.iterations() * tasks);
+}
+BENCHMARK_CAPTURE(BM_AgentThroughput, runLater, Dispatch::Later)->Arg(10000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentThroughput, runWithPriority, Dispatch::WithPriority)->Arg(10000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentThroughput, runInBackground, Dispatch::InBackground)->Arg(10000)->UseRealTime();
+BENCHMARK_CAPTURE(BM_AgentThroughput, runAfter, Dispatch::After)->Arg(10000)->UseRealTime();
+
+/**
+ * Measures how late timers fire compared to their requested delay.
+ */
+static void BM_TimerOvershoot(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& agent = host->createEnvironment("bench").agent();
+    const std::chrono::milliseconds delay { state.range(0) };
+
+    int64_t totalOvershootUs = 0;
+    for (auto _ : state) {
+        folly::Baton<> done;
+        auto scheduledAt = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point firedAt;
+        agent.runAfter(
+            [&] {
+                firedAt = std::chrono::steady_clock::now();
+                done.post();
+            },
+            delay
+        );
+        done.wait();
+        auto overshoot = firedAt - scheduledAt - delay;
+        totalOvershootUs += std::chrono::duration_cast<std::chrono::microseconds>(overshoot).count();
+    }
+    state.counters["overshoot_us"] = benchmark::Counter(
+        static_cast<double>(totalOvershootUs),
+        benchmark::Counter::kAvgIterations
+    );
+}
+BENCHMARK(BM_TimerOvershoot)->Arg(1)->Arg(10)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+/**
+ * Schedules tasks through `Environment::runLater`, which wraps them with a reference to the environment.
+ */
+static void BM_EnvironmentRunLater(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("bench");
+    const auto tasks = state.range(0);
+
+    std::array<std::byte, 32> payload {};
+    auto allocationsBefore = bench::allocationCount();
+
+    for (auto _ : state) {
+        folly::Baton<> done;
+        std::atomic<int64_t> remaining = tasks;
+        for (int64_t i = 0; i < tasks; ++i) {
+            env.runLater([&, payload](jsrt::Environment&) {
+                benchmark::DoNotOptimize(payload);
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    done.post();
+                }
+            });
+        }
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+    state.counters["allocs_per_task"] = static_cast<double>(bench::allocationCount() - allocationsBefore)
+        / static_cast<double>(state.iterations() * tasks);
+}
+BENCHMARK(BM_EnvironmentRunLater)->Arg(10000)->UseRealTime();
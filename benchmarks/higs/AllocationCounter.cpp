@@ -0,0 +1,103 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations = 0;
+
+auto countedAlloc(std::size_t size) -> void*
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+auto countedAlignedAlloc(std::size_t size, std::align_val_t alignment) -> void*
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}
+
+namespace higs::bench {
+
+auto allocationCount() noexcept -> uint64_t
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+}
+
+auto operator new(std::size_t size) -> void*
+{
+    return countedAlloc(size);
+}
+
+auto operator new[](std::size_t size) -> void*
+{
+    return countedAlloc(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void*
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void*
+{
+    return countedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
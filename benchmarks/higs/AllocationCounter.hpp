@@ -0,0 +1,19 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace higs::bench {
+
+/**
+ * Number of `operator new` calls made by the whole process so far.
+ *
+ * Counted by global allocation operators replaced in `higs-bench`.
+ */
+auto allocationCount() noexcept -> uint64_t;
+
+}
@@ -0,0 +1,55 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <fmt/format.h>
+
+namespace higs::bench {
+
+/**
+ * Bundle evaluated by startup and evaluation benchmarks.
+ *
+ * Uses file pointed by `HIGS_BENCH_BUNDLE` environment variable, or a synthetic bundle otherwise.
+ */
+inline auto bundleSource() -> const std::string&
+{
+    static const std::string source = [] {
+        if (const char* path = std::getenv("HIGS_BENCH_BUNDLE")) {
+            std::ifstream reader { path };
+            std::stringstream buffer;
+            buffer << reader.rdbuf();
+            return buffer.str();
+        }
+
+        std::string synthetic;
+        for (int i = 0; i < 2000; ++i) {
+            synthetic += fmt::format(
+                "globalThis.module{0} = {{ id: {0}, run(x) {{ return x * {0} + this.id; }}, "
+                "data: Array.from({{ length: 16 }}, (_, j) => j * {0}) }};\n",
+                i
+            );
+        }
+        return synthetic;
+    }();
+
+    return source;
+}
+
+/**
+ * Path of a scratch file in the temporary directory.
+ */
+inline auto temporaryPath(const std::string& name) -> std::string
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+}
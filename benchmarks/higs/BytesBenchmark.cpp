@@ -0,0 +1,134 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+/**
+ * Defines 1 MiB of binary data, and pure JS equivalents of `bytes` module functions as commonly polyfilled.
+ */
+constexpr const char* kSetup = R"(
+    globalThis.bytes = require('bytes');
+    globalThis.data = Uint8Array.from({ length: 1 << 20 }, (_, i) => (i * 131 + 7) & 0xFF);
+    globalThis.hex = bytes.toHex(data);
+    globalThis.needle = new TextEncoder().encode('needle');
+    globalThis.haystack = new Uint8Array(data.length + needle.length);
+    haystack.set(needle, data.length);
+
+    const digits = Array.from({ length: 256 }, (_, i) => i.toString(16).padStart(2, '0'));
+    globalThis.jsToHex = (input) => {
+        let out = '';
+        for (let i = 0; i < input.length; ++i) {
+            out += digits[input[i]];
+        }
+        return out;
+    };
+
+    globalThis.jsFromHex = (string) => {
+        const out = new Uint8Array(string.length >> 1);
+        for (let i = 0; i < out.length; ++i) {
+            out[i] = parseInt(string.substr(i * 2, 2), 16);
+        }
+        return out;
+    };
+
+    const alphabet = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+    globalThis.jsToBase64 = (input) => {
+        const parts = [];
+        let i = 0;
+        for (; i + 2 < input.length; i += 3) {
+            const n = (input[i] << 16) | (input[i + 1] << 8) | input[i + 2];
+            parts.push(alphabet[n >> 18] + alphabet[(n >> 12) & 63] + alphabet[(n >> 6) & 63] + alphabet[n & 63]);
+        }
+        if (i < input.length) {
+            const n = (input[i] << 16) | ((input[i + 1] ?? 0) << 8);
+            parts.push(alphabet[n >> 18] + alphabet[(n >> 12) & 63] + (i + 1 < input.length ? alphabet[(n >> 6) & 63] : '=') + '=');
+        }
+        return parts.join('');
+    };
+
+    globalThis.jsIndexOf = (input, pattern) => {
+        outer: for (let i = 0; i + pattern.length <= input.length; ++i) {
+            for (let j = 0; j < pattern.length; ++j) {
+                if (input[i + j] !== pattern[j]) {
+                    continue outer;
+                }
+            }
+            return i;
+        }
+        return -1;
+    };
+)";
+
+void runBytes(benchmark::State& state, const char* expression)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+
+    env.evaluateScript(kSetup, "setup.js");
+    auto operation = env.evaluateScript(std::string("(function () { return ") + expression + "; })").asObject(rt).asFunction(rt);
+    auto size = env.evaluateScript("data.length").asNumber();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(operation.call(rt));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+}
+
+static void BM_BytesToHexNative(benchmark::State& state)
+{
+    runBytes(state, "bytes.toHex(data)");
+}
+BENCHMARK(BM_BytesToHexNative)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesToHexJS(benchmark::State& state)
+{
+    runBytes(state, "jsToHex(data)");
+}
+BENCHMARK(BM_BytesToHexJS)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesFromHexNative(benchmark::State& state)
+{
+    runBytes(state, "bytes.fromHex(hex)");
+}
+BENCHMARK(BM_BytesFromHexNative)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesFromHexJS(benchmark::State& state)
+{
+    runBytes(state, "jsFromHex(hex)");
+}
+BENCHMARK(BM_BytesFromHexJS)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesToBase64Native(benchmark::State& state)
+{
+    runBytes(state, "bytes.toBase64(data)");
+}
+BENCHMARK(BM_BytesToBase64Native)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesToBase64JS(benchmark::State& state)
+{
+    runBytes(state, "jsToBase64(data)");
+}
+BENCHMARK(BM_BytesToBase64JS)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesIndexOfNative(benchmark::State& state)
+{
+    runBytes(state, "bytes.indexOf(haystack, needle)");
+}
+BENCHMARK(BM_BytesIndexOfNative)->Unit(benchmark::kMicrosecond);
+
+static void BM_BytesIndexOfJS(benchmark::State& state)
+{
+    runBytes(state, "jsIndexOf(haystack, needle)");
+}
+BENCHMARK(BM_BytesIndexOfJS)->Unit(benchmark::kMicrosecond);
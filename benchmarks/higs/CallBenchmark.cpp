@@ -0,0 +1,92 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <higs/runtime.hpp>
+#include <jsrt/conv.hpp>
+
+using namespace higs;
+namespace conv = jsrt::conv;
+
+static constexpr int kCallsPerIteration = 1000;
+
+/**
+ * Calls a host function from JS, converting its arguments and result through jsrt-conv.
+ */
+static void BM_CallNativeFromJS(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+
+    auto add = jsi::Function::createFromHostFunction(
+        rt,
+        jsi::PropNameID::forAscii(rt, "add"),
+        2,
+        [&env](jsi::Runtime&, const jsi::Value&, const jsi::Value* args, size_t) -> jsi::Value {
+            auto a = conv::fromJS<double>(args[0], env);
+            auto b = conv::fromJS<double>(args[1], env);
+            return conv::toJS(a + b, env);
+        }
+    );
+    rt.global().setProperty(rt, "nativeAdd", add);
+
+    auto loop = env.evaluateScript(fmt::format(
+                                       "(function () {{ let s = 0; for (let i = 0; i < {}; ++i) s = nativeAdd(s, i); "
+                                       "return s; }})",
+                                       kCallsPerIteration
+                                   ))
+                    .asObject(rt)
+                    .asFunction(rt);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(loop.call(rt));
+    }
+    state.SetItemsProcessed(state.iterations() * kCallsPerIteration);
+}
+BENCHMARK(BM_CallNativeFromJS);
+
+/**
+ * Calls a JS function from native code, converting its arguments and result through jsrt-conv.
+ */
+static void BM_CallJSFromNative(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+
+    auto add = env.evaluateScript("(function (a, b) { return a + b; })").asObject(rt).asFunction(rt);
+
+    for (auto _ : state) {
+        double sum = 0;
+        for (int i = 0; i < kCallsPerIteration; ++i) {
+            auto result = add.call(rt, conv::toJS(sum, env), conv::toJS(static_cast<double>(i), env));
+            sum = conv::fromJS<double>(result, env);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * kCallsPerIteration);
+}
+BENCHMARK(BM_CallJSFromNative);
+
+/**
+ * Passes strings both ways, which requires transcoding between UTF-8 and the JS representation.
+ */
+static void BM_CallJSFromNativeString(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+
+    auto upper = env.evaluateScript("(function (s) { return s.toUpperCase(); })").asObject(rt).asFunction(rt);
+    std::string input(static_cast<size_t>(state.range(0)), 'a');
+
+    for (auto _ : state) {
+        auto result = upper.call(rt, conv::toJS(input, env));
+        benchmark::DoNotOptimize(conv::fromJS<std::string>(result, env));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CallJSFromNativeString)->Range(16, 64 << 10);
@@ -0,0 +1,97 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <higs/ext/Compression.hpp>
+
+using namespace higs;
+using ext::CompressionFormat;
+
+namespace {
+
+/**
+ * About 32 MiB of log-like text.
+ */
+auto sampleData() -> const std::shared_ptr<const std::vector<uint8_t>>&
+{
+    static const auto data = [] {
+        std::string text;
+        for (size_t i = 0; text.size() < (32 << 20); ++i) {
+            text += fmt::format("{} INFO request {} served in {} ms\n", 1700000000 + i, i * 7919 % 100003, i % 97);
+        }
+        return std::make_shared<const std::vector<uint8_t>>(text.begin(), text.end());
+    }();
+
+    return data;
+}
+
+auto executor() -> folly::CPUThreadPoolExecutor&
+{
+    static folly::CPUThreadPoolExecutor executor { std::thread::hardware_concurrency() };
+    return executor;
+}
+
+}
+
+static void BM_ZstdCompress(benchmark::State& state)
+{
+    const auto& data = sampleData();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::compress(CompressionFormat::Zstd, *data));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data->size()));
+}
+BENCHMARK(BM_ZstdCompress)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ZstdCompressBlocks(benchmark::State& state)
+{
+    const auto& data = sampleData();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::compressBlocks(data, 4 << 20, std::nullopt, folly::getKeepAliveToken(executor())).get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data->size()));
+}
+BENCHMARK(BM_ZstdCompressBlocks)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ZstdDecompress(benchmark::State& state)
+{
+    const auto& data = sampleData();
+    auto compressed = ext::compress(CompressionFormat::Zstd, *data);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::decompress(CompressionFormat::Zstd, compressed->bytes()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data->size()));
+}
+BENCHMARK(BM_ZstdDecompress)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_ZstdDecompressBlocks(benchmark::State& state)
+{
+    const auto& data = sampleData();
+    auto compressed = ext::compressBlocks(data, 4 << 20, std::nullopt, folly::getKeepAliveToken(executor())).get();
+    auto bytes = compressed->bytes();
+    auto input = std::make_shared<const std::vector<uint8_t>>(bytes.begin(), bytes.end());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::decompressBlocks(input, folly::getKeepAliveToken(executor())).get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data->size()));
+}
+BENCHMARK(BM_ZstdDecompressBlocks)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GzipDecompress(benchmark::State& state)
+{
+    const auto& data = sampleData();
+    auto compressed = ext::compress(CompressionFormat::Gzip, *data);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::decompress(CompressionFormat::Gzip, compressed->bytes()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data->size()));
+}
+BENCHMARK(BM_GzipDecompress)->Unit(benchmark::kMillisecond)->UseRealTime();
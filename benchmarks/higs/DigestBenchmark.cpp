@@ -0,0 +1,42 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <higs/ext/Digest.hpp>
+
+using namespace higs;
+using ext::DigestAlgorithm;
+
+namespace {
+
+/**
+ * Hashes a buffer of `state.range(1)` bytes using algorithm `state.range(0)`, in order of `DigestAlgorithm`.
+ */
+void runDigest(benchmark::State& state)
+{
+    auto algorithm = static_cast<DigestAlgorithm>(state.range(0));
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(1)));
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ext::Digest::compute(algorithm, data));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+    state.SetLabel(std::string(ext::nameOf(algorithm)));
+}
+
+}
+
+static void BM_Digest(benchmark::State& state)
+{
+    runDigest(state);
+}
+BENCHMARK(BM_Digest)
+    ->ArgsProduct({ benchmark::CreateDenseRange(0, static_cast<int64_t>(DigestAlgorithm::Crc32c), 1), { 64, 1 << 20 } })
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,38 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <benchmark/benchmark.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+static void BM_CreateEnvironment(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    for (auto _ : state) {
+        auto& env = host->createEnvironment("bench");
+        state.PauseTiming();
+        host->destroyEnvironment(env);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_CreateEnvironment)->Unit(benchmark::kMicrosecond);
+
+static void BM_CreateAndDestroyEnvironment(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    for (auto _ : state) {
+        host->destroyEnvironment(host->createEnvironment("bench"));
+    }
+}
+BENCHMARK(BM_CreateAndDestroyEnvironment)->Unit(benchmark::kMicrosecond);
+
+static void BM_CreateRuntime(benchmark::State& state)
+{
+    for (auto _ : state) {
+        auto host = Runtime::create();
+        benchmark::DoNotOptimize(host);
+    }
+}
+BENCHMARK(BM_CreateRuntime)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,120 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <cstdlib>
+#include <fstream>
+
+#include <benchmark/benchmark.h>
+#include <higs/runtime.hpp>
+#include "BenchmarkCommon.hpp"
+
+using namespace higs;
+using bench::bundleSource;
+
+static constexpr auto kSmallScript = "(function () { let s = 0; for (let i = 0; i < 100; ++i) s += i; return s; })()";
+
+static void BM_EvaluateSmallSource(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(env.evaluateScript(kSmallScript, "small.js"));
+    }
+}
+BENCHMARK(BM_EvaluateSmallSource);
+
+/**
+ * Compiles once, and measures only execution of the resulting bytecode.
+ */
+static void BM_EvaluateSmallPrepared(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+    auto prepared = rt.prepareJavaScript(std::make_shared<jsi::StringBuffer>(kSmallScript), "small.js");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rt.evaluatePreparedJavaScript(prepared));
+    }
+}
+BENCHMARK(BM_EvaluateSmallPrepared);
+
+static void BM_EvaluateBundleSource(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto& env = host->createEnvironment("bench");
+        state.ResumeTiming();
+
+        env.evaluateScript(bundleSource(), "bundle.js");
+
+        state.PauseTiming();
+        host->destroyEnvironment(env);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bundleSource().size()));
+}
+BENCHMARK(BM_EvaluateBundleSource)->Unit(benchmark::kMillisecond);
+
+static void BM_EvaluateBundlePrepared(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto prepared = host->mainEnvironment().jsVirtualMachine().prepareJavaScript(
+        std::make_shared<jsi::StringBuffer>(bundleSource()),
+        "bundle.js"
+    );
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto& env = host->createEnvironment("bench");
+        state.ResumeTiming();
+
+        env.jsVirtualMachine().evaluatePreparedJavaScript(prepared);
+
+        state.PauseTiming();
+        host->destroyEnvironment(env);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_EvaluateBundlePrepared)->Unit(benchmark::kMillisecond);
+
+/**
+ * Loads a script file through `Environment::evaluateFile`, the way input files and modules are loaded.
+ *
+ * Benchmarks bytecode file pointed by `HIGS_BENCH_BYTECODE` (compiled with `hermesc -emit-binary`)
+ * when `loadBytecode` is set, and bundle source otherwise.
+ */
+static void BM_EvaluateFile(benchmark::State& state, bool loadBytecode)
+{
+    std::string path;
+    if (loadBytecode) {
+        const char* bytecodePath = std::getenv("HIGS_BENCH_BYTECODE");
+        if (bytecodePath == nullptr) {
+            state.SkipWithError("HIGS_BENCH_BYTECODE is not set");
+            return;
+        }
+        path = bytecodePath;
+    }
+    else {
+        path = bench::temporaryPath("higs-bench-bundle.js");
+        std::ofstream { path } << bundleSource();
+    }
+
+    auto host = Runtime::create(RuntimeOptions().withDefaultEnvironmentOptions(
+        EnvironmentOptions().withSourcePreference(SourcePreference::PreferSource)
+    ));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto& env = host->createEnvironment("bench");
+        state.ResumeTiming();
+
+        env.evaluateFile(path);
+
+        state.PauseTiming();
+        host->destroyEnvironment(env);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK_CAPTURE(BM_EvaluateFile, source, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EvaluateFile, bytecode, true)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <fcntl.h>
+
+#include <array>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <folly/FileUtil.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+#include <higs/jsrt/FileEngine.hpp>
+#include "BenchmarkCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+constexpr size_t kFileSize = 64 << 20;
+constexpr size_t kRandomReadSize = 4 << 10;
+constexpr size_t kRandomReadBatch = 64;
+
+/**
+ * File read by the benchmarks. Reads are served from the page cache after the first iteration, so these
+ * measure submission overhead rather than the device.
+ */
+auto benchmarkFile() -> const std::string&
+{
+    static const std::string path = [] {
+        auto path = bench::temporaryPath("higs-bench-file-engine.bin");
+        std::string contents(kFileSize, '\0');
+        std::mt19937 random { 42 };
+        for (auto& c : contents) {
+            c = static_cast<char>(random());
+        }
+        folly::writeFile(contents, path.c_str());
+        return path;
+    }();
+
+    return path;
+}
+
+/**
+ * Engine selected by benchmark argument, 0 for thread pool and 1 for io_uring.
+ */
+class EngineFixture {
+public:
+    explicit EngineFixture(benchmark::State& state)
+    {
+        if (state.range(0) == 0) {
+            _engine = createThreadPoolFileEngine(folly::getKeepAliveToken(_executor));
+        }
+        else {
+            _engine = createIoUringFileEngine(256);
+        }
+    }
+
+    auto engine() const noexcept -> FileEngine*
+    {
+        return _engine.get();
+    }
+
+private:
+    folly::IOThreadPoolExecutor _executor { 2 };
+    std::unique_ptr<FileEngine> _engine;
+};
+
+}
+
+static void BM_FileEngineSequential(benchmark::State& state)
+{
+    EngineFixture fixture { state };
+    if (fixture.engine() == nullptr) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+
+    const auto& path = benchmarkFile();
+    for (auto _ : state) {
+        auto buffer = fixture.engine()->readFile(path).get();
+        benchmark::DoNotOptimize(buffer->data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kFileSize));
+}
+BENCHMARK(BM_FileEngineSequential)->ArgName("io_uring")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_FileEngineRandom(benchmark::State& state)
+{
+    EngineFixture fixture { state };
+    if (fixture.engine() == nullptr) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+
+    auto fd = folly::openNoInt(benchmarkFile().c_str(), O_RDONLY | O_CLOEXEC);
+    std::vector<uint8_t> memory(kRandomReadSize * kRandomReadBatch);
+    auto registered = state.range(1) != 0;
+    if (registered) {
+        std::array<std::span<uint8_t>, 1> buffers { memory };
+        if (!fixture.engine()->registerBuffers(buffers)) {
+            state.SkipWithError("engine does not register buffers");
+            folly::closeNoInt(fd);
+            return;
+        }
+    }
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<uint64_t> block { 0, kFileSize / kRandomReadSize - 1 };
+
+    std::vector<FileReadRequest> requests(kRandomReadBatch);
+    for (auto _ : state) {
+        for (size_t i = 0; i < kRandomReadBatch; ++i) {
+            requests[i] = {
+                .fd = fd,
+                .buffer = std::span(memory).subspan(i * kRandomReadSize, kRandomReadSize),
+                .offset = block(random) * kRandomReadSize,
+                .registeredBuffer = registered ? 0 : -1,
+            };
+        }
+        auto results = folly::collectAll(fixture.engine()->read(requests)).get();
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kRandomReadBatch));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kRandomReadBatch * kRandomReadSize));
+
+    folly::closeNoInt(fd);
+}
+BENCHMARK(BM_FileEngineRandom)->ArgNames({ "io_uring", "registered" })->Args({ 0, 0 })->Args({ 1, 0 })->Args({ 1, 1 });
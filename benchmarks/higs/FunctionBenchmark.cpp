@@ -0,0 +1,39 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <array>
+#include <cstddef>
+#include <functional>
+
+#include <benchmark/benchmark.h>
+#include <folly/Function.h>
+#include <jsrt/jsrt.hpp>
+#include "AllocationCounter.hpp"
+
+using namespace higs;
+
+/**
+ * Creates, moves and calls a task capturing `Size` bytes, the way a scheduled task is handed to an agent.
+ */
+template<typename Function, size_t Size>
+static void BM_TaskFunction(benchmark::State& state)
+{
+    std::array<std::byte, Size> payload {};
+    auto allocationsBefore = bench::allocationCount();
+
+    for (auto _ : state) {
+        Function func = [payload] { benchmark::DoNotOptimize(payload); };
+        auto scheduled = std::move(func);
+        scheduled();
+    }
+    state.counters["allocs_per_task"] = static_cast<double>(bench::allocationCount() - allocationsBefore)
+        / static_cast<double>(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_TaskFunction, std::function<void()>, 16);
+BENCHMARK_TEMPLATE(BM_TaskFunction, std::function<void()>, 64);
+BENCHMARK_TEMPLATE(BM_TaskFunction, folly::Function<void()>, 16);
+BENCHMARK_TEMPLATE(BM_TaskFunction, folly::Function<void()>, 64);
+BENCHMARK_TEMPLATE(BM_TaskFunction, jsrt::UniqueFunction<void()>, 16);
+BENCHMARK_TEMPLATE(BM_TaskFunction, jsrt::UniqueFunction<void()>, 64);
+BENCHMARK_TEMPLATE(BM_TaskFunction, jsrt::AgentTask, 64);
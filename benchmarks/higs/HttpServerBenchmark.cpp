@@ -0,0 +1,112 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <folly/coro/BlockingWait.h>
+#include <higs/http/HttpServer.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+constexpr size_t kClients = 8;
+constexpr size_t kRequestsPerClient = 2000;
+
+constexpr std::string_view kRequest = "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+constexpr std::string_view kResponse = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\nok";
+
+auto connectTo(const folly::SocketAddress& server) -> int
+{
+    auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_storage address {};
+    auto length = server.getAddress(&address);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), length) != 0) {
+        throw std::runtime_error("Cannot connect to benchmarked server");
+    }
+    int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return fd;
+}
+
+/**
+ * Sends requests in batches of `depth` pipelined ones, and waits for all responses of a batch before the next.
+ */
+void runClient(int fd, size_t depth)
+{
+    std::string batch;
+    for (size_t i = 0; i < depth; ++i) {
+        batch += kRequest;
+    }
+
+    std::vector<char> buffer(kResponse.size() * depth);
+    for (size_t sent = 0; sent < kRequestsPerClient; sent += depth) {
+        ::send(fd, batch.data(), batch.size(), 0);
+        for (size_t received = 0; received < buffer.size();) {
+            auto n = ::recv(fd, buffer.data() + received, buffer.size() - received, 0);
+            if (n <= 0) {
+                throw std::runtime_error("Benchmarked server closed connection");
+            }
+            received += n;
+        }
+    }
+}
+
+}
+
+/**
+ * Requests per second served over loopback by a pool of `range(0)` environments, with `range(1)` requests
+ * pipelined on each of the client connections.
+ */
+static void BM_HttpServerRequests(benchmark::State& state)
+{
+    auto envCount = static_cast<size_t>(state.range(0));
+    auto depth = static_cast<size_t>(state.range(1));
+
+    auto host = Runtime::create();
+    auto pool = EnvironmentPool::create(*host, envCount, EnvironmentOptions());
+    for (size_t i = 0; i < pool->size(); ++i) {
+        folly::coro::blockingWait(pool->environment(i).evaluateAsync("globalThis.handleRequest = () => 'ok';"));
+    }
+
+    http::HttpServer server { *host, *pool, {} };
+    server.listen(folly::SocketAddress("127.0.0.1", 0));
+
+    std::vector<int> connections;
+    for (size_t i = 0; i < kClients; ++i) {
+        connections.push_back(connectTo(server.address()));
+    }
+
+    for (auto _ : state) {
+        std::vector<std::thread> clients;
+        for (auto fd : connections) {
+            clients.emplace_back(runClient, fd, depth);
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kClients * kRequestsPerClient));
+
+    for (auto fd : connections) {
+        ::close(fd);
+    }
+    server.stop();
+}
+BENCHMARK(BM_HttpServerRequests)
+    ->Args({ 1, 1 })
+    ->Args({ 4, 1 })
+    ->Args({ 4, 16 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,71 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <benchmark/benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+struct SharedTarget : RefCounted<SharedTarget> {
+    int64_t calls = 0;
+};
+
+struct ConfinedTarget : RefCounted<ConfinedTarget, ThreadSafetyOption::disable> {
+    int64_t calls = 0;
+};
+
+}
+
+template<typename Target>
+static void BM_RetainRelease(benchmark::State& state)
+{
+    auto target = Target::create();
+    for (auto _ : state) {
+        auto copy = target;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK_TEMPLATE(BM_RetainRelease, SharedTarget);
+BENCHMARK_TEMPLATE(BM_RetainRelease, ConfinedTarget);
+
+/**
+ * Dispatches tasks from the agent's own thread, each holding a reference to the target, the way
+ * `Environment::run*` keeps environment alive while a task is pending.
+ */
+template<typename Target>
+static void BM_DispatchWithRef(benchmark::State& state)
+{
+    auto host = Runtime::create();
+    auto& agent = host->createEnvironment("bench").agent();
+    const auto tasks = state.range(0);
+
+    typename Target::Ptr target;
+    agent.runNowBlocking([&] {
+        target = Target::create();
+    });
+
+    for (auto _ : state) {
+        folly::Baton<> done;
+        agent.runNowBlocking([&] {
+            for (int64_t i = 0; i < tasks; ++i) {
+                agent.runLater([&, ref = target] {
+                    if (++ref->calls % tasks == 0) {
+                        done.post();
+                    }
+                });
+            }
+        });
+        done.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+
+    agent.runNowBlocking([&] {
+        target.reset();
+    });
+}
+BENCHMARK_TEMPLATE(BM_DispatchWithRef, SharedTarget)->Arg(10000)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_DispatchWithRef, ConfinedTarget)->Arg(10000)->UseRealTime();
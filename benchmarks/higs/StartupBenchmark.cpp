@@ -0,0 +1,74 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <higs/runtime.hpp>
+#include "BenchmarkCommon.hpp"
+
+using namespace higs;
+using bench::bundleSource;
+
+namespace {
+
+auto snapshotPath() -> std::string
+{
+    return bench::temporaryPath("higs-bench-startup.snapshot");
+}
+
+void runStartup(benchmark::State& state, const std::function<Environment&(Runtime&)>& createEnvironment)
+{
+    auto host = Runtime::create();
+    for (auto _ : state) {
+        auto& env = createEnvironment(*host);
+        state.PauseTiming();
+        host->destroyEnvironment(env);
+        state.ResumeTiming();
+    }
+}
+
+}
+
+static void BM_StartupFresh(benchmark::State& state)
+{
+    runStartup(state, [](Runtime& host) -> Environment& {
+        auto& env = host.createEnvironment("bench");
+        env.runNowBlocking([](jsrt::Environment& env) { env.evaluateScript(bundleSource(), "bundle.js"); });
+        return env;
+    });
+}
+BENCHMARK(BM_StartupFresh)->Unit(benchmark::kMillisecond);
+
+static void BM_StartupFromSnapshot(benchmark::State& state)
+{
+    EnvironmentSnapshot::Builder().addScript("bundle.js", bundleSource()).build()->writeToFile(snapshotPath());
+    auto snapshot = EnvironmentSnapshot::readFromFile(snapshotPath());
+
+    runStartup(state, [&snapshot](Runtime& host) -> Environment& {
+        return host.createEnvironment("bench", host.options().defaultEnvironmentOptions(), *snapshot);
+    });
+}
+BENCHMARK(BM_StartupFromSnapshot)->Unit(benchmark::kMillisecond);
+
+/**
+ * Startup from snapshot holding the bundle as a lazy global, which is read when `touched` is set.
+ *
+ * Touching it makes the work equal to eager startup, so that the difference is the overhead of the accessor.
+ * Untouched, it shows the saving for environments that never use the bundle.
+ */
+static void BM_StartupFromSnapshotLazy(benchmark::State& state)
+{
+    auto touched = state.range(0) != 0;
+    auto initializer = fmt::format("(function () {{\n{}\nreturn true;\n}})()", bundleSource());
+    auto snapshot = EnvironmentSnapshot::Builder().addLazyGlobal("bundle", std::move(initializer)).build();
+
+    runStartup(state, [&snapshot, touched](Runtime& host) -> Environment& {
+        auto& env = host.createEnvironment("bench", host.options().defaultEnvironmentOptions(), *snapshot);
+        if (touched) {
+            env.runNowBlocking([](jsrt::Environment& env) { env.evaluateScript("bundle", "touch.js"); });
+        }
+        return env;
+    });
+}
+BENCHMARK(BM_StartupFromSnapshotLazy)->ArgName("touched")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond);
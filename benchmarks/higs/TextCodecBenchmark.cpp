@@ -0,0 +1,108 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+/**
+ * Defines about 1 MiB of mostly ASCII text, and pure JS UTF-8 codecs as commonly polyfilled.
+ */
+constexpr const char* kSetup = R"(
+    globalThis.text = Array.from({ length: 1 << 14 }, (_, i) => `line ${i}: zażółć gęślą jaźń 🚀\n`).join('');
+    globalThis.bytes = new TextEncoder().encode(text);
+
+    globalThis.jsEncode = (string) => {
+        const out = new Uint8Array(string.length * 3);
+        let n = 0;
+        for (let i = 0; i < string.length; ++i) {
+            let c = string.charCodeAt(i);
+            if (c >= 0xD800 && c <= 0xDBFF && i + 1 < string.length) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (string.charCodeAt(++i) - 0xDC00);
+            }
+            if (c < 0x80) {
+                out[n++] = c;
+            } else if (c < 0x800) {
+                out[n++] = 0xC0 | (c >> 6); out[n++] = 0x80 | (c & 63);
+            } else if (c < 0x10000) {
+                out[n++] = 0xE0 | (c >> 12); out[n++] = 0x80 | ((c >> 6) & 63); out[n++] = 0x80 | (c & 63);
+            } else {
+                out[n++] = 0xF0 | (c >> 18); out[n++] = 0x80 | ((c >> 12) & 63);
+                out[n++] = 0x80 | ((c >> 6) & 63); out[n++] = 0x80 | (c & 63);
+            }
+        }
+        return out.subarray(0, n);
+    };
+
+    globalThis.jsDecode = (bytes) => {
+        let out = '';
+        const units = [];
+        for (let i = 0; i < bytes.length;) {
+            const b = bytes[i++];
+            let c;
+            if (b < 0x80) c = b;
+            else if (b < 0xE0) c = ((b & 31) << 6) | (bytes[i++] & 63);
+            else if (b < 0xF0) c = ((b & 15) << 12) | ((bytes[i++] & 63) << 6) | (bytes[i++] & 63);
+            else c = ((b & 7) << 18) | ((bytes[i++] & 63) << 12) | ((bytes[i++] & 63) << 6) | (bytes[i++] & 63);
+            if (c >= 0x10000) {
+                c -= 0x10000;
+                units.push(0xD800 + (c >> 10), 0xDC00 + (c & 1023));
+            } else {
+                units.push(c);
+            }
+            if (units.length >= 4096) {
+                out += String.fromCharCode(...units);
+                units.length = 0;
+            }
+        }
+        return out + String.fromCharCode(...units);
+    };
+)";
+
+void runCodec(benchmark::State& state, const char* expression)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto& rt = env.jsVirtualMachine();
+
+    env.evaluateScript(kSetup, "setup.js");
+    auto codec = env.evaluateScript(std::string("(function () { return ") + expression + "; })").asObject(rt).asFunction(rt);
+    auto size = env.evaluateScript("bytes.length").asNumber();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(codec.call(rt));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+}
+
+static void BM_TextEncodeNative(benchmark::State& state)
+{
+    runCodec(state, "new TextEncoder().encode(text)");
+}
+BENCHMARK(BM_TextEncodeNative)->Unit(benchmark::kMicrosecond);
+
+static void BM_TextEncodeJS(benchmark::State& state)
+{
+    runCodec(state, "jsEncode(text)");
+}
+BENCHMARK(BM_TextEncodeJS)->Unit(benchmark::kMicrosecond);
+
+static void BM_TextDecodeNative(benchmark::State& state)
+{
+    runCodec(state, "new TextDecoder().decode(bytes)");
+}
+BENCHMARK(BM_TextDecodeNative)->Unit(benchmark::kMicrosecond);
+
+static void BM_TextDecodeJS(benchmark::State& state)
+{
+    runCodec(state, "jsDecode(bytes)");
+}
+BENCHMARK(BM_TextDecodeJS)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,19 @@
+# Finds linenoise-ng line editing library.
+#
+# linenoise-ng does not ship a CMake package config, this creates `LinenoiseNg::LinenoiseNg` imported target.
+
+find_path(LinenoiseNg_INCLUDE_DIR NAMES linenoise.h)
+find_library(LinenoiseNg_LIBRARY NAMES linenoise)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LinenoiseNg REQUIRED_VARS LinenoiseNg_LIBRARY LinenoiseNg_INCLUDE_DIR)
+
+if (LinenoiseNg_FOUND AND NOT TARGET LinenoiseNg::LinenoiseNg)
+    add_library(LinenoiseNg::LinenoiseNg UNKNOWN IMPORTED)
+    set_target_properties(LinenoiseNg::LinenoiseNg PROPERTIES
+        IMPORTED_LOCATION "${LinenoiseNg_LIBRARY}"
+        INTERFACE_INCLUDE_DIRECTORIES "${LinenoiseNg_INCLUDE_DIR}"
+    )
+endif ()
+
+mark_as_advanced(LinenoiseNg_INCLUDE_DIR LinenoiseNg_LIBRARY)
@@ -0,0 +1,139 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "ArrayBuffer.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include <folly/io/IOBuf.h>
+
+namespace higs::ext {
+
+namespace {
+
+/**
+ * Memory of an IOBuf, kept alive by the ArrayBuffer created over it.
+ */
+class IOBufBuffer final : public jsi::MutableBuffer {
+public:
+    explicit IOBufBuffer(std::unique_ptr<folly::IOBuf> buffer) noexcept : _buffer(std::move(buffer)) {}
+
+    [[nodiscard]]
+    auto size() const -> size_t override
+    {
+        return _buffer->length();
+    }
+
+    auto data() -> uint8_t* override
+    {
+        return _buffer->writableData();
+    }
+
+private:
+    std::unique_ptr<folly::IOBuf> _buffer;
+};
+
+/**
+ * Checks that view property `value` is a valid offset or length, which getters of a view may not return.
+ */
+auto isIndex(const jsi::Value& value) noexcept -> bool
+{
+    if (!value.isNumber()) {
+        return false;
+    }
+    auto number = value.getNumber();
+    return number >= 0 && number <= static_cast<double>(1ULL << 53) && std::trunc(number) == number;
+}
+
+}
+
+auto toArrayBuffer(jsi::Runtime& rt, std::shared_ptr<jsi::MutableBuffer> buffer) -> jsi::ArrayBuffer
+{
+    return { rt, std::move(buffer) };
+}
+
+auto toArrayBuffer(jsi::Runtime& rt, std::unique_ptr<folly::IOBuf> buffer) -> jsi::ArrayBuffer
+{
+    // JS may write into the ArrayBuffer, so memory shared with other IOBufs is copied
+    buffer->coalesce();
+    buffer->unshare();
+    return toArrayBuffer(rt, std::make_shared<IOBufBuffer>(std::move(buffer)));
+}
+
+auto toArrayBuffer(jsi::Runtime& rt, std::span<const uint8_t> bytes) -> jsi::ArrayBuffer
+{
+    auto buffer = NativeBuffer::allocate(bytes.size());
+    std::memcpy(buffer->data(), bytes.data(), bytes.size());
+    return toArrayBuffer(rt, std::move(buffer));
+}
+
+auto toIOBuf(std::vector<uint8_t> bytes) -> std::unique_ptr<folly::IOBuf>
+{
+    if (bytes.empty()) {
+        return folly::IOBuf::create(0);
+    }
+    auto* owner = new std::vector<uint8_t>(std::move(bytes));
+    return folly::IOBuf::takeOwnership(
+        owner->data(),
+        owner->size(),
+        [](void*, void* vector) { delete static_cast<std::vector<uint8_t>*>(vector); },
+        owner
+    );
+}
+
+auto BufferView::bytes(jsi::Runtime& rt) const -> std::span<uint8_t>
+{
+    auto size = buffer.size(rt);
+    if (offset > size || length > size - offset) {
+        throw jsi::JSError(rt, "View is outside the bounds of its ArrayBuffer");
+    }
+    return { buffer.data(rt) + offset, length };
+}
+
+auto viewOf(jsi::Runtime& rt, const jsi::Value& value) -> BufferView
+{
+    if (value.isObject()) {
+        auto object = value.getObject(rt);
+        if (object.isArrayBuffer(rt)) {
+            auto buffer = object.getArrayBuffer(rt);
+            auto size = buffer.size(rt);
+            return { .buffer = std::move(buffer), .offset = 0, .length = size };
+        }
+
+        // Typed arrays and DataView have no JSI API, they are recognized by their view properties
+        auto viewed = object.getProperty(rt, "buffer");
+        if (viewed.isObject() && viewed.getObject(rt).isArrayBuffer(rt)) {
+            auto offset = object.getProperty(rt, "byteOffset");
+            auto length = object.getProperty(rt, "byteLength");
+            if (isIndex(offset) && isIndex(length)) {
+                return {
+                    .buffer = viewed.getObject(rt).getArrayBuffer(rt),
+                    .offset = static_cast<size_t>(offset.getNumber()),
+                    .length = static_cast<size_t>(length.getNumber()),
+                };
+            }
+        }
+    }
+
+    throw jsi::JSError(rt, "Expected an ArrayBuffer, a typed array or a DataView");
+}
+
+auto bytesOf(jsi::Runtime& rt, const jsi::Value& value) -> std::span<uint8_t>
+{
+    return viewOf(rt, value).bytes(rt);
+}
+
+auto bytesOrUtf8Of(jsi::Runtime& rt, const jsi::Value& value, std::string& storage) -> std::span<const uint8_t>
+{
+    if (value.isString()) {
+        storage = value.getString(rt).utf8(rt);
+        return { reinterpret_cast<const uint8_t*>(storage.data()), storage.size() };
+    }
+
+    return bytesOf(rt, value);
+}
+
+}
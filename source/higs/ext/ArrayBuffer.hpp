@@ -0,0 +1,157 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <higs/common.hpp>
+#include <jsrt/jsrt.hpp>
+
+namespace folly {
+class IOBuf;
+}
+
+namespace higs::ext {
+
+/**
+ * Native memory that JS ArrayBuffers can be created over.
+ *
+ * Memory is filled natively (e.g. by a read on an I/O thread), and handed to JS without copying
+ * using `toArrayBuffer`. It is not initialized on allocation.
+ */
+class NativeBuffer final : public jsi::MutableBuffer {
+public:
+    explicit NativeBuffer(size_t size)
+        : _data(std::make_unique_for_overwrite<uint8_t[]>(size)), _size(size)
+    {
+    }
+
+    static auto allocate(size_t size) -> std::shared_ptr<NativeBuffer>
+    {
+        return std::make_shared<NativeBuffer>(size);
+    }
+
+    [[nodiscard]]
+    auto size() const -> size_t override
+    {
+        return _size;
+    }
+
+    auto data() -> uint8_t* override
+    {
+        return _data.get();
+    }
+
+    [[nodiscard]]
+    auto bytes() noexcept -> std::span<uint8_t>
+    {
+        return { _data.get(), _size };
+    }
+
+    /**
+     * Shrinks visible size, e.g. after a short read.
+     *
+     * Must be called before the buffer is handed to JS, as ArrayBuffer size cannot change afterward.
+     */
+    void truncate(size_t size) noexcept
+    {
+        assert(size <= _size);
+        _size = size;
+    }
+
+private:
+    std::unique_ptr<uint8_t[]> _data;
+    size_t _size;
+};
+
+/**
+ * Creates JS ArrayBuffer over `buffer`, without copying.
+ */
+auto toArrayBuffer(jsi::Runtime& rt, std::shared_ptr<jsi::MutableBuffer> buffer) -> jsi::ArrayBuffer;
+
+/**
+ * Creates JS ArrayBuffer holding a copy of `bytes`.
+ */
+auto toArrayBuffer(jsi::Runtime& rt, std::span<const uint8_t> bytes) -> jsi::ArrayBuffer;
+
+/**
+ * Creates JS ArrayBuffer over memory of `buffer` (e.g. received from a socket), without copying.
+ *
+ * Chained or shared buffers are copied into one owned buffer first.
+ */
+auto toArrayBuffer(jsi::Runtime& rt, std::unique_ptr<folly::IOBuf> buffer) -> jsi::ArrayBuffer;
+
+/**
+ * Converts native buffer to JS ArrayBuffer, e.g. when a `folly::SemiFuture` of it completes.
+ */
+inline auto toJS(std::shared_ptr<NativeBuffer> buffer, jsrt::Environment& env) -> jsi::Value
+{
+    return toArrayBuffer(env, std::move(buffer));
+}
+
+/**
+ * Range of an ArrayBuffer viewed by a value, e.g. by a typed array.
+ *
+ * Reading the view properties runs JS (which may detach buffers), so views of several values are all read
+ * before getting their bytes.
+ */
+struct BufferView {
+    jsi::ArrayBuffer buffer;
+    size_t offset;
+    size_t length;
+
+    /**
+     * Gets viewed bytes, which are only valid until JS runs again.
+     *
+     * @throws jsi::JSError When the buffer does not hold the range, e.g. when it was detached since
+     */
+    auto bytes(jsi::Runtime& rt) const -> std::span<uint8_t>;
+};
+
+/**
+ * Gets range viewed by `value`, which is an ArrayBuffer, a typed array or a DataView.
+ *
+ * @throws jsi::JSError When `value` is not a binary value
+ */
+auto viewOf(jsi::Runtime& rt, const jsi::Value& value) -> BufferView;
+
+/**
+ * Gets bytes viewed by `value`, which is an ArrayBuffer, a typed array or a DataView.
+ *
+ * The span points into JS heap, and is only valid until JS runs again.
+ *
+ * @throws jsi::JSError When `value` is not a binary value
+ */
+auto bytesOf(jsi::Runtime& rt, const jsi::Value& value) -> std::span<uint8_t>;
+
+/**
+ * Same as `bytesOf`, but also accepts strings, viewed as their UTF-8 encoding.
+ *
+ * @param storage Receives UTF-8 encoding of a string, which the result points into
+ */
+auto bytesOrUtf8Of(jsi::Runtime& rt, const jsi::Value& value, std::string& storage) -> std::span<const uint8_t>;
+
+/**
+ * Copies `bytes` viewed in JS heap, for native code using them after JS runs again, e.g. off the JS thread.
+ *
+ * JS may write to the viewed ArrayBuffer meanwhile, and the GC frees it once JS no longer references it.
+ */
+inline auto copyBytes(std::span<const uint8_t> bytes) -> std::vector<uint8_t>
+{
+    return { bytes.begin(), bytes.end() };
+}
+
+/**
+ * Creates IOBuf owning `bytes`, without copying.
+ */
+auto toIOBuf(std::vector<uint8_t> bytes) -> std::unique_ptr<folly::IOBuf>;
+
+}
@@ -0,0 +1,351 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "ByteKernels.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+// Kernels for x86 are compiled using target attributes, so that the rest of the build needs no `-m` flags
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HIGS_BYTE_KERNELS_X86 1
+#include <immintrin.h>
+#define HIGS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HIGS_BYTE_KERNELS_X86 0
+#endif
+
+namespace higs::ext {
+
+namespace {
+
+constexpr char hexDigits[] = "0123456789abcdef";
+
+constexpr auto hexValues = [] {
+    std::array<int8_t, 256> values {};
+    values.fill(-1);
+    for (int c = 0; c < 10; ++c) {
+        values['0' + c] = static_cast<int8_t>(c);
+    }
+    for (int c = 0; c < 6; ++c) {
+        values['a' + c] = static_cast<int8_t>(10 + c);
+        values['A' + c] = static_cast<int8_t>(10 + c);
+    }
+    return values;
+}();
+
+//
+// ------------------------------------------------------------------------------------------------- Scalar
+//
+void hexEncodeScalar(const uint8_t* input, size_t size, char* output) noexcept
+{
+    for (size_t i = 0; i < size; ++i) {
+        output[2 * i] = hexDigits[input[i] >> 4];
+        output[2 * i + 1] = hexDigits[input[i] & 0xF];
+    }
+}
+
+auto hexDecodeScalar(const char* input, size_t size, uint8_t* output) noexcept -> bool
+{
+    if (size % 2 != 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < size / 2; ++i) {
+        auto high = hexValues[static_cast<uint8_t>(input[2 * i])];
+        auto low = hexValues[static_cast<uint8_t>(input[2 * i + 1])];
+        if ((high | low) < 0) {
+            return false;
+        }
+        output[i] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return true;
+}
+
+/**
+ * Finds candidates by the first byte using `memchr`, which libc vectorizes itself.
+ */
+auto findScalar(const uint8_t* haystack, size_t size, const uint8_t* needle, size_t needleSize) noexcept
+    -> const uint8_t*
+{
+    if (needleSize == 0) {
+        return haystack;
+    }
+    if (needleSize > size) {
+        return nullptr;
+    }
+
+    const auto* last = haystack + (size - needleSize);
+    for (const auto* position = haystack; position <= last; ++position) {
+        position = static_cast<const uint8_t*>(std::memchr(position, needle[0], static_cast<size_t>(last - position) + 1));
+        if (position == nullptr) {
+            return nullptr;
+        }
+        if (std::memcmp(position + 1, needle + 1, needleSize - 1) == 0) {
+            return position;
+        }
+    }
+    return nullptr;
+}
+
+constexpr ByteKernels scalarKernels {
+    .instructionSet = InstructionSet::Scalar,
+    .hexEncode = &hexEncodeScalar,
+    .hexDecode = &hexDecodeScalar,
+    .find = &findScalar,
+};
+
+#if HIGS_BYTE_KERNELS_X86
+
+//
+// ------------------------------------------------------------------------------------------------- SSE 4.2
+//
+HIGS_TARGET("sse4.2")
+void hexEncodeSse42(const uint8_t* input, size_t size, char* output) noexcept
+{
+    const auto digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hexDigits));
+    const auto nibble = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        auto high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+        auto low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * i), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+    }
+    hexEncodeScalar(input + i, size - i, output + 2 * i);
+}
+
+/**
+ * Converts 16 hexadecimal digits to their values.
+ *
+ * @return Whether all characters are hexadecimal digits
+ */
+HIGS_TARGET("sse4.2")
+auto hexValuesSse42(__m128i chars, __m128i& values) noexcept -> bool
+{
+    auto digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    auto isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    auto letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    auto isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+
+    values = _mm_blendv_epi8(_mm_add_epi8(letters, _mm_set1_epi8(10)), digits, isDigit);
+    return _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
+}
+
+HIGS_TARGET("sse4.2")
+auto hexDecodeSse42(const char* input, size_t size, uint8_t* output) noexcept -> bool
+{
+    if (size % 2 != 0) {
+        return false;
+    }
+
+    // Multiplies high digit of each pair by 16, and adds low digit
+    const auto weights = _mm_set1_epi16(0x0110);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m128i first;
+        __m128i second;
+        auto valid = hexValuesSse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)), first);
+        valid &= hexValuesSse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 16)), second);
+        if (!valid) {
+            return false;
+        }
+
+        auto bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i / 2), bytes);
+    }
+    return hexDecodeScalar(input + i, size - i, output + i / 2);
+}
+
+/**
+ * Compares first and last byte of the needle at 16 positions at once, and only compares the rest at matches.
+ */
+HIGS_TARGET("sse4.2")
+auto findSse42(const uint8_t* haystack, size_t size, const uint8_t* needle, size_t needleSize) noexcept
+    -> const uint8_t*
+{
+    if (needleSize <= 1) {
+        return findScalar(haystack, size, needle, needleSize);
+    }
+
+    const auto first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const auto last = _mm_set1_epi8(static_cast<char>(needle[needleSize - 1]));
+
+    size_t i = 0;
+    for (; i + 16 + needleSize - 1 <= size; i += 16) {
+        auto firstMatches = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i)), first);
+        auto lastMatches = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleSize - 1)), last);
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(firstMatches, lastMatches)));
+        while (mask != 0) {
+            auto offset = static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(haystack + i + offset + 1, needle + 1, needleSize - 2) == 0) {
+                return haystack + i + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return findScalar(haystack + i, size - i, needle, needleSize);
+}
+
+constexpr ByteKernels sse42Kernels {
+    .instructionSet = InstructionSet::Sse42,
+    .hexEncode = &hexEncodeSse42,
+    .hexDecode = &hexDecodeSse42,
+    .find = &findSse42,
+};
+
+//
+// ------------------------------------------------------------------------------------------------- AVX2
+//
+HIGS_TARGET("avx2")
+void hexEncodeAvx2(const uint8_t* input, size_t size, char* output) noexcept
+{
+    const auto digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hexDigits)));
+    const auto nibble = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        auto high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+        auto low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibble));
+
+        // Unpacking interleaves within 128-bit lanes, lanes are put back in order when storing
+        auto lower = _mm256_unpacklo_epi8(high, low);
+        auto upper = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 2 * i), _mm256_permute2x128_si256(lower, upper, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 2 * i + 32), _mm256_permute2x128_si256(lower, upper, 0x31));
+    }
+    hexEncodeScalar(input + i, size - i, output + 2 * i);
+}
+
+HIGS_TARGET("avx2")
+auto hexValuesAvx2(__m256i chars, __m256i& values) noexcept -> bool
+{
+    auto digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    auto isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    auto letters = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    auto isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+
+    values = _mm256_blendv_epi8(_mm256_add_epi8(letters, _mm256_set1_epi8(10)), digits, isDigit);
+    return _mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) == -1;
+}
+
+HIGS_TARGET("avx2")
+auto hexDecodeAvx2(const char* input, size_t size, uint8_t* output) noexcept -> bool
+{
+    if (size % 2 != 0) {
+        return false;
+    }
+
+    const auto weights = _mm256_set1_epi16(0x0110);
+
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m256i first;
+        __m256i second;
+        auto valid = hexValuesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i)), first);
+        valid &= hexValuesAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 32)), second);
+        if (!valid) {
+            return false;
+        }
+
+        // Packing works within 128-bit lanes, quadwords are put back in order afterward
+        auto packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i / 2), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return hexDecodeSse42(input + i, size - i, output + i / 2);
+}
+
+HIGS_TARGET("avx2")
+auto findAvx2(const uint8_t* haystack, size_t size, const uint8_t* needle, size_t needleSize) noexcept
+    -> const uint8_t*
+{
+    if (needleSize <= 1) {
+        return findScalar(haystack, size, needle, needleSize);
+    }
+
+    const auto first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const auto last = _mm256_set1_epi8(static_cast<char>(needle[needleSize - 1]));
+
+    size_t i = 0;
+    for (; i + 32 + needleSize - 1 <= size; i += 32) {
+        auto firstMatches = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i)), first);
+        auto lastMatches = _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + needleSize - 1)),
+            last
+        );
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(firstMatches, lastMatches)));
+        while (mask != 0) {
+            auto offset = static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(haystack + i + offset + 1, needle + 1, needleSize - 2) == 0) {
+                return haystack + i + offset;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return findSse42(haystack + i, size - i, needle, needleSize);
+}
+
+constexpr ByteKernels avx2Kernels {
+    .instructionSet = InstructionSet::Avx2,
+    .hexEncode = &hexEncodeAvx2,
+    .hexDecode = &hexDecodeAvx2,
+    .find = &findAvx2,
+};
+
+#endif
+
+}
+
+auto nameOf(InstructionSet set) noexcept -> std::string_view
+{
+    switch (set) {
+    case InstructionSet::Scalar:
+        return "scalar";
+    case InstructionSet::Sse42:
+        return "sse4.2";
+    case InstructionSet::Avx2:
+        return "avx2";
+    }
+    return "";
+}
+
+auto byteKernelsFor(InstructionSet set) noexcept -> const ByteKernels*
+{
+#if HIGS_BYTE_KERNELS_X86
+    __builtin_cpu_init();
+    switch (set) {
+    case InstructionSet::Scalar:
+        return &scalarKernels;
+    case InstructionSet::Sse42:
+        return __builtin_cpu_supports("sse4.2") ? &sse42Kernels : nullptr;
+    case InstructionSet::Avx2:
+        return __builtin_cpu_supports("avx2") ? &avx2Kernels : nullptr;
+    }
+    return nullptr;
+#else
+    return set == InstructionSet::Scalar ? &scalarKernels : nullptr;
+#endif
+}
+
+auto byteKernels() noexcept -> const ByteKernels&
+{
+    static const ByteKernels& kernels = []() -> const ByteKernels& {
+        for (auto set : { InstructionSet::Avx2, InstructionSet::Sse42 }) {
+            if (const auto* candidate = byteKernelsFor(set)) {
+                return *candidate;
+            }
+        }
+        return scalarKernels;
+    }();
+
+    return kernels;
+}
+
+}
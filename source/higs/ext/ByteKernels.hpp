@@ -0,0 +1,70 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace higs::ext {
+
+/**
+ * Instruction sets byte kernels are implemented for.
+ */
+enum class InstructionSet {
+    Scalar,
+
+    /**
+     * SSE up to 4.2 (including SSSE3 shuffles and SSE4.1 blends).
+     */
+    Sse42,
+    Avx2,
+};
+
+auto nameOf(InstructionSet set) noexcept -> std::string_view;
+
+/**
+ * Byte processing kernels implemented for one instruction set.
+ *
+ * Kernels are plain function pointers, so that the best implementation is selected once by `byteKernels`,
+ * instead of at every call.
+ */
+struct ByteKernels {
+    InstructionSet instructionSet;
+
+    /**
+     * Writes `2 * size` lowercase hexadecimal digits of `input` to `output`.
+     */
+    void (*hexEncode)(const uint8_t* input, size_t size, char* output) noexcept;
+
+    /**
+     * Decodes `size` hexadecimal digits (of either case) of `input` into `size / 2` bytes of `output`.
+     *
+     * @return Whether `size` is even and all characters are hexadecimal digits, `output` is unspecified if not
+     */
+    bool (*hexDecode)(const char* input, size_t size, uint8_t* output) noexcept;
+
+    /**
+     * Finds first occurrence of `needle` in `haystack`.
+     *
+     * @return Pointer to the occurrence, or `nullptr` when there is none
+     */
+    const uint8_t* (*find)(const uint8_t* haystack, size_t size, const uint8_t* needle, size_t needleSize) noexcept;
+};
+
+/**
+ * Gets kernels of the best instruction set supported by the CPU, detected on first call.
+ */
+auto byteKernels() noexcept -> const ByteKernels&;
+
+/**
+ * Gets kernels of `set`, e.g. to compare implementations.
+ *
+ * @return Kernels, or `nullptr` when `set` is supported by neither the build nor the CPU
+ */
+auto byteKernelsFor(InstructionSet set) noexcept -> const ByteKernels*;
+
+}
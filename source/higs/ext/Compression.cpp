@@ -0,0 +1,371 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <folly/Range.h>
+#include <folly/futures/Future.h>
+#include <zstd.h>
+
+namespace higs::ext {
+
+namespace {
+
+using folly::compression::CodecType;
+using folly::compression::StreamCodec;
+using FlushOp = StreamCodec::FlushOp;
+
+constexpr size_t kMinimumCapacity = 4 << 10;
+
+/**
+ * Largest output allocated up front based on sizes recorded in compressed data, which is not trusted.
+ * Larger outputs grow as they are produced.
+ */
+constexpr size_t kMaximumSizeHint = 256 << 20;
+
+struct FormatInfo {
+    CompressionFormat format;
+    std::string_view name;
+    CodecType codecType;
+};
+
+/**
+ * Formats in order of `CompressionFormat`.
+ */
+constexpr std::array formats {
+    FormatInfo { CompressionFormat::Gzip, "gzip", CodecType::GZIP },
+    FormatInfo { CompressionFormat::Deflate, "deflate", CodecType::ZLIB },
+    FormatInfo { CompressionFormat::Zstd, "zstd", CodecType::ZSTD },
+};
+
+auto infoOf(CompressionFormat format) noexcept -> const FormatInfo&
+{
+    return formats[static_cast<size_t>(format)];
+}
+
+auto createCodec(CompressionFormat format, std::optional<int> level) -> std::unique_ptr<StreamCodec>
+{
+    return folly::compression::getStreamCodec(
+        infoOf(format).codecType,
+        level.value_or(folly::compression::COMPRESSION_LEVEL_DEFAULT)
+    );
+}
+
+/**
+ * Native buffer output is written into, which grows when full.
+ *
+ * Output produced into a well estimated capacity is handed to JS without copying.
+ */
+class OutputBuffer {
+public:
+    explicit OutputBuffer(size_t capacity) : _buffer(NativeBuffer::allocate(std::max(capacity, kMinimumCapacity))) {}
+
+    /**
+     * Gets free space, doubling capacity when there is none.
+     */
+    auto available() -> folly::MutableByteRange
+    {
+        if (_size == _buffer->size()) {
+            auto grown = NativeBuffer::allocate(_buffer->size() * 2);
+            std::memcpy(grown->data(), _buffer->data(), _size);
+            _buffer = std::move(grown);
+        }
+        return { _buffer->data() + _size, _buffer->size() - _size };
+    }
+
+    void commit(size_t size) noexcept
+    {
+        _size += size;
+    }
+
+    auto take() noexcept -> std::shared_ptr<NativeBuffer>
+    {
+        _buffer->truncate(_size);
+        return std::move(_buffer);
+    }
+
+private:
+    std::shared_ptr<NativeBuffer> _buffer;
+    size_t _size = 0;
+};
+
+/**
+ * Feeds all of `input` to compressing `codec`, appending produced output.
+ */
+void compressInto(StreamCodec& codec, folly::ByteRange input, FlushOp flush, OutputBuffer& output)
+{
+    while (true) {
+        auto space = output.available();
+        auto capacity = space.size();
+        auto done = codec.compressStream(input, space, flush);
+        output.commit(capacity - space.size());
+
+        // Without flushing, the codec is done when it takes all input, and reports no completion
+        if (flush == FlushOp::NONE ? input.empty() : done) {
+            return;
+        }
+    }
+}
+
+/**
+ * Feeds all of `input` to decompressing `codec`, appending produced output.
+ *
+ * Frames (or gzip members) following the end of one are decompressed too.
+ *
+ * @param end Whether `input` is the last, so that it must end at the end of a frame
+ * @return Whether input ended at the end of a frame
+ */
+auto decompressInto(StreamCodec& codec, folly::ByteRange input, bool end, OutputBuffer& output) -> bool
+{
+    while (true) {
+        auto space = output.available();
+        auto capacity = space.size();
+        auto ended = codec.uncompressStream(input, space);
+        output.commit(capacity - space.size());
+
+        if (ended) {
+            if (input.empty()) {
+                return true;
+            }
+            codec.resetStream();
+            continue;
+        }
+
+        // Output has room left, so the codec waits for more input
+        if (input.empty() && !space.empty()) {
+            if (end) {
+                throw std::runtime_error("Compressed data is truncated");
+            }
+            return false;
+        }
+    }
+}
+
+auto decompressedSizeHint(CompressionFormat format, std::span<const uint8_t> input) noexcept -> size_t
+{
+    size_t hint = input.size() * 4;
+    if (format == CompressionFormat::Zstd) {
+        auto contentSize = ZSTD_getFrameContentSize(input.data(), input.size());
+        if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR) {
+            // Exact for a single frame, multiple frames grow the output
+            hint = static_cast<size_t>(std::min<uint64_t>(contentSize, kMaximumSizeHint)) + 1;
+        }
+    } else if (format == CompressionFormat::Gzip && input.size() >= 18) {
+        // Trailer of the last member records its size modulo 2^32, little endian
+        const auto* trailer = input.data() + input.size() - 4;
+        uint32_t size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<uint32_t>(trailer[3]) << 24);
+        hint = static_cast<size_t>(size) + 1;
+    }
+    return std::min(hint, kMaximumSizeHint);
+}
+
+void checkZstd(size_t result)
+{
+    if (ZSTD_isError(result) != 0U) {
+        throw std::runtime_error(fmt::format("zstd: {}", ZSTD_getErrorName(result)));
+    }
+}
+
+}
+
+//
+// ------------------------------------------------------------------------------------------------- One-shot
+//
+auto compress(CompressionFormat format, std::span<const uint8_t> input, std::optional<int> level)
+    -> std::shared_ptr<NativeBuffer>
+{
+    auto codec = createCodec(format, level);
+    // Known size lets zstd record it in the frame header, so that decompression allocates output once
+    codec->resetStream(input.size());
+
+    OutputBuffer output { static_cast<size_t>(codec->maxCompressedLength(input.size())) };
+    compressInto(*codec, { input.data(), input.size() }, FlushOp::END, output);
+    return output.take();
+}
+
+auto decompress(CompressionFormat format, std::span<const uint8_t> input) -> std::shared_ptr<NativeBuffer>
+{
+    auto codec = createCodec(format, std::nullopt);
+    codec->resetStream();
+
+    OutputBuffer output { decompressedSizeHint(format, input) };
+    decompressInto(*codec, { input.data(), input.size() }, true, output);
+    return output.take();
+}
+
+//
+// ------------------------------------------------------------------------------------------------- Blocks
+//
+auto compressBlocks(
+    std::shared_ptr<const std::vector<uint8_t>> input,
+    size_t blockSize,
+    std::optional<int> level,
+    folly::Executor::KeepAlive<> executor
+) -> folly::SemiFuture<std::shared_ptr<NativeBuffer>>
+{
+    if (blockSize < kMinBlockSize) {
+        throw std::invalid_argument(fmt::format("Block size {} is less than {} bytes", blockSize, kMinBlockSize));
+    }
+    auto blockCount = std::max<size_t>((input->size() + blockSize - 1) / blockSize, 1);
+    auto bound = ZSTD_compressBound(blockSize);
+    auto zstdLevel = level.value_or(ZSTD_CLEVEL_DEFAULT);
+
+    // Blocks are compressed into their own slots of a shared buffer, and compacted once all are done
+    auto output = NativeBuffer::allocate(blockCount * bound);
+    std::vector<folly::SemiFuture<size_t>> blocks;
+    blocks.reserve(blockCount);
+    for (size_t i = 0; i < blockCount; ++i) {
+        blocks.push_back(folly::via(executor, [input, output, i, blockSize, bound, zstdLevel] {
+            auto offset = i * blockSize;
+            auto size = std::min(blockSize, input->size() - offset);
+            auto written = ZSTD_compress(output->data() + i * bound, bound, input->data() + offset, size, zstdLevel);
+            checkZstd(written);
+            return written;
+        }).semi());
+    }
+
+    return folly::collect(std::move(blocks)).deferValue([output, bound](std::vector<size_t> sizes) {
+        size_t size = 0;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            std::memmove(output->data() + size, output->data() + i * bound, sizes[i]);
+            size += sizes[i];
+        }
+        output->truncate(size);
+        return output;
+    });
+}
+
+auto decompressBlocks(std::shared_ptr<const std::vector<uint8_t>> input, folly::Executor::KeepAlive<> executor)
+    -> folly::SemiFuture<std::shared_ptr<NativeBuffer>>
+{
+    struct Frame {
+        size_t offset;
+        size_t size;
+        size_t contentOffset;
+        size_t contentSize;
+    };
+
+    // Header of each frame is read to find where it ends, and how much it decompresses to
+    std::vector<Frame> frames;
+    size_t total = 0;
+    bool sized = true;
+    for (size_t offset = 0; offset < input->size() && sized;) {
+        const auto* frame = input->data() + offset;
+        auto remaining = input->size() - offset;
+        auto size = ZSTD_findFrameCompressedSize(frame, remaining);
+        auto contentSize = ZSTD_getFrameContentSize(frame, remaining);
+        // Recorded sizes are not trusted: their total is capped, which also keeps it from overflowing, and
+        // larger outputs are decompressed sequentially, growing as they are produced
+        sized = ZSTD_isError(size) == 0U && contentSize != ZSTD_CONTENTSIZE_UNKNOWN
+            && contentSize != ZSTD_CONTENTSIZE_ERROR && contentSize <= kMaximumSizeHint - total;
+        if (sized) {
+            frames.push_back({ offset, size, total, static_cast<size_t>(contentSize) });
+            total += static_cast<size_t>(contentSize);
+            offset += size;
+        }
+    }
+
+    std::shared_ptr<NativeBuffer> output;
+    if (sized && frames.size() >= 2) {
+        output = NativeBuffer::allocate(total);
+    }
+    auto fits = [&](const Frame& frame) {
+        return frame.contentOffset <= output->size() && frame.contentSize <= output->size() - frame.contentOffset;
+    };
+    if (!output || !std::all_of(frames.begin(), frames.end(), fits)) {
+        return folly::via(executor, [input] { return decompress(CompressionFormat::Zstd, *input); }).semi();
+    }
+
+    std::vector<folly::SemiFuture<folly::Unit>> work;
+    work.reserve(frames.size());
+    for (const auto& frame : frames) {
+        work.push_back(folly::via(executor, [input, output, frame] {
+            auto written = ZSTD_decompress(
+                output->data() + frame.contentOffset,
+                frame.contentSize,
+                input->data() + frame.offset,
+                frame.size
+            );
+            checkZstd(written);
+            if (written != frame.contentSize) {
+                throw std::runtime_error("zstd: frame decompressed to size different from its header");
+            }
+        }).semi());
+    }
+
+    return folly::collect(std::move(work)).deferValue([output](std::vector<folly::Unit>&&) { return output; });
+}
+
+//
+// ------------------------------------------------------------------------------------------------- CompressionStream
+//
+CompressionStream::CompressionStream(CompressionFormat format, Mode mode, std::optional<int> level)
+    : _mode(mode), _codec(createCodec(format, level))
+{
+    _codec->resetStream();
+}
+
+CompressionStream::~CompressionStream() noexcept = default;
+
+auto CompressionStream::write(std::span<const uint8_t> input) -> std::shared_ptr<NativeBuffer>
+{
+    return run(input, false);
+}
+
+auto CompressionStream::finish(std::span<const uint8_t> input) -> std::shared_ptr<NativeBuffer>
+{
+    auto output = run(input, true);
+    _codec.reset();
+    return output;
+}
+
+auto CompressionStream::run(std::span<const uint8_t> input, bool end) -> std::shared_ptr<NativeBuffer>
+{
+    if (finished()) {
+        throw std::logic_error("Compression stream is already finished");
+    }
+
+    if (_mode == Mode::Compress) {
+        OutputBuffer output { input.size() / 2 };
+        compressInto(*_codec, { input.data(), input.size() }, end ? FlushOp::END : FlushOp::NONE, output);
+        return output.take();
+    }
+
+    OutputBuffer output { input.size() * 4 };
+    if (_frameEnded) {
+        if (input.empty()) {
+            return output.take();
+        }
+        _codec->resetStream();
+    }
+    _frameEnded = decompressInto(*_codec, { input.data(), input.size() }, end, output);
+    return output.take();
+}
+
+//
+// ------------------------------------------------------------------------------------------------- Formats
+//
+auto findCompressionFormat(std::string_view name) noexcept -> std::optional<CompressionFormat>
+{
+    for (const auto& format : formats) {
+        if (format.name == name) {
+            return format.format;
+        }
+    }
+    return std::nullopt;
+}
+
+auto nameOf(CompressionFormat format) noexcept -> std::string_view
+{
+    return infoOf(format).name;
+}
+
+}
@@ -0,0 +1,133 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/compression/Compression.h>
+#include <folly/futures/Future.h>
+#include <higs/common.hpp>
+#include <higs/ext/ArrayBuffer.hpp>
+
+namespace higs::ext {
+
+/**
+ * Compressed data formats, named as by the `CompressionStream` web API.
+ */
+enum class CompressionFormat {
+    Gzip,
+
+    /**
+     * Deflate with zlib header and checksum (RFC 1950).
+     */
+    Deflate,
+    Zstd,
+};
+
+auto findCompressionFormat(std::string_view name) noexcept -> std::optional<CompressionFormat>;
+
+auto nameOf(CompressionFormat format) noexcept -> std::string_view;
+
+/**
+ * Compresses `input` at once, at `level` or the format's default level.
+ */
+auto compress(CompressionFormat format, std::span<const uint8_t> input, std::optional<int> level = std::nullopt)
+    -> std::shared_ptr<NativeBuffer>;
+
+/**
+ * Decompresses all of `input`, which may consist of multiple zstd frames or gzip members.
+ *
+ * Output is allocated using the size recorded by the format (zstd frame header, gzip trailer) when there is one.
+ *
+ * @throws std::runtime_error When `input` is corrupted or truncated
+ */
+auto decompress(CompressionFormat format, std::span<const uint8_t> input) -> std::shared_ptr<NativeBuffer>;
+
+/**
+ * Smallest block size of `compressBlocks`, below which frame headers and scheduling outweigh the work per block.
+ */
+constexpr size_t kMinBlockSize = 4 << 10;
+
+/**
+ * Compresses `input` as independent zstd frames of `blockSize` bytes each, in parallel on `executor`.
+ *
+ * Result is a regular zstd stream that any decoder decompresses, and which `decompressBlocks` decompresses in
+ * parallel again. Ratio is slightly lower than of a single frame, as blocks share no history.
+ *
+ * @throws std::invalid_argument When `blockSize` is less than `kMinBlockSize`
+ */
+auto compressBlocks(
+    std::shared_ptr<const std::vector<uint8_t>> input,
+    size_t blockSize,
+    std::optional<int> level,
+    folly::Executor::KeepAlive<> executor
+) -> folly::SemiFuture<std::shared_ptr<NativeBuffer>>;
+
+/**
+ * Decompresses zstd `input` on `executor`, frames in parallel when there are several of known sizes.
+ *
+ * Frames are decompressed straight into their part of a single output buffer. Input of a single frame, or of
+ * frames not recording their size, is decompressed sequentially.
+ */
+auto decompressBlocks(std::shared_ptr<const std::vector<uint8_t>> input, folly::Executor::KeepAlive<> executor)
+    -> folly::SemiFuture<std::shared_ptr<NativeBuffer>>;
+
+/**
+ * Compresses or decompresses data incrementally, as it arrives.
+ *
+ * Each call returns output produced by it, which may be empty as compressors buffer their input.
+ */
+class CompressionStream final {
+public:
+    enum class Mode {
+        Compress,
+        Decompress,
+    };
+
+    CompressionStream(CompressionFormat format, Mode mode, std::optional<int> level = std::nullopt);
+    HIGS_MAKE_NON_COPYABLE(CompressionStream);
+    ~CompressionStream() noexcept;
+
+    [[nodiscard]]
+    auto finished() const noexcept -> bool
+    {
+        return _codec == nullptr;
+    }
+
+    /**
+     * Processes following part of input.
+     *
+     * @throws std::logic_error When the stream was already finished
+     */
+    auto write(std::span<const uint8_t> input) -> std::shared_ptr<NativeBuffer>;
+
+    /**
+     * Processes last part of input, and ends the stream.
+     *
+     * @throws std::runtime_error When decompressed input ends within a frame
+     * @throws std::logic_error When the stream was already finished
+     */
+    auto finish(std::span<const uint8_t> input = {}) -> std::shared_ptr<NativeBuffer>;
+
+private:
+    auto run(std::span<const uint8_t> input, bool end) -> std::shared_ptr<NativeBuffer>;
+
+    Mode _mode;
+    std::unique_ptr<folly::compression::StreamCodec> _codec;
+
+    /**
+     * Whether decompression reached the end of a frame, so that a following one must reset the codec.
+     */
+    bool _frameEnded = false;
+};
+
+}
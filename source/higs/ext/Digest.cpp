@@ -0,0 +1,217 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Digest.hpp"
+
+#include <array>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <variant>
+
+#include <folly/hash/Checksum.h>
+#include <folly/lang/Bits.h>
+#include <folly/ssl/OpenSSLHash.h>
+#include <xxhash.h>
+
+namespace higs::ext {
+
+namespace {
+
+struct DigestInfo {
+    DigestAlgorithm algorithm;
+    std::string_view name;
+    size_t size;
+};
+
+/**
+ * Algorithms in order of `DigestAlgorithm`.
+ */
+constexpr std::array digests {
+    DigestInfo { DigestAlgorithm::Sha1, "sha1", 20 },
+    DigestInfo { DigestAlgorithm::Sha256, "sha256", 32 },
+    DigestInfo { DigestAlgorithm::Sha512, "sha512", 64 },
+    DigestInfo { DigestAlgorithm::Xxh64, "xxh64", 8 },
+    DigestInfo { DigestAlgorithm::Xxh3, "xxh3", 8 },
+    DigestInfo { DigestAlgorithm::Crc32c, "crc32c", 4 },
+};
+
+auto infoOf(DigestAlgorithm algorithm) noexcept -> const DigestInfo&
+{
+    return digests[static_cast<size_t>(algorithm)];
+}
+
+auto messageDigestOf(DigestAlgorithm algorithm) noexcept -> const EVP_MD*
+{
+    switch (algorithm) {
+    case DigestAlgorithm::Sha1:
+        return EVP_sha1();
+    case DigestAlgorithm::Sha256:
+        return EVP_sha256();
+    case DigestAlgorithm::Sha512:
+        return EVP_sha512();
+    default:
+        return nullptr;
+    }
+}
+
+struct Xxh64StateDeleter {
+    void operator()(XXH64_state_t* state) const noexcept
+    {
+        XXH64_freeState(state);
+    }
+};
+
+struct Xxh3StateDeleter {
+    void operator()(XXH3_state_t* state) const noexcept
+    {
+        XXH3_freeState(state);
+    }
+};
+
+using ShaState = folly::ssl::OpenSSLHash::Digest;
+using Xxh64State = std::unique_ptr<XXH64_state_t, Xxh64StateDeleter>;
+using Xxh3State = std::unique_ptr<XXH3_state_t, Xxh3StateDeleter>;
+
+/**
+ * CRC register, before final inversion.
+ */
+struct Crc32cState {
+    uint32_t crc = ~0U;
+};
+
+template<typename T>
+void storeBigEndian(T value, std::span<uint8_t> output) noexcept
+{
+    value = folly::Endian::big(value);
+    std::memcpy(output.data(), &value, sizeof(T));
+}
+
+}
+
+struct Digest::State {
+    std::variant<ShaState, Xxh64State, Xxh3State, Crc32cState> hasher;
+};
+
+//
+// ------------------------------------------------------------------------------------------------- Digest
+//
+Digest::Digest(DigestAlgorithm algorithm) : _algorithm(algorithm), _state(std::make_unique<State>())
+{
+    auto& hasher = _state->hasher;
+    switch (algorithm) {
+    case DigestAlgorithm::Sha1:
+    case DigestAlgorithm::Sha256:
+    case DigestAlgorithm::Sha512:
+        hasher.emplace<ShaState>().hash_init(messageDigestOf(algorithm));
+        break;
+    case DigestAlgorithm::Xxh64: {
+        auto& state = hasher.emplace<Xxh64State>(XXH64_createState());
+        if (state == nullptr || XXH64_reset(state.get(), 0) != XXH_OK) {
+            throw std::bad_alloc();
+        }
+        break;
+    }
+    case DigestAlgorithm::Xxh3: {
+        auto& state = hasher.emplace<Xxh3State>(XXH3_createState());
+        if (state == nullptr || XXH3_64bits_reset(state.get()) != XXH_OK) {
+            throw std::bad_alloc();
+        }
+        break;
+    }
+    case DigestAlgorithm::Crc32c:
+        hasher.emplace<Crc32cState>();
+        break;
+    }
+}
+
+Digest::~Digest() noexcept = default;
+
+auto Digest::compute(DigestAlgorithm algorithm, std::span<const uint8_t> data) -> std::shared_ptr<NativeBuffer>
+{
+    Digest digest { algorithm };
+    digest.update(data);
+    return digest.finish();
+}
+
+void Digest::update(std::span<const uint8_t> data)
+{
+    if (finished()) {
+        throw std::logic_error("Digest is already finished");
+    }
+
+    auto& hasher = _state->hasher;
+    if (auto* sha = std::get_if<ShaState>(&hasher)) {
+        sha->hash_update(folly::ByteRange(data.data(), data.size()));
+    } else if (auto* xxh64 = std::get_if<Xxh64State>(&hasher)) {
+        XXH64_update(xxh64->get(), data.data(), data.size());
+    } else if (auto* xxh3 = std::get_if<Xxh3State>(&hasher)) {
+        XXH3_64bits_update(xxh3->get(), data.data(), data.size());
+    } else if (auto* crc32c = std::get_if<Crc32cState>(&hasher)) {
+        crc32c->crc = folly::crc32c(data.data(), data.size(), crc32c->crc);
+    }
+}
+
+auto Digest::finish() -> std::shared_ptr<NativeBuffer>
+{
+    if (finished()) {
+        throw std::logic_error("Digest is already finished");
+    }
+
+    auto buffer = NativeBuffer::allocate(digestSizeOf(_algorithm));
+    auto output = buffer->bytes();
+    auto& hasher = _state->hasher;
+    if (auto* sha = std::get_if<ShaState>(&hasher)) {
+        sha->hash_final(folly::MutableByteRange(output.data(), output.size()));
+    } else if (auto* xxh64 = std::get_if<Xxh64State>(&hasher)) {
+        storeBigEndian<uint64_t>(XXH64_digest(xxh64->get()), output);
+    } else if (auto* xxh3 = std::get_if<Xxh3State>(&hasher)) {
+        storeBigEndian<uint64_t>(XXH3_64bits_digest(xxh3->get()), output);
+    } else if (auto* crc32c = std::get_if<Crc32cState>(&hasher)) {
+        storeBigEndian<uint32_t>(~crc32c->crc, output);
+    }
+
+    _state.reset();
+    return buffer;
+}
+
+//
+// ------------------------------------------------------------------------------------------------- Algorithms
+//
+auto findDigestAlgorithm(std::string_view name) noexcept -> std::optional<DigestAlgorithm>
+{
+    auto matches = [name](std::string_view candidate) {
+        size_t i = 0;
+        for (auto c : name) {
+            if (c == '-') {
+                continue;
+            }
+            auto lower = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            if (i == candidate.size() || candidate[i++] != lower) {
+                return false;
+            }
+        }
+        return i == candidate.size();
+    };
+
+    for (const auto& digest : digests) {
+        if (matches(digest.name)) {
+            return digest.algorithm;
+        }
+    }
+    return std::nullopt;
+}
+
+auto nameOf(DigestAlgorithm algorithm) noexcept -> std::string_view
+{
+    return infoOf(algorithm).name;
+}
+
+auto digestSizeOf(DigestAlgorithm algorithm) noexcept -> size_t
+{
+    return infoOf(algorithm).size;
+}
+
+}
@@ -0,0 +1,104 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include <higs/common.hpp>
+#include <higs/ext/ArrayBuffer.hpp>
+
+namespace higs::ext {
+
+enum class DigestAlgorithm {
+    Sha1,
+    Sha256,
+    Sha512,
+
+    /**
+     * 64-bit xxHash (XXH64), with seed 0.
+     */
+    Xxh64,
+
+    /**
+     * 64-bit XXH3, with seed 0.
+     */
+    Xxh3,
+
+    /**
+     * CRC-32C (Castagnoli), using SSE 4.2 or ARMv8 CRC instructions when available.
+     */
+    Crc32c,
+};
+
+/**
+ * Finds algorithm by name, e.g. `"sha256"`, ignoring case and dashes (so `"SHA-256"` matches too).
+ */
+auto findDigestAlgorithm(std::string_view name) noexcept -> std::optional<DigestAlgorithm>;
+
+auto nameOf(DigestAlgorithm algorithm) noexcept -> std::string_view;
+
+/**
+ * Gets size of digests of `algorithm` in bytes.
+ */
+auto digestSizeOf(DigestAlgorithm algorithm) noexcept -> size_t;
+
+/**
+ * Computes a digest incrementally.
+ *
+ * Digests are byte strings: SHA as specified, non-cryptographic hashes and checksums as big endian integers
+ * (which is the canonical form of xxHash).
+ *
+ * Instances are not thread safe, but may be used by one thread at a time, e.g. to hash on a background pool.
+ */
+class Digest final {
+public:
+    explicit Digest(DigestAlgorithm algorithm);
+    HIGS_MAKE_NON_COPYABLE(Digest);
+    ~Digest() noexcept;
+
+    /**
+     * Computes digest of `data` at once.
+     */
+    static auto compute(DigestAlgorithm algorithm, std::span<const uint8_t> data) -> std::shared_ptr<NativeBuffer>;
+
+    [[nodiscard]]
+    auto algorithm() const noexcept -> DigestAlgorithm
+    {
+        return _algorithm;
+    }
+
+    [[nodiscard]]
+    auto finished() const noexcept -> bool
+    {
+        return _state == nullptr;
+    }
+
+    /**
+     * Hashes following part of the input.
+     *
+     * @throws std::logic_error When the digest was already finished
+     */
+    void update(std::span<const uint8_t> data);
+
+    /**
+     * Finishes hashing, and gets the digest.
+     *
+     * @throws std::logic_error When the digest was already finished
+     */
+    auto finish() -> std::shared_ptr<NativeBuffer>;
+
+private:
+    struct State;
+
+    DigestAlgorithm _algorithm;
+    std::unique_ptr<State> _state;
+};
+
+}
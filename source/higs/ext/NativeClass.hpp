@@ -0,0 +1,378 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+#include <jsrt/conv.hpp>
+
+namespace higs::ext {
+
+/**
+ * Native state attached to JS objects wrapping instances of `T`.
+ *
+ * Owns a shared reference to the wrapped instance, which is released when the JS object is
+ * garbage collected (or the Environment is destroyed).
+ */
+template<typename T>
+class NativeInstance final : public jsi::NativeState {
+public:
+    explicit NativeInstance(std::shared_ptr<T> instance) noexcept : _instance(std::move(instance)) {}
+
+    [[nodiscard]]
+    auto instance() const noexcept -> const std::shared_ptr<T>&
+    {
+        return _instance;
+    }
+
+private:
+    std::shared_ptr<T> _instance;
+};
+
+/**
+ * Satisfied by types that own native memory not included in `sizeof(T)`.
+ *
+ * Such memory is reported to the GC alongside the object size, so that large native objects
+ * held by small JS wrappers trigger collection early enough.
+ */
+template<typename T>
+concept ReportsExternalMemorySize = requires(const T& value) {
+    { value.externalMemorySize() } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * Returns number of native bytes retained by `value`, as reported to the GC.
+ */
+template<typename T>
+auto nativeMemorySizeOf(const T& value) noexcept -> std::size_t
+{
+    if constexpr (ReportsExternalMemorySize<T>) {
+        return sizeof(T) + static_cast<std::size_t>(value.externalMemorySize());
+    }
+    else {
+        return sizeof(T);
+    }
+}
+
+/**
+ * Binds a C++ class `T` to JavaScript.
+ *
+ * Instances are exposed as plain JS objects carrying the C++ instance as `jsi::NativeState`,
+ * instead of `jsi::HostObject`s. Methods are defined once, on a prototype object shared by all
+ * instances within an Environment, so that method lookup goes through regular JS property lookup
+ * (and inline caches) rather than a virtual `HostObject::get` call for every property access.
+ *
+ * @code{.cpp}
+ * struct Counter {
+ *     auto increment(int32_t by) -> int32_t { return value += by; }
+ *     int32_t value = 0;
+ * };
+ *
+ * static const auto counterClass = higs::ext::NativeClass<Counter>("Counter")
+ *     .method<&Counter::increment>("increment")
+ *     .constructor([](auto&, auto, auto) { return std::make_shared<Counter>(); });
+ *
+ * env.globalObject().setProperty(env, "Counter", counterClass.constructorFunction(env));
+ * @endcode
+ *
+ * Prototypes are cached per Environment and keyed by `T`, so there should be a single binding
+ * of any given type.
+ *
+ * @tparam T Bound native type
+ */
+template<typename T>
+class NativeClass {
+public:
+    using MethodCallback = std::function<jsi::Value(T& self, Environment& env, const jsi::Value* args, size_t count)>;
+    using GetterCallback = std::function<jsi::Value(T& self, Environment& env)>;
+    using ConstructorCallback
+        = std::function<std::shared_ptr<T>(Environment& env, const jsi::Value* args, size_t count)>;
+
+    explicit NativeClass(std::string name) : _name(std::move(name)) {}
+
+    [[nodiscard]]
+    auto name() const noexcept -> const std::string&
+    {
+        return _name;
+    }
+
+    /**
+     * Defines method `name` on the prototype, calling `callback` with unwrapped `this`.
+     *
+     * @param name Name of the method
+     * @param callback Method implementation
+     * @param arity Value of `length` property of the JS function
+     * @return This class binding
+     */
+    auto method(std::string name, MethodCallback callback, unsigned arity = 0) -> NativeClass&
+    {
+        _methods.push_back({ std::move(name), std::move(callback), arity });
+        return *this;
+    }
+
+    /**
+     * Defines method `name` on the prototype, calling member function `Method`.
+     *
+     * Arguments and return value are converted using `jsrt::conv`.
+     *
+     * @tparam Method Pointer to member function of `T`
+     * @param name Name of the method
+     * @return This class binding
+     */
+    template<auto Method>
+    auto method(std::string name) -> NativeClass&
+    {
+        return bindMember<Method>(std::move(name), Method);
+    }
+
+    /**
+     * Defines read-only accessor property `name` on the prototype.
+     *
+     * @param name Name of the property
+     * @param callback Getter implementation
+     * @return This class binding
+     */
+    auto getter(std::string name, GetterCallback callback) -> NativeClass&
+    {
+        _getters.push_back({ std::move(name), std::move(callback) });
+        return *this;
+    }
+
+    /**
+     * Makes the class constructible from JS using `new`.
+     *
+     * @param callback Factory creating a native instance from constructor arguments
+     * @return This class binding
+     */
+    auto constructor(ConstructorCallback callback) -> NativeClass&
+    {
+        _constructor = std::move(callback);
+        return *this;
+    }
+
+    /**
+     * Gets prototype shared by all wrapped instances in `env`.
+     *
+     * The prototype is created on first use and cached by the Environment.
+     */
+    auto prototype(Environment& env) const -> const jsi::Object&
+    {
+        return env.objectForType(typeid(NativeInstance<T>), [this](Environment& env) { return createPrototype(env); });
+    }
+
+    /**
+     * Gets JS constructor function of this class in `env`.
+     *
+     * If no constructor was specified, the function throws when called, but can still be used
+     * for `instanceof` checks.
+     */
+    auto constructorFunction(Environment& env) const -> jsi::Function
+    {
+        const auto& ctor = env.objectForType(typeid(NativeClass<T>), [this](Environment& env) {
+            return createConstructor(env);
+        });
+        return ctor.asFunction(env);
+    }
+
+    /**
+     * Wraps native `instance` into a JS object.
+     *
+     * Size of the instance is reported to the GC as external memory pressure.
+     *
+     * @param env Environment to create object in
+     * @param instance Instance to wrap
+     * @return JS object
+     */
+    auto wrap(Environment& env, std::shared_ptr<T> instance) const -> jsi::Object
+    {
+        auto object = jsi::Object::create(env, jsi::Value(env, prototype(env)));
+        attach(env, object, std::move(instance));
+        return object;
+    }
+
+    /**
+     * Updates external memory pressure of `object`, e.g. after the wrapped instance grew.
+     */
+    static void updateMemoryPressure(Environment& env, const jsi::Object& object)
+    {
+        if (auto* instance = tryUnwrap(env, object)) {
+            object.setExternalMemoryPressure(env, nativeMemorySizeOf(*instance));
+        }
+    }
+
+    /**
+     * Gets native instance wrapped by `value`, or `nullptr` if it does not wrap `T`.
+     */
+    static auto tryUnwrap(Environment& env, const jsi::Value& value) -> T*
+    {
+        if (!value.isObject()) {
+            return nullptr;
+        }
+
+        return tryUnwrap(env, value.getObject(env));
+    }
+
+    static auto tryUnwrap(Environment& env, const jsi::Object& object) -> T*
+    {
+        if (!object.hasNativeState<NativeInstance<T>>(env)) {
+            return nullptr;
+        }
+
+        return object.getNativeState<NativeInstance<T>>(env)->instance().get();
+    }
+
+    /**
+     * Gets native instance wrapped by `value`, throwing `jsi::JSError` if it does not wrap `T`.
+     */
+    auto unwrap(Environment& env, const jsi::Value& value) const -> T&
+    {
+        auto* instance = tryUnwrap(env, value);
+        if (instance == nullptr) {
+            throw jsi::JSError(env, fmt::format("Expected an instance of {}", _name));
+        }
+
+        return *instance;
+    }
+
+private:
+    struct MethodEntry {
+        std::string name;
+        MethodCallback callback;
+        unsigned arity;
+    };
+
+    struct GetterEntry {
+        std::string name;
+        GetterCallback callback;
+    };
+
+    template<auto Method, typename R, typename... Args>
+    auto bindMember(std::string name, R (T::*)(Args...)) -> NativeClass&
+    {
+        return method(std::move(name), &invokeMember<Method, R, Args...>, sizeof...(Args));
+    }
+
+    template<auto Method, typename R, typename... Args>
+    auto bindMember(std::string name, R (T::*)(Args...) const) -> NativeClass&
+    {
+        return method(std::move(name), &invokeMember<Method, R, Args...>, sizeof...(Args));
+    }
+
+    template<auto Method, typename R, typename... Args>
+    static auto invokeMember(T& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value
+    {
+        return [&]<size_t... I>(std::index_sequence<I...>) -> jsi::Value {
+            static const jsi::Value undefined;
+            if constexpr (std::is_void_v<R>) {
+                (self.*Method)(jsrt::fromJS<std::decay_t<Args>>(I < count ? args[I] : undefined, env)...);
+                return jsi::Value::undefined();
+            }
+            else {
+                return jsrt::toJS((self.*Method)(jsrt::fromJS<std::decay_t<Args>>(I < count ? args[I] : undefined, env)...), env);
+            }
+        }(std::index_sequence_for<Args...> {});
+    }
+
+    void attach(Environment& env, const jsi::Object& object, std::shared_ptr<T> instance) const
+    {
+        auto size = nativeMemorySizeOf(*instance);
+        object.setNativeState(env, std::make_shared<NativeInstance<T>>(std::move(instance)));
+        object.setExternalMemoryPressure(env, size);
+    }
+
+    auto createPrototype(Environment& env) const -> jsi::Object
+    {
+        jsi::Object proto { env };
+
+        for (const auto& entry : _methods) {
+            auto propName = jsi::PropNameID::forUtf8(env, entry.name);
+            auto func = jsi::Function::createFromHostFunction(
+                env,
+                propName,
+                entry.arity,
+                [&env, callback = entry.callback, className = _name](
+                    jsi::Runtime&, const jsi::Value& thisValue, const jsi::Value* args, size_t count
+                ) -> jsi::Value {
+                    auto* self = tryUnwrap(env, thisValue);
+                    if (self == nullptr) {
+                        throw jsi::JSError(env, fmt::format("Method called on incompatible receiver, expected {}", className));
+                    }
+
+                    return callback(*self, env, args, count);
+                }
+            );
+            proto.setProperty(env, propName, std::move(func));
+        }
+
+        if (!_getters.empty()) {
+            auto defineProperty = env.globalObject()
+                                      .getPropertyAsObject(env, "Object")
+                                      .getPropertyAsFunction(env, "defineProperty");
+
+            for (const auto& entry : _getters) {
+                auto getter = jsi::Function::createFromHostFunction(
+                    env,
+                    jsi::PropNameID::forUtf8(env, entry.name),
+                    0,
+                    [&env, callback = entry.callback, className = _name](
+                        jsi::Runtime&, const jsi::Value& thisValue, const jsi::Value*, size_t
+                    ) -> jsi::Value {
+                        auto* self = tryUnwrap(env, thisValue);
+                        if (self == nullptr) {
+                            throw jsi::JSError(env, fmt::format("Getter called on incompatible receiver, expected {}", className));
+                        }
+
+                        return callback(*self, env);
+                    }
+                );
+
+                jsi::Object descriptor { env };
+                descriptor.setProperty(env, "get", std::move(getter));
+                descriptor.setProperty(env, "configurable", true);
+                defineProperty.call(env, proto, jsi::String::createFromUtf8(env, entry.name), descriptor);
+            }
+        }
+
+        return proto;
+    }
+
+    auto createConstructor(Environment& env) const -> jsi::Object
+    {
+        auto ctor = jsi::Function::createFromHostFunction(
+            env,
+            jsi::PropNameID::forUtf8(env, _name),
+            0,
+            [&env, self = *this](jsi::Runtime&, const jsi::Value&, const jsi::Value* args, size_t count) -> jsi::Value {
+                if (!self._constructor) {
+                    throw jsi::JSError(env, fmt::format("{} is not constructible", self._name));
+                }
+
+                return self.wrap(env, self._constructor(env, args, count));
+            }
+        );
+
+        const auto& proto = prototype(env);
+        ctor.setProperty(env, "prototype", proto);
+        proto.setProperty(env, "constructor", ctor);
+
+        return ctor;
+    }
+
+    std::string _name;
+    std::vector<MethodEntry> _methods;
+    std::vector<GetterEntry> _getters;
+    ConstructorCallback _constructor;
+};
+
+}
@@ -0,0 +1,723 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "TextCodec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <memory>
+
+#include <fmt/format.h>
+#include <simdutf.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/NativeClass.hpp>
+#include <higs/modules/BuiltinModules.hpp>
+
+namespace higs::ext {
+
+// UTF-16 decoding copies bytes into code units as they are
+static_assert(std::endian::native == std::endian::little, "UTF-16 code units are expected to be little endian");
+
+namespace {
+
+using modules::argumentAt;
+using modules::throwError;
+
+constexpr char16_t kReplacementCharacter = 0xFFFD;
+constexpr char16_t kByteOrderMark = 0xFEFF;
+
+struct EncodingLabel {
+    std::string_view label;
+    TextEncoding encoding;
+};
+
+constexpr std::array encodingLabels {
+    EncodingLabel { "unicode-1-1-utf-8", TextEncoding::Utf8 },
+    EncodingLabel { "unicode11utf8", TextEncoding::Utf8 },
+    EncodingLabel { "unicode20utf8", TextEncoding::Utf8 },
+    EncodingLabel { "utf-8", TextEncoding::Utf8 },
+    EncodingLabel { "utf8", TextEncoding::Utf8 },
+    EncodingLabel { "x-unicode20utf8", TextEncoding::Utf8 },
+    EncodingLabel { "csunicode", TextEncoding::Utf16le },
+    EncodingLabel { "iso-10646-ucs-2", TextEncoding::Utf16le },
+    EncodingLabel { "ucs-2", TextEncoding::Utf16le },
+    EncodingLabel { "unicode", TextEncoding::Utf16le },
+    EncodingLabel { "unicodefeff", TextEncoding::Utf16le },
+    EncodingLabel { "utf-16", TextEncoding::Utf16le },
+    EncodingLabel { "utf-16le", TextEncoding::Utf16le },
+    EncodingLabel { "ansi_x3.4-1968", TextEncoding::Windows1252 },
+    EncodingLabel { "ascii", TextEncoding::Windows1252 },
+    EncodingLabel { "cp1252", TextEncoding::Windows1252 },
+    EncodingLabel { "cp819", TextEncoding::Windows1252 },
+    EncodingLabel { "csisolatin1", TextEncoding::Windows1252 },
+    EncodingLabel { "ibm819", TextEncoding::Windows1252 },
+    EncodingLabel { "iso-8859-1", TextEncoding::Windows1252 },
+    EncodingLabel { "iso-ir-100", TextEncoding::Windows1252 },
+    EncodingLabel { "iso8859-1", TextEncoding::Windows1252 },
+    EncodingLabel { "iso88591", TextEncoding::Windows1252 },
+    EncodingLabel { "iso_8859-1", TextEncoding::Windows1252 },
+    EncodingLabel { "iso_8859-1:1987", TextEncoding::Windows1252 },
+    EncodingLabel { "l1", TextEncoding::Windows1252 },
+    EncodingLabel { "latin1", TextEncoding::Windows1252 },
+    EncodingLabel { "us-ascii", TextEncoding::Windows1252 },
+    EncodingLabel { "windows-1252", TextEncoding::Windows1252 },
+    EncodingLabel { "x-cp1252", TextEncoding::Windows1252 },
+};
+
+/**
+ * Code points of bytes 0x80 to 0x9F in windows-1252, the only bytes it decodes differently from latin1.
+ */
+constexpr std::array<char16_t, 32> windows1252HighControls {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+auto isHighSurrogate(char16_t unit) noexcept -> bool
+{
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+auto isLowSurrogate(char16_t unit) noexcept -> bool
+{
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+auto combineSurrogates(char16_t high, char16_t low) noexcept -> char32_t
+{
+    return 0x10000 + ((static_cast<char32_t>(high) - 0xD800) << 10) + (static_cast<char32_t>(low) - 0xDC00);
+}
+
+void appendCodePoint(std::u16string& output, char32_t codePoint)
+{
+    if (codePoint < 0x10000) {
+        output.push_back(static_cast<char16_t>(codePoint));
+        return;
+    }
+
+    codePoint -= 0x10000;
+    output.push_back(static_cast<char16_t>(0xD800 + (codePoint >> 10)));
+    output.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+}
+
+/**
+ * Length of `bytes` without UTF-8 sequence left incomplete at its end.
+ */
+auto completeSequencesLength(std::span<const uint8_t> bytes) noexcept -> size_t
+{
+    auto size = bytes.size();
+    for (size_t back = 1; back <= std::min<size_t>(3, size); ++back) {
+        auto byte = bytes[size - back];
+        if ((byte & 0xC0) == 0x80) {
+            continue;
+        }
+
+        size_t length = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+        return length > back ? size - back : size;
+    }
+    return size;
+}
+
+/**
+ * Transcodes string contents reported by `jsi::String::getStringData` into UTF-8.
+ *
+ * Contents come in segments of latin1 or UTF-16 data. Without output, bytes are only counted. With output,
+ * whole segments fitting it are transcoded by simdutf, and the segment overflowing it code point by code point.
+ * High surrogate ending a segment is carried over to the next one, as it may start with the low surrogate.
+ */
+class Utf8Transcoder {
+public:
+    Utf8Transcoder() noexcept = default;
+    explicit Utf8Transcoder(std::span<uint8_t> output) noexcept : _output(output), _writing(true) {}
+
+    void operator()(bool latin1, const void* data, size_t count)
+    {
+        if (latin1) {
+            appendLatin1({ static_cast<const char*>(data), count });
+        }
+        else {
+            appendUtf16({ static_cast<const char16_t*>(data), count });
+        }
+    }
+
+    void finish()
+    {
+        flushCarry();
+    }
+
+    [[nodiscard]]
+    auto written() const noexcept -> size_t
+    {
+        return _size;
+    }
+
+    [[nodiscard]]
+    auto read() const noexcept -> size_t
+    {
+        return _read;
+    }
+
+private:
+    void appendLatin1(std::span<const char> chars)
+    {
+        flushCarry();
+        if (_full || chars.empty()) {
+            return;
+        }
+
+        auto length = simdutf::utf8_length_from_latin1(chars.data(), chars.size());
+        if (!_writing) {
+            _size += length;
+            _read += chars.size();
+            return;
+        }
+        if (fits(length)) {
+            _size += simdutf::convert_latin1_to_utf8(chars.data(), chars.size(), next());
+            _read += chars.size();
+            return;
+        }
+
+        for (auto c : chars) {
+            if (!appendCodePoint(static_cast<uint8_t>(c), 1)) {
+                return;
+            }
+        }
+    }
+
+    void appendUtf16(std::span<const char16_t> units)
+    {
+        if (_full) {
+            return;
+        }
+
+        if (_carry && !units.empty() && isLowSurrogate(units.front())) {
+            auto high = *_carry;
+            _carry.reset();
+            if (!appendCodePoint(combineSurrogates(high, units.front()), 2)) {
+                return;
+            }
+            units = units.subspan(1);
+        }
+        flushCarry();
+        if (_full || units.empty()) {
+            return;
+        }
+
+        if (isHighSurrogate(units.back())) {
+            _carry = units.back();
+            units = units.first(units.size() - 1);
+        }
+
+        // Lone surrogates are replaced upfront, so that simdutf transcodes well-formed input
+        std::u16string wellFormed;
+        if (!simdutf::validate_utf16(units.data(), units.size())) {
+            wellFormed.resize(units.size());
+            simdutf::to_well_formed_utf16(units.data(), units.size(), wellFormed.data());
+            units = wellFormed;
+        }
+
+        auto length = simdutf::utf8_length_from_utf16(units.data(), units.size());
+        if (!_writing) {
+            _size += length;
+            _read += units.size();
+            return;
+        }
+        if (fits(length)) {
+            _size += simdutf::convert_valid_utf16_to_utf8(units.data(), units.size(), next());
+            _read += units.size();
+            return;
+        }
+
+        for (size_t i = 0; i < units.size(); ++i) {
+            auto appended = isHighSurrogate(units[i]) ? appendCodePoint(combineSurrogates(units[i], units[i + 1]), 2)
+                                                      : appendCodePoint(units[i], 1);
+            if (!appended) {
+                return;
+            }
+            i += isHighSurrogate(units[i]) ? 1 : 0;
+        }
+    }
+
+    void flushCarry()
+    {
+        if (!_carry) {
+            return;
+        }
+
+        _carry.reset();
+        if (!_full) {
+            appendCodePoint(kReplacementCharacter, 1);
+        }
+    }
+
+    /**
+     * Appends code point decoded from `units` UTF-16 code units.
+     *
+     * @return Whether it fit into output
+     */
+    auto appendCodePoint(char32_t codePoint, size_t units) -> bool
+    {
+        size_t length = codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+        if (_writing && !fits(length)) {
+            _full = true;
+            return false;
+        }
+
+        if (_writing) {
+            auto* out = reinterpret_cast<uint8_t*>(next());
+            switch (length) {
+            case 1:
+                out[0] = static_cast<uint8_t>(codePoint);
+                break;
+            case 2:
+                out[0] = static_cast<uint8_t>(0xC0 | (codePoint >> 6));
+                out[1] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+                break;
+            case 3:
+                out[0] = static_cast<uint8_t>(0xE0 | (codePoint >> 12));
+                out[1] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+                out[2] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+                break;
+            default:
+                out[0] = static_cast<uint8_t>(0xF0 | (codePoint >> 18));
+                out[1] = static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+                out[2] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+                out[3] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+                break;
+            }
+        }
+
+        _size += length;
+        _read += units;
+        return true;
+    }
+
+    [[nodiscard]]
+    auto fits(size_t length) const noexcept -> bool
+    {
+        return _size + length <= _output.size();
+    }
+
+    auto next() noexcept -> char*
+    {
+        return reinterpret_cast<char*>(_output.data() + _size);
+    }
+
+    std::span<uint8_t> _output;
+    bool _writing = false;
+    bool _full = false;
+    size_t _size = 0;
+    size_t _read = 0;
+    std::optional<char16_t> _carry;
+};
+
+auto toJSString(Environment& env, const jsi::Value& value) -> jsi::String
+{
+    return value.isString() ? value.getString(env) : value.toString(env);
+}
+
+/**
+ * Converts `value` to boolean, as JS `Boolean(value)` does.
+ */
+auto isTruthy(Environment& env, const jsi::Value& value) -> bool
+{
+    if (value.isBool()) {
+        return value.getBool();
+    }
+    if (value.isNumber()) {
+        auto number = value.getNumber();
+        return number != 0 && number == number;
+    }
+    if (value.isString()) {
+        return !value.getString(env).utf8(env).empty();
+    }
+    return value.isObject() || value.isSymbol() || value.isBigInt();
+}
+
+/**
+ * Tag of `Uint8Array` constructor cached by environments.
+ */
+struct Uint8ArrayConstructor {};
+
+auto toUint8Array(Environment& env, std::shared_ptr<NativeBuffer> buffer) -> jsi::Value
+{
+    const auto& constructor = env.objectForType(typeid(Uint8ArrayConstructor), [](Environment& env) {
+        return env.globalObject().getPropertyAsObject(env, "Uint8Array");
+    });
+    return constructor.asFunction(env).callAsConstructor(env, toArrayBuffer(env, std::move(buffer)));
+}
+
+auto textEncoderClass() -> const NativeClass<TextEncoder>&
+{
+    static const auto binding
+        = NativeClass<TextEncoder>("TextEncoder")
+              .method(
+                  "encode",
+                  [](TextEncoder&, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      const auto& input = argumentAt(args, count, 0);
+                      auto string = input.isUndefined() ? jsi::String::createFromAscii(env, "") : toJSString(env, input);
+
+                      auto buffer = NativeBuffer::allocate(TextEncoder::encodedLength(env, string));
+                      TextEncoder::encode(env, string, buffer->bytes());
+                      return toUint8Array(env, std::move(buffer));
+                  },
+                  1
+              )
+              .method(
+                  "encodeInto",
+                  [](TextEncoder&, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      auto string = toJSString(env, argumentAt(args, count, 0));
+                      auto destination = bytesOf(env, argumentAt(args, count, 1));
+                      auto [read, written] = TextEncoder::encodeInto(env, string, destination);
+
+                      jsi::Object result { env };
+                      result.setProperty(env, "read", static_cast<double>(read));
+                      result.setProperty(env, "written", static_cast<double>(written));
+                      return result;
+                  },
+                  2
+              )
+              .getter("encoding", [](TextEncoder&, Environment& env) { return jsi::Value(jsi::String::createFromAscii(env, "utf-8")); })
+              .constructor([](Environment&, const jsi::Value*, size_t) { return std::make_shared<TextEncoder>(); });
+    return binding;
+}
+
+auto textDecoderClass() -> const NativeClass<TextDecoder>&
+{
+    static const auto binding
+        = NativeClass<TextDecoder>("TextDecoder")
+              .method(
+                  "decode",
+                  [](TextDecoder& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      // Options are read first, as their getters may run JS which detaches the input
+                      const auto& options = argumentAt(args, count, 1);
+                      auto stream = options.isObject() && isTruthy(env, options.getObject(env).getProperty(env, "stream"));
+
+                      const auto& input = argumentAt(args, count, 0);
+                      auto bytes = input.isUndefined() ? std::span<const uint8_t>() : bytesOf(env, input);
+                      try {
+                          return self.decode(env, bytes, stream);
+                      }
+                      catch (const TextDecodingError& error) {
+                          throwError(env, "TypeError", error.what());
+                      }
+                  },
+                  1
+              )
+              .getter("encoding", [](TextDecoder& self, Environment& env) {
+                  auto name = nameOf(self.encoding());
+                  return jsi::Value(jsi::String::createFromAscii(env, name.data(), name.size()));
+              })
+              .getter("fatal", [](TextDecoder& self, Environment&) { return jsi::Value(self.options().fatal); })
+              .getter("ignoreBOM", [](TextDecoder& self, Environment&) { return jsi::Value(self.options().ignoreBOM); })
+              .constructor([](Environment& env, const jsi::Value* args, size_t count) {
+                  const auto& labelArgument = argumentAt(args, count, 0);
+                  auto label = labelArgument.isUndefined() ? std::string("utf-8") : toJSString(env, labelArgument).utf8(env);
+                  auto encoding = findTextEncoding(label);
+                  if (!encoding) {
+                      throwError(env, "RangeError", fmt::format("The encoding label provided ('{}') is invalid", label));
+                  }
+
+                  TextDecoder::Options options;
+                  const auto& optionsArgument = argumentAt(args, count, 1);
+                  if (optionsArgument.isObject()) {
+                      auto object = optionsArgument.getObject(env);
+                      options.fatal = isTruthy(env, object.getProperty(env, "fatal"));
+                      options.ignoreBOM = isTruthy(env, object.getProperty(env, "ignoreBOM"));
+                  }
+                  return std::make_shared<TextDecoder>(*encoding, options);
+              });
+    return binding;
+}
+
+}
+
+auto findTextEncoding(std::string_view label) noexcept -> std::optional<TextEncoding>
+{
+    constexpr std::string_view whitespace = "\t\n\f\r ";
+    auto begin = label.find_first_not_of(whitespace);
+    if (begin == std::string_view::npos) {
+        return std::nullopt;
+    }
+    label = label.substr(begin, label.find_last_not_of(whitespace) - begin + 1);
+
+    for (const auto& entry : encodingLabels) {
+        auto matches = std::ranges::equal(label, entry.label, [](char a, char b) {
+            return (a >= 'A' && a <= 'Z' ? static_cast<char>(a - 'A' + 'a') : a) == b;
+        });
+        if (matches) {
+            return entry.encoding;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto nameOf(TextEncoding encoding) noexcept -> std::string_view
+{
+    switch (encoding) {
+    case TextEncoding::Utf8:
+        return "utf-8";
+    case TextEncoding::Utf16le:
+        return "utf-16le";
+    case TextEncoding::Windows1252:
+        return "windows-1252";
+    }
+    return "";
+}
+
+//
+// ------------------------------------------------------------------------------------------------- TextEncoder
+//
+auto TextEncoder::encodedLength(jsi::Runtime& rt, const jsi::String& string) -> size_t
+{
+    Utf8Transcoder transcoder;
+    string.getStringData(rt, transcoder);
+    transcoder.finish();
+    return transcoder.written();
+}
+
+auto TextEncoder::encode(jsi::Runtime& rt, const jsi::String& string, std::span<uint8_t> destination) -> size_t
+{
+    Utf8Transcoder transcoder { destination };
+    string.getStringData(rt, transcoder);
+    transcoder.finish();
+    return transcoder.written();
+}
+
+auto TextEncoder::encodeInto(jsi::Runtime& rt, const jsi::String& string, std::span<uint8_t> destination)
+    -> EncodeIntoResult
+{
+    Utf8Transcoder transcoder { destination };
+    string.getStringData(rt, transcoder);
+    transcoder.finish();
+    return { .read = transcoder.read(), .written = transcoder.written() };
+}
+
+//
+// ------------------------------------------------------------------------------------------------- TextDecoder
+//
+auto TextDecoder::decode(jsi::Runtime& rt, std::span<const uint8_t> input, bool stream) -> jsi::String
+{
+    const auto* chars = reinterpret_cast<const char*>(input.data());
+
+    // ASCII input in the middle of no sequence becomes a string without transcoding
+    auto idle = _utf8.bytesNeeded == 0 && !_utf16LeadByte && !_utf16LeadSurrogate;
+    if (_encoding != TextEncoding::Utf16le && idle && simdutf::validate_ascii(chars, input.size())) {
+        _bomSeen = _bomSeen || !input.empty();
+        if (!stream) {
+            reset();
+        }
+        return jsi::String::createFromAscii(rt, chars, input.size());
+    }
+
+    std::u16string output;
+    try {
+        switch (_encoding) {
+        case TextEncoding::Utf8:
+            decodeUtf8(input, stream, output);
+            break;
+        case TextEncoding::Utf16le:
+            decodeUtf16(input, stream, output);
+            break;
+        case TextEncoding::Windows1252:
+            decodeWindows1252(input, output);
+            break;
+        }
+    }
+    catch (const TextDecodingError&) {
+        reset();
+        throw;
+    }
+
+    if (!stream) {
+        reset();
+    }
+    return jsi::String::createFromUtf16(rt, output.data(), output.size());
+}
+
+void TextDecoder::decodeUtf8(std::span<const uint8_t> input, bool stream, std::u16string& output)
+{
+    // Sequence left incomplete by the previous chunk is completed first
+    size_t offset = 0;
+    while (_utf8.bytesNeeded != 0 && offset < input.size()) {
+        if (stepUtf8(input[offset], output)) {
+            ++offset;
+        }
+    }
+
+    auto rest = input.subspan(offset);
+    auto bulk = rest.first(stream ? completeSequencesLength(rest) : rest.size());
+    const auto* chars = reinterpret_cast<const char*>(bulk.data());
+    if (simdutf::validate_utf8(chars, bulk.size())) {
+        auto start = output.size();
+        output.resize(start + simdutf::utf16_length_from_utf8(chars, bulk.size()));
+        simdutf::convert_valid_utf8_to_utf16le(chars, bulk.size(), output.data() + start);
+    }
+    else {
+        decodeUtf8Scalar(bulk, output);
+    }
+
+    // Incomplete sequence at the end stays in decoder state
+    decodeUtf8Scalar(rest.subspan(bulk.size()), output);
+    if (!stream && _utf8.bytesNeeded != 0) {
+        _utf8 = {};
+        appendReplacement(output);
+    }
+
+    stripBOM(output);
+}
+
+void TextDecoder::decodeUtf16(std::span<const uint8_t> input, bool stream, std::u16string& output)
+{
+    output.reserve(input.size() / 2 + 2);
+    if (_utf16LeadSurrogate) {
+        output.push_back(*_utf16LeadSurrogate);
+        _utf16LeadSurrogate.reset();
+    }
+
+    size_t offset = 0;
+    if (_utf16LeadByte && !input.empty()) {
+        output.push_back(static_cast<char16_t>(*_utf16LeadByte | (input.front() << 8)));
+        _utf16LeadByte.reset();
+        offset = 1;
+    }
+
+    auto units = (input.size() - offset) / 2;
+    auto start = output.size();
+    output.resize(start + units);
+    std::memcpy(output.data() + start, input.data() + offset, units * 2);
+    if ((input.size() - offset) % 2 != 0) {
+        _utf16LeadByte = input.back();
+    }
+
+    // High surrogate at the end may be paired by the next chunk
+    if (stream && !output.empty() && isHighSurrogate(output.back())) {
+        _utf16LeadSurrogate = output.back();
+        output.pop_back();
+    }
+
+    if (!simdutf::validate_utf16le(output.data(), output.size())) {
+        if (_options.fatal) {
+            throw TextDecodingError("The encoded data was not valid utf-16le");
+        }
+        simdutf::to_well_formed_utf16le(output.data(), output.size(), output.data());
+    }
+
+    if (!stream && _utf16LeadByte) {
+        _utf16LeadByte.reset();
+        appendReplacement(output);
+    }
+
+    stripBOM(output);
+}
+
+void TextDecoder::decodeWindows1252(std::span<const uint8_t> input, std::u16string& output)
+{
+    auto start = output.size();
+    output.resize(start + input.size());
+    simdutf::convert_latin1_to_utf16le(reinterpret_cast<const char*>(input.data()), input.size(), output.data() + start);
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        if (input[i] >= 0x80 && input[i] <= 0x9F) {
+            output[start + i] = windows1252HighControls[input[i] - 0x80];
+        }
+    }
+}
+
+auto TextDecoder::stepUtf8(uint8_t byte, std::u16string& output) -> bool
+{
+    auto& state = _utf8;
+    if (state.bytesNeeded == 0) {
+        if (byte <= 0x7F) {
+            output.push_back(byte);
+        }
+        else if (byte >= 0xC2 && byte <= 0xDF) {
+            state.bytesNeeded = 1;
+            state.codePoint = byte & 0x1F;
+        }
+        else if (byte >= 0xE0 && byte <= 0xEF) {
+            state.lowerBoundary = byte == 0xE0 ? 0xA0 : 0x80;
+            state.upperBoundary = byte == 0xED ? 0x9F : 0xBF;
+            state.bytesNeeded = 2;
+            state.codePoint = byte & 0xF;
+        }
+        else if (byte >= 0xF0 && byte <= 0xF4) {
+            state.lowerBoundary = byte == 0xF0 ? 0x90 : 0x80;
+            state.upperBoundary = byte == 0xF4 ? 0x8F : 0xBF;
+            state.bytesNeeded = 3;
+            state.codePoint = byte & 0x7;
+        }
+        else {
+            appendReplacement(output);
+        }
+        return true;
+    }
+
+    if (byte < state.lowerBoundary || byte > state.upperBoundary) {
+        state = {};
+        appendReplacement(output);
+        return false;
+    }
+
+    state.lowerBoundary = 0x80;
+    state.upperBoundary = 0xBF;
+    state.codePoint = (state.codePoint << 6) | (byte & 0x3F);
+    if (++state.bytesSeen == state.bytesNeeded) {
+        appendCodePoint(output, state.codePoint);
+        state = {};
+    }
+    return true;
+}
+
+void TextDecoder::decodeUtf8Scalar(std::span<const uint8_t> input, std::u16string& output)
+{
+    output.reserve(output.size() + input.size());
+    for (size_t i = 0; i < input.size();) {
+        if (stepUtf8(input[i], output)) {
+            ++i;
+        }
+    }
+}
+
+void TextDecoder::appendReplacement(std::u16string& output)
+{
+    if (_options.fatal) {
+        throw TextDecodingError(fmt::format("The encoded data was not valid {}", nameOf(_encoding)));
+    }
+    output.push_back(kReplacementCharacter);
+}
+
+void TextDecoder::stripBOM(std::u16string& output)
+{
+    if (_bomSeen || output.empty()) {
+        return;
+    }
+
+    _bomSeen = true;
+    if (!_options.ignoreBOM && output.front() == kByteOrderMark) {
+        output.erase(0, 1);
+    }
+}
+
+void TextDecoder::reset() noexcept
+{
+    _utf8 = {};
+    _utf16LeadByte.reset();
+    _utf16LeadSurrogate.reset();
+    _bomSeen = false;
+}
+
+void installTextCodecs(Environment& env)
+{
+    auto global = env.globalObject();
+    global.setProperty(env, "TextEncoder", textEncoderClass().constructorFunction(env));
+    global.setProperty(env, "TextDecoder", textDecoderClass().constructorFunction(env));
+}
+
+}
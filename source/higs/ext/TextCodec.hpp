@@ -0,0 +1,182 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::ext {
+
+/**
+ * Encodings supported by `TextDecoder`.
+ */
+enum class TextEncoding {
+    Utf8,
+    Utf16le,
+
+    /**
+     * Labelled `latin1`, `iso-8859-1` and `ascii` as well, as the Encoding Standard maps these to windows-1252.
+     */
+    Windows1252,
+};
+
+/**
+ * Finds encoding by any of its labels in the Encoding Standard, e.g. `"utf8"` or `"latin1"`.
+ *
+ * Labels are matched case-insensitively, ignoring surrounding whitespace.
+ */
+auto findTextEncoding(std::string_view label) noexcept -> std::optional<TextEncoding>;
+
+/**
+ * Canonical name of `encoding`, e.g. `"utf-8"`.
+ */
+auto nameOf(TextEncoding encoding) noexcept -> std::string_view;
+
+/**
+ * Thrown by fatal `TextDecoder` on malformed input, surfaced to JS as `TypeError`.
+ */
+class TextDecodingError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Encodes JS strings as UTF-8, backing JS `TextEncoder`.
+ *
+ * String contents are read in place using `jsi::String::getStringData`, and transcoded with simdutf.
+ * Lone surrogates are encoded as U+FFFD.
+ */
+class TextEncoder final {
+public:
+    struct EncodeIntoResult {
+        /**
+         * UTF-16 code units of the source consumed.
+         */
+        size_t read;
+        size_t written;
+    };
+
+    /**
+     * Number of bytes UTF-8 encoding of `string` takes.
+     */
+    static auto encodedLength(jsi::Runtime& rt, const jsi::String& string) -> size_t;
+
+    /**
+     * Encodes `string` into `destination`, which must be at least `encodedLength` bytes long.
+     */
+    static auto encode(jsi::Runtime& rt, const jsi::String& string, std::span<uint8_t> destination) -> size_t;
+
+    /**
+     * Encodes as much of `string` as fits into `destination`, never writing partial characters.
+     */
+    static auto encodeInto(jsi::Runtime& rt, const jsi::String& string, std::span<uint8_t> destination)
+        -> EncodeIntoResult;
+};
+
+/**
+ * Decodes bytes into JS strings, backing JS `TextDecoder`.
+ *
+ * Valid input is validated and transcoded with simdutf, ASCII input becomes a string without transcoding.
+ * Malformed input is decoded by the scalar decoders of the Encoding Standard, replacing errors with U+FFFD.
+ *
+ * Streaming decodes keep incomplete sequences at the end of input, to be completed by the next call.
+ */
+class TextDecoder final {
+public:
+    struct Options {
+        /**
+         * Throw `TextDecodingError` on malformed input, instead of replacing it.
+         */
+        bool fatal = false;
+
+        /**
+         * Keep leading byte order mark in output.
+         */
+        bool ignoreBOM = false;
+    };
+
+    explicit TextDecoder(TextEncoding encoding, Options options = {}) noexcept
+        : _encoding(encoding), _options(options)
+    {
+    }
+
+    [[nodiscard]]
+    auto encoding() const noexcept -> TextEncoding
+    {
+        return _encoding;
+    }
+
+    [[nodiscard]]
+    auto options() const noexcept -> const Options&
+    {
+        return _options;
+    }
+
+    /**
+     * Decodes `input`, continuing sequences left incomplete by previous streaming call.
+     *
+     * @param stream Whether more input follows, so that incomplete sequence at its end is kept
+     * @throws TextDecodingError When decoder is fatal and input is malformed
+     */
+    auto decode(jsi::Runtime& rt, std::span<const uint8_t> input, bool stream = false) -> jsi::String;
+
+private:
+    /**
+     * State of the UTF-8 decoder of the Encoding Standard between bytes.
+     */
+    struct Utf8State {
+        char32_t codePoint = 0;
+        uint8_t bytesNeeded = 0;
+        uint8_t bytesSeen = 0;
+        uint8_t lowerBoundary = 0x80;
+        uint8_t upperBoundary = 0xBF;
+    };
+
+    void decodeUtf8(std::span<const uint8_t> input, bool stream, std::u16string& output);
+    void decodeUtf16(std::span<const uint8_t> input, bool stream, std::u16string& output);
+    void decodeWindows1252(std::span<const uint8_t> input, std::u16string& output);
+
+    /**
+     * Feeds single byte to the UTF-8 decoder.
+     *
+     * @return Whether the byte was consumed, a byte ending malformed sequence must be fed again
+     */
+    auto stepUtf8(uint8_t byte, std::u16string& output) -> bool;
+    void decodeUtf8Scalar(std::span<const uint8_t> input, std::u16string& output);
+
+    /**
+     * Appends U+FFFD in place of malformed input, or throws when fatal.
+     */
+    void appendReplacement(std::u16string& output);
+
+    /**
+     * Drops byte order mark starting first output of the stream, unless ignored.
+     */
+    void stripBOM(std::u16string& output);
+    void reset() noexcept;
+
+    TextEncoding _encoding;
+    Options _options;
+    bool _bomSeen = false;
+
+    Utf8State _utf8;
+    std::optional<uint8_t> _utf16LeadByte;
+    std::optional<char16_t> _utf16LeadSurrogate;
+};
+
+/**
+ * Defines global `TextEncoder` and `TextDecoder` classes in `env`.
+ */
+void installTextCodecs(Environment& env);
+
+}
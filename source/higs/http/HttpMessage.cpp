@@ -0,0 +1,229 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "HttpMessage.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+
+#include <fmt/format.h>
+
+namespace higs::http {
+
+namespace {
+
+constexpr std::string_view kLineEnd = "\r\n";
+constexpr std::string_view kHeadEnd = "\r\n\r\n";
+
+auto isTokenChar(char c) noexcept -> bool
+{
+    // RFC 9110 tchar
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+        || std::string_view("!#$%&'*+-.^_`|~").find(c) != std::string_view::npos;
+}
+
+auto trimWhitespace(std::string_view value) noexcept -> std::string_view
+{
+    auto isWhitespace = [](char c) { return c == ' ' || c == '\t'; };
+    while (!value.empty() && isWhitespace(value.front())) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && isWhitespace(value.back())) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+auto toLower(std::string_view value) -> std::string
+{
+    std::string lower(value);
+    std::ranges::transform(lower, lower.begin(), [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c; });
+    return lower;
+}
+
+/**
+ * Finds `token` in comma separated list `value`, ignoring case.
+ */
+auto hasToken(std::string_view value, std::string_view token) noexcept -> bool
+{
+    while (!value.empty()) {
+        auto comma = value.find(',');
+        auto item = trimWhitespace(value.substr(0, comma));
+        if (item.size() == token.size()
+            && std::ranges::equal(item, token, [](char a, char b) { return (a | 0x20) == (b | 0x20); })) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+void parseRequestLine(std::string_view line, HttpRequest& request)
+{
+    auto methodEnd = line.find(' ');
+    auto targetEnd = line.rfind(' ');
+    if (methodEnd == std::string_view::npos || methodEnd == 0 || targetEnd <= methodEnd + 1) {
+        throw HttpError(400, "Malformed request line");
+    }
+
+    auto method = line.substr(0, methodEnd);
+    if (!std::ranges::all_of(method, isTokenChar)) {
+        throw HttpError(400, "Malformed request method");
+    }
+
+    auto version = line.substr(targetEnd + 1);
+    if (version == "HTTP/1.1") {
+        request.minorVersion = 1;
+    } else if (version == "HTTP/1.0") {
+        request.minorVersion = 0;
+    } else {
+        throw HttpError(505, fmt::format("Unsupported protocol version '{}'", version));
+    }
+
+    request.method = method;
+    request.target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+}
+
+}
+
+auto parseRequestHead(std::string_view input, size_t maxSize) -> std::optional<RequestHead>
+{
+    // Empty lines preceding the request line are ignored, as clients may send them after a body
+    size_t start = 0;
+    while (input.substr(start).starts_with(kLineEnd)) {
+        start += kLineEnd.size();
+    }
+
+    auto end = input.find(kHeadEnd, start);
+    if (end == std::string_view::npos) {
+        if (input.size() > maxSize) {
+            throw HttpError(431, "Request head is too large");
+        }
+        return std::nullopt;
+    }
+    if (end + kHeadEnd.size() > maxSize) {
+        throw HttpError(431, "Request head is too large");
+    }
+
+    RequestHead head;
+    head.size = end + kHeadEnd.size();
+    auto& request = head.request;
+
+    auto lines = input.substr(start, end + kLineEnd.size() - start);
+    auto lineEnd = lines.find(kLineEnd);
+    parseRequestLine(lines.substr(0, lineEnd), request);
+    lines.remove_prefix(lineEnd + kLineEnd.size());
+
+    std::optional<size_t> contentLength;
+    auto keepAlive = request.minorVersion >= 1;
+    while (!lines.empty()) {
+        lineEnd = lines.find(kLineEnd);
+        auto line = lines.substr(0, lineEnd);
+        lines.remove_prefix(lineEnd + kLineEnd.size());
+
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0 || !std::all_of(line.begin(), line.begin() + colon, isTokenChar)) {
+            throw HttpError(400, "Malformed header field");
+        }
+        auto name = toLower(line.substr(0, colon));
+        auto value = trimWhitespace(line.substr(colon + 1));
+
+        if (name == "content-length") {
+            size_t length = 0;
+            auto [parsed, error] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (error != std::errc() || parsed != value.data() + value.size() || value.empty()
+                || (contentLength && *contentLength != length)) {
+                throw HttpError(400, "Invalid Content-Length");
+            }
+            contentLength = length;
+        } else if (name == "transfer-encoding") {
+            throw HttpError(501, "Transfer-Encoding is not supported");
+        } else if (name == "connection") {
+            if (hasToken(value, "close")) {
+                keepAlive = false;
+            } else if (hasToken(value, "keep-alive")) {
+                keepAlive = true;
+            }
+        } else if (name == "expect") {
+            if (!hasToken(value, "100-continue")) {
+                throw HttpError(417, "Unsupported expectation");
+            }
+            request.expectContinue = request.minorVersion >= 1;
+        }
+
+        request.headers.emplace_back(std::move(name), value);
+    }
+
+    request.keepAlive = keepAlive;
+    head.contentLength = contentLength.value_or(0);
+    return head;
+}
+
+auto serializeResponseHead(const HttpResponse& response, bool keepAlive) -> std::unique_ptr<folly::IOBuf>
+{
+    fmt::memory_buffer head;
+    fmt::format_to(std::back_inserter(head), "HTTP/1.1 {} {}\r\n", response.status, reasonPhrase(response.status));
+    for (const auto& [name, value] : response.headers) {
+        // Fields come from JS, and a line break would let them end the head early or inject fields
+        if (name.empty() || !std::ranges::all_of(name, isTokenChar)) {
+            throw HttpError(500, fmt::format("Invalid header name '{}'", name));
+        }
+        if (value.find_first_of(std::string_view("\r\n\0", 3)) != std::string::npos) {
+            throw HttpError(500, fmt::format("Invalid character in value of header '{}'", name));
+        }
+
+        // Framing fields are set by the server, so that they match the body actually sent
+        auto lower = toLower(name);
+        if (lower == "content-length" || lower == "connection" || lower == "transfer-encoding") {
+            continue;
+        }
+        fmt::format_to(std::back_inserter(head), "{}: {}\r\n", name, value);
+    }
+
+    if (response.status >= 200 && response.status != 204) {
+        auto length = response.body ? response.body->computeChainDataLength() : 0;
+        fmt::format_to(std::back_inserter(head), "Content-Length: {}\r\n", length);
+    }
+    fmt::format_to(std::back_inserter(head), "Connection: {}\r\n\r\n", keepAlive ? "keep-alive" : "close");
+    return folly::IOBuf::copyBuffer(head.data(), head.size());
+}
+
+auto responseHasBody(std::string_view method, uint16_t status) noexcept -> bool
+{
+    return method != "HEAD" && status >= 200 && status != 204 && status != 304;
+}
+
+auto reasonPhrase(uint16_t status) noexcept -> std::string_view
+{
+    switch (status) {
+    case 100: return "Continue";
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 413: return "Content Too Large";
+    case 417: return "Expectation Failed";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    case 505: return "HTTP Version Not Supported";
+    default: return "";
+    }
+}
+
+}
@@ -0,0 +1,121 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <folly/io/IOBuf.h>
+
+namespace higs::http {
+
+/**
+ * Header fields in order of appearance, request header names are lowercase.
+ */
+using HttpHeaders = std::vector<std::pair<std::string, std::string>>;
+
+struct HttpRequest {
+    std::string method;
+    std::string target;
+
+    /**
+     * Minor version of HTTP/1, 0 or 1.
+     */
+    int minorVersion = 1;
+    HttpHeaders headers;
+
+    /**
+     * Body in one unshared buffer, or `nullptr` when the request has none.
+     */
+    std::unique_ptr<folly::IOBuf> body;
+
+    /**
+     * Whether the connection stays open after this request, per its version and `Connection` header.
+     */
+    bool keepAlive = true;
+
+    /**
+     * Whether the client waits for `100 Continue` before sending the body.
+     */
+    bool expectContinue = false;
+};
+
+struct HttpResponse {
+    uint16_t status = 200;
+    HttpHeaders headers;
+    std::unique_ptr<folly::IOBuf> body;
+};
+
+/**
+ * Request that cannot be served, responded to with `status`, after which the connection is closed.
+ */
+class HttpError final : public std::runtime_error {
+public:
+    HttpError(uint16_t status, const std::string& message) : std::runtime_error(message), _status(status) {}
+
+    [[nodiscard]]
+    auto status() const noexcept -> uint16_t
+    {
+        return _status;
+    }
+
+private:
+    uint16_t _status;
+};
+
+/**
+ * Request line and headers parsed from the start of a connection's input.
+ */
+struct RequestHead {
+    HttpRequest request;
+    size_t contentLength = 0;
+
+    /**
+     * Bytes of input taken by the head, including the empty line ending it.
+     */
+    size_t size = 0;
+};
+
+/**
+ * Parses request head at the start of `input`.
+ *
+ * Bodies are delimited by `Content-Length` only, chunked requests are refused.
+ *
+ * @param input Received bytes, which may end in the middle of the head
+ * @param maxSize Largest accepted head
+ * @return Parsed head, or `std::nullopt` when `input` does not hold a whole head yet
+ * @throws HttpError When the head is malformed, too large, or uses unsupported features
+ */
+auto parseRequestHead(std::string_view input, size_t maxSize) -> std::optional<RequestHead>;
+
+/**
+ * Whether response with `status` to a request with `method` carries a body, which responses to `HEAD` and with
+ * status 1xx, 204 or 304 never do.
+ */
+auto responseHasBody(std::string_view method, uint16_t status) noexcept -> bool;
+
+/**
+ * Serializes status line and headers of `response`, adding `Content-Length` and `Connection`.
+ *
+ * Content length is that of the body even when it is not sent (e.g. in response to `HEAD`), except for status
+ * 1xx and 204, which have no `Content-Length`.
+ *
+ * @throws HttpError With status 500, when a header name is not a token or a value holds CR, LF or NUL
+ */
+auto serializeResponseHead(const HttpResponse& response, bool keepAlive) -> std::unique_ptr<folly::IOBuf>;
+
+/**
+ * Gets reason phrase of common status codes, or an empty string.
+ */
+auto reasonPhrase(uint16_t status) noexcept -> std::string_view;
+
+}
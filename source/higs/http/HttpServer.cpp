@@ -0,0 +1,579 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "HttpServer.hpp"
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <deque>
+#include <new>
+#include <optional>
+#include <string>
+
+#include <folly/executors/InlineExecutor.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/AsyncSocket.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBaseManager.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/jsrt/Runtime.hpp>
+#include <higs/modules/BuiltinModules.hpp>
+
+namespace higs::http {
+
+namespace {
+
+constexpr std::string_view kContinue = "HTTP/1.1 100 Continue\r\n\r\n";
+
+auto errorResponse(uint16_t status, std::string_view message) -> HttpResponse
+{
+    HttpResponse response;
+    response.status = status;
+    response.headers.emplace_back("Content-Type", "text/plain; charset=utf-8");
+    response.body = folly::IOBuf::copyBuffer(message.data(), message.size());
+    return response;
+}
+
+auto toJS(HttpRequest request, jsrt::Environment& env) -> jsi::Value
+{
+    jsi::Object headers { env };
+    for (const auto& [name, value] : request.headers) {
+        // Repeated fields are combined, as by `Headers` of the Fetch API
+        auto previous = headers.getProperty(env, name.c_str());
+        auto combined = previous.isString() ? previous.getString(env).utf8(env) + ", " + value : value;
+        headers.setProperty(env, name.c_str(), jsi::String::createFromUtf8(env, combined));
+    }
+
+    jsi::Object object { env };
+    object.setProperty(env, "method", jsi::String::createFromUtf8(env, request.method));
+    object.setProperty(env, "url", jsi::String::createFromUtf8(env, request.target));
+    object.setProperty(env, "headers", std::move(headers));
+    object.setProperty(
+        env,
+        "body",
+        request.body ? jsi::Value(ext::toArrayBuffer(env, std::move(request.body))) : jsi::Value::null()
+    );
+    return object;
+}
+
+auto bodyOf(jsrt::Environment& env, const jsi::Value& value) -> std::unique_ptr<folly::IOBuf>
+{
+    std::string storage;
+    auto bytes = ext::bytesOrUtf8Of(env, value, storage);
+    return folly::IOBuf::copyBuffer(bytes.data(), bytes.size());
+}
+
+}
+
+bool convertFromJS(HttpResponse& into, const jsi::Value& from, jsrt::Environment& env)
+{
+    if (!from.isObject() || from.getObject(env).isArrayBuffer(env) || from.getObject(env).hasProperty(env, "byteLength")) {
+        into.body = bodyOf(env, from);
+        return true;
+    }
+
+    auto object = from.getObject(env);
+    auto status = object.getProperty(env, "status");
+    if (!status.isUndefined()) {
+        // Interim (1xx) responses would be sent as the final one
+        into.status = static_cast<uint16_t>(modules::integerArgument(env, status, "status", 200, 599));
+    }
+
+    auto headers = object.getProperty(env, "headers");
+    if (headers.isObject()) {
+        auto fields = headers.getObject(env);
+        auto names = fields.getPropertyNames(env);
+        for (size_t i = 0, count = names.size(env); i < count; ++i) {
+            auto name = names.getValueAtIndex(env, i).getString(env).utf8(env);
+            auto value = fields.getProperty(env, name.c_str()).toString(env).utf8(env);
+            into.headers.emplace_back(std::move(name), std::move(value));
+        }
+    }
+
+    auto body = object.getProperty(env, "body");
+    if (!body.isUndefined() && !body.isNull()) {
+        into.body = bodyOf(env, body);
+    }
+    return true;
+}
+
+//
+// ------------------------------------------------------------------------------------------------- HttpConnection
+//
+/**
+ * Connection served by the I/O thread that accepted it.
+ *
+ * Input is read into a queue until a request head is complete, and then directly into the buffer of its body.
+ * Requests are dispatched as they are parsed, responses wait in order of their requests until sent. Reading pauses
+ * while `maxPipelined` responses are pending.
+ */
+class HttpConnection final : public std::enable_shared_from_this<HttpConnection>, private folly::AsyncReader::ReadCallback {
+public:
+    HttpConnection(HttpServer& server, folly::AsyncSocket::UniquePtr socket)
+        : _server(server), _options(server.options()), _socket(std::move(socket))
+    {
+        _timeout = folly::AsyncTimeout::make(*_socket->getEventBase(), [this]() noexcept { timeoutExpired(); });
+    }
+
+    HIGS_MAKE_NON_COPYABLE(HttpConnection);
+    ~HttpConnection() noexcept override = default;
+
+    void start()
+    {
+        _socket->setReadCB(this);
+        updateTimeout();
+    }
+
+    auto eventBase() noexcept -> folly::EventBase&
+    {
+        return *_socket->getEventBase();
+    }
+
+    /**
+     * Closes the connection, discarding pending responses.
+     *
+     * @param graceful Whether data already written is sent first, which is only safe once the peer stopped sending
+     */
+    void close(bool graceful = false) noexcept
+    {
+        if (_closed) {
+            return;
+        }
+
+        // Server holds the last reference
+        auto self = shared_from_this();
+        _closed = true;
+        _timeout->cancelTimeout();
+        _socket->setReadCB(nullptr);
+        if (graceful) {
+            _socket->close();
+        } else {
+            _socket->closeNow();
+        }
+        _pending.clear();
+        _incoming.reset();
+        _input.reset();
+        _server.connectionClosed(self);
+    }
+
+private:
+    struct PendingResponse {
+        std::optional<HttpResponse> response;
+        bool keepAlive;
+
+        /**
+         * Method of the request, as responses to `HEAD` have no body.
+         */
+        std::string method;
+    };
+
+    /**
+     * What the connection waits for, which determines its timeout.
+     */
+    enum class Wait {
+        /**
+         * Responses being handled, or nothing once closed.
+         */
+        None,
+        Request,
+        Head,
+        Body,
+    };
+
+    void getReadBuffer(void** buffer, size_t* length) override
+    {
+        if (_incoming) {
+            *buffer = _incoming->body->writableTail();
+            *length = _bodyRemaining;
+            return;
+        }
+        auto [data, size] = _input.preallocate(4 << 10, 64 << 10);
+        *buffer = data;
+        *length = size;
+    }
+
+    void readDataAvailable(size_t length) noexcept override
+    {
+        if (_incoming) {
+            _incoming->body->append(length);
+            _bodyRemaining -= length;
+            if (_bodyRemaining == 0) {
+                auto request = std::move(*_incoming);
+                _incoming.reset();
+                dispatch(std::move(request));
+            }
+        } else {
+            _input.postallocate(length);
+        }
+
+        parse();
+        updateReading();
+    }
+
+    void readEOF() noexcept override
+    {
+        _peerEnded = true;
+        _reading = false;
+        // Peer is not sending the rest of the body, yet it may wait for responses to complete requests
+        _incoming.reset();
+        if (_pending.empty()) {
+            close(true);
+            return;
+        }
+        updateTimeout();
+    }
+
+    void readErr(const folly::AsyncSocketException&) noexcept override
+    {
+        close();
+    }
+
+    /**
+     * Dispatches requests complete in the input, until the pipeline is full.
+     */
+    void parse() noexcept
+    {
+        while (_reading && !_incoming && !_input.empty() && _pending.size() < _options.maxPipelined) {
+            _input.gather(_input.chainLength());
+            const auto* front = _input.front();
+            std::string_view input { reinterpret_cast<const char*>(front->data()), front->length() };
+
+            std::optional<RequestHead> head;
+            try {
+                head = parseRequestHead(input, _options.maxHeadSize);
+            }
+            catch (const HttpError& error) {
+                fail(error.status(), error.what());
+                return;
+            }
+            if (!head) {
+                return;
+            }
+
+            _input.trimStart(head->size);
+            auto& request = head->request;
+            if (head->contentLength > _options.maxBodySize) {
+                fail(413, "Request body is too large");
+                return;
+            }
+            if (head->contentLength == 0) {
+                dispatch(std::move(request));
+                continue;
+            }
+
+            // Only the part of the body read along with the head is copied, the rest is read into place. Body is
+            // allocated at once, which may fail before the limit is reached when it is set high
+            try {
+                request.body = folly::IOBuf::create(head->contentLength);
+            }
+            catch (const std::bad_alloc&) {
+                fail(413, "Request body is too large");
+                return;
+            }
+            auto available = std::min(head->contentLength, _input.chainLength());
+            if (available > 0) {
+                folly::io::Cursor(_input.front()).pull(request.body->writableTail(), available);
+                request.body->append(available);
+                _input.trimStart(available);
+            }
+
+            if (available == head->contentLength) {
+                dispatch(std::move(request));
+                continue;
+            }
+
+            // Interim response would precede responses to previous requests otherwise
+            if (request.expectContinue && _pending.empty()) {
+                _socket->writeChain(nullptr, folly::IOBuf::copyBuffer(kContinue.data(), kContinue.size()));
+            }
+            _bodyRemaining = head->contentLength - available;
+            _incoming = std::move(request);
+        }
+    }
+
+    void dispatch(HttpRequest request)
+    {
+        // Head timeout of a following pipelined request starts once this one is complete
+        _waiting = Wait::None;
+        _timeout->cancelTimeout();
+        auto sequence = _firstSequence + _pending.size();
+        _pending.push_back({ .response = std::nullopt, .keepAlive = request.keepAlive, .method = request.method });
+        if (!request.keepAlive) {
+            _reading = false;
+        }
+        _server.requestDispatched();
+
+        auto [promise, future] = folly::makePromiseContract<HttpResponse>();
+        // Environment stays busy until the response is ready, so that requests are balanced by handlers in progress
+        _server.pool().runAsync([promise = std::move(promise), request = std::move(request), handler = _options.handler](
+                                    jsrt::Environment& env
+                                ) mutable -> folly::SemiFuture<folly::Unit> {
+            try {
+                auto function = env.globalObject().getPropertyAsFunction(env, handler.c_str());
+                auto result = function.call(env, toJS(std::move(request), env));
+                return jsrt::fromJS<folly::SemiFuture<HttpResponse>>(result, env)
+                    .via(&folly::InlineExecutor::instance())
+                    .thenTry([promise = std::move(promise)](folly::Try<HttpResponse>&& response) mutable {
+                        promise.setTry(std::move(response));
+                    })
+                    .semi();
+            }
+            catch (...) {
+                promise.setException(folly::exception_wrapper(std::current_exception()));
+                return folly::makeSemiFuture();
+            }
+        });
+
+        std::move(future)
+            .via(folly::getKeepAliveToken(eventBase()))
+            .thenTry([self = shared_from_this(), sequence](folly::Try<HttpResponse>&& response) {
+                if (response.hasException()) {
+                    self->respond(sequence, errorResponse(500, "Internal Server Error"));
+                } else {
+                    self->respond(sequence, std::move(response).value());
+                }
+            });
+    }
+
+    void respond(uint64_t sequence, HttpResponse response) noexcept
+    {
+        if (_closed) {
+            return;
+        }
+        _pending[sequence - _firstSequence].response = std::move(response);
+        flush();
+    }
+
+    /**
+     * Queues response to a request that cannot be served, and stops reading requests.
+     */
+    void fail(uint16_t status, std::string_view message) noexcept
+    {
+        _reading = false;
+        _incoming.reset();
+        _pending.push_back({ .response = errorResponse(status, message), .keepAlive = false });
+        flush();
+    }
+
+    /**
+     * Sends responses that are ready, in order of their requests.
+     */
+    void flush() noexcept
+    {
+        while (!_pending.empty() && _pending.front().response) {
+            auto& pending = _pending.front();
+            auto keepAlive = pending.keepAlive && !(_peerEnded && _pending.size() == 1);
+            std::unique_ptr<folly::IOBuf> data;
+            try {
+                data = serializeResponseHead(*pending.response, keepAlive);
+            }
+            catch (const HttpError& error) {
+                pending.response = errorResponse(error.status(), "Internal Server Error");
+                data = serializeResponseHead(*pending.response, keepAlive);
+            }
+            // Body would be read as the start of the following response, when the response has none
+            auto hasBody = responseHasBody(pending.method, pending.response->status);
+            if (hasBody && pending.response->body) {
+                data->appendToChain(std::move(pending.response->body));
+            }
+            _socket->writeChain(nullptr, std::move(data));
+            _pending.pop_front();
+            ++_firstSequence;
+
+            if (!keepAlive && !_peerEnded) {
+                // Peer closes once it reads the response, closing while it still sends would reset the connection
+                _socket->shutdownWrite();
+            }
+        }
+
+        if (_peerEnded && _pending.empty()) {
+            close(true);
+            return;
+        }
+        parse();
+        updateReading();
+    }
+
+    /**
+     * Pauses reading while the pipeline is full, input read meanwhile stays in the socket.
+     */
+    void updateReading()
+    {
+        if (_closed || _peerEnded) {
+            return;
+        }
+
+        auto paused = _reading && !_incoming && _pending.size() >= _options.maxPipelined;
+        auto* callback = paused ? nullptr : this;
+        if (_socket->getReadCallback() != callback) {
+            _socket->setReadCB(callback);
+        }
+        if (!_reading) {
+            // Nothing more is served, input is only read to notice the peer closing
+            _input.reset();
+        }
+        updateTimeout();
+    }
+
+    /**
+     * Restarts timeout when the connection starts waiting for something else.
+     */
+    void updateTimeout() noexcept
+    {
+        auto paused = _pending.size() >= _options.maxPipelined;
+        auto waiting = Wait::None;
+        if (_closed || _peerEnded) {
+            waiting = Wait::None;
+        } else if (_incoming) {
+            waiting = Wait::Body;
+        } else if (_reading && !paused && !_input.empty()) {
+            waiting = Wait::Head;
+        } else if (_pending.empty()) {
+            // Includes waiting for the peer to close, after the last response was sent
+            waiting = Wait::Request;
+        }
+        if (waiting == _waiting) {
+            return;
+        }
+
+        _waiting = waiting;
+        _timeout->cancelTimeout();
+        auto timeout = std::chrono::milliseconds::zero();
+        switch (waiting) {
+        case Wait::None: break;
+        case Wait::Request: timeout = _options.idleTimeout; break;
+        case Wait::Head: timeout = _options.headTimeout; break;
+        case Wait::Body: timeout = _options.bodyTimeout; break;
+        }
+        if (timeout > std::chrono::milliseconds::zero()) {
+            _timeout->scheduleTimeout(timeout);
+        }
+    }
+
+    void timeoutExpired() noexcept
+    {
+        if (_waiting == Wait::Request) {
+            close();
+            return;
+        }
+        // Response is still sent, once responses to previous requests are
+        _waiting = Wait::None;
+        fail(408, "Request timeout");
+    }
+
+    HttpServer& _server;
+    const HttpServer::Options& _options;
+    folly::AsyncSocket::UniquePtr _socket;
+
+    folly::IOBufQueue _input { folly::IOBufQueue::cacheChainLength() };
+    std::optional<HttpRequest> _incoming;
+    size_t _bodyRemaining = 0;
+
+    std::deque<PendingResponse> _pending;
+    uint64_t _firstSequence = 0;
+
+    std::unique_ptr<folly::AsyncTimeout> _timeout;
+    Wait _waiting = Wait::None;
+
+    /**
+     * Whether further requests are served, false after a request closing the connection or a malformed one.
+     */
+    bool _reading = true;
+    bool _peerEnded = false;
+    bool _closed = false;
+};
+
+//
+// ------------------------------------------------------------------------------------------------- HttpServer
+//
+HttpServer::HttpServer(Runtime& host, EnvironmentPool& pool, Options options)
+    : _pool(pool), _options(std::move(options)), _eventBases(host.platform().getIOEventBases())
+{
+}
+
+HttpServer::~HttpServer() noexcept
+{
+    stop();
+}
+
+void HttpServer::listen(const folly::SocketAddress& address, int backlog)
+{
+    if (_socket) {
+        throw std::logic_error("Server is already listening");
+    }
+
+    // Listening socket lives on the first I/O thread, and hands connections to all of them
+    auto& acceptBase = *_eventBases.front();
+    folly::AsyncServerSocket::UniquePtr socket { new folly::AsyncServerSocket(nullptr) };
+    acceptBase.runInEventBaseThreadAndWait([&] {
+        socket->attachEventBase(&acceptBase);
+        socket->bind(address);
+        socket->listen(backlog);
+        for (auto& eventBase : _eventBases) {
+            socket->addAcceptCallback(this, eventBase.get());
+        }
+        socket->startAccepting();
+    });
+    _socket = std::move(socket);
+}
+
+auto HttpServer::address() const -> folly::SocketAddress
+{
+    folly::SocketAddress address;
+    if (_socket) {
+        _socket->getAddress(&address);
+    }
+    return address;
+}
+
+void HttpServer::stop() noexcept
+{
+    if (_socket) {
+        _socket->getEventBase()->runInEventBaseThreadAndWait([this] {
+            _socket->stopAccepting();
+            _socket.reset();
+        });
+    }
+
+    // Connections accepted from now on are closed right away, open ones are closed on their threads
+    auto open = _connections.withWLock([](Connections& connections) {
+        connections.stopped = true;
+        return connections.open;
+    });
+    for (const auto& connection : open) {
+        connection->eventBase().runInEventBaseThreadAndWait([&connection] { connection->close(); });
+    }
+}
+
+void HttpServer::connectionAccepted(folly::NetworkSocket fd, const folly::SocketAddress& clientAddress, AcceptInfo) noexcept
+{
+    auto* eventBase = folly::EventBaseManager::get()->getExistingEventBase();
+    auto socket = folly::AsyncSocket::newSocket(eventBase, fd);
+    if (clientAddress.getFamily() != AF_UNIX) {
+        socket->setNoDelay(true);
+    }
+
+    auto connection = std::make_shared<HttpConnection>(*this, std::move(socket));
+    auto added = _connections.withWLock([&connection](Connections& connections) {
+        return !connections.stopped && connections.open.insert(connection).second;
+    });
+    if (added) {
+        connection->start();
+    }
+}
+
+void HttpServer::acceptError(folly::exception_wrapper) noexcept
+{
+    // Failing to accept one connection (e.g. when out of file descriptors) leaves the server listening
+}
+
+void HttpServer::connectionClosed(const std::shared_ptr<HttpConnection>& connection) noexcept
+{
+    _connections.wlock()->open.erase(connection);
+}
+
+}
@@ -0,0 +1,159 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/io/async/AsyncServerSocket.h>
+#include <folly/io/async/EventBase.h>
+#include <higs/common.hpp>
+#include <higs/http/HttpMessage.hpp>
+#include <higs/jsrt/EnvironmentPool.hpp>
+
+namespace higs {
+class Runtime;
+}
+
+namespace higs::http {
+
+class HttpConnection;
+
+/**
+ * Converts value returned by a request handler to a response.
+ *
+ * Value is a string or binary body of a `200` response, or an object `{ status?, headers?, body? }`, whose status
+ * is an integer from 200 to 599. Bodies are copied, as JS owns their memory.
+ *
+ * @throws jsi::JSError When the status is not an integer from 200 to 599
+ */
+bool convertFromJS(HttpResponse& into, const jsi::Value& from, jsrt::Environment& env);
+
+/**
+ * HTTP/1.1 server, handling requests by JS running in a pool of environments.
+ *
+ * Connections are accepted on all I/O threads of the runtime, and each is served by the thread that accepted it.
+ * Requests are parsed there, and dispatched to an environment of the pool according to its strategy, which calls
+ * global function `options.handler` with request `{ method, url, headers, body }`. Handler returns a response,
+ * or a promise of one, see `convertFromJS`. Requests of one connection may be handled by different environments.
+ *
+ * Connections are kept alive and requests may be pipelined, up to `maxPipelined` requests of a connection are
+ * handled at once, and their responses are sent in order. Request bodies are received directly into a buffer
+ * of their `Content-Length`, which JS gets as an ArrayBuffer without copying. Connections idle or receiving
+ * a request for too long are closed, see `Options`.
+ *
+ * Pool must outlive the server.
+ */
+class HttpServer final : private folly::AsyncServerSocket::AcceptCallback {
+public:
+    struct Options {
+        /**
+         * Name of global function handling requests in each environment.
+         */
+        std::string handler = "handleRequest";
+        size_t maxHeadSize = 64 << 10;
+        size_t maxBodySize = 16 << 20;
+        size_t maxPipelined = 16;
+
+        /**
+         * Time a connection waits for the next request, before it is closed.
+         */
+        std::chrono::milliseconds idleTimeout { 5000 };
+
+        /**
+         * Time to receive the rest of a request head once its first bytes arrived, and then the rest of its body,
+         * before the request is refused with `408`.
+         *
+         * Timeouts stop slow clients from holding connections open indefinitely, zero disables them.
+         */
+        std::chrono::milliseconds headTimeout { 60000 };
+        std::chrono::milliseconds bodyTimeout { 300000 };
+    };
+
+    HttpServer(Runtime& host, EnvironmentPool& pool, Options options);
+    HIGS_MAKE_NON_COPYABLE(HttpServer);
+
+    /**
+     * Stops the server, see `stop`.
+     */
+    ~HttpServer() noexcept override;
+
+    /**
+     * Binds `address`, and starts accepting connections.
+     *
+     * @throws std::system_error When the address cannot be bound
+     */
+    void listen(const folly::SocketAddress& address, int backlog = 1024);
+
+    /**
+     * Gets bound address, e.g. to find port chosen by the system for port 0.
+     */
+    [[nodiscard]]
+    auto address() const -> folly::SocketAddress;
+
+    /**
+     * Stops accepting connections, and closes open ones.
+     *
+     * Responses to requests being handled are discarded. Blocks until all I/O threads are done with the server,
+     * so it must not be called from one of them.
+     */
+    void stop() noexcept;
+
+    [[nodiscard]]
+    auto options() const noexcept -> const Options&
+    {
+        return _options;
+    }
+
+    [[nodiscard]]
+    auto pool() noexcept -> EnvironmentPool&
+    {
+        return _pool;
+    }
+
+    /**
+     * Number of requests dispatched to the pool so far.
+     */
+    [[nodiscard]]
+    auto requestCount() const noexcept -> size_t
+    {
+        return _requestCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Connections {
+        std::unordered_set<std::shared_ptr<HttpConnection>> open;
+        bool stopped = false;
+    };
+
+    void connectionAccepted(folly::NetworkSocket fd, const folly::SocketAddress& clientAddress, AcceptInfo info) noexcept
+        override;
+    void acceptError(folly::exception_wrapper error) noexcept override;
+
+    void connectionClosed(const std::shared_ptr<HttpConnection>& connection) noexcept;
+    void requestDispatched() noexcept
+    {
+        _requestCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    EnvironmentPool& _pool;
+    Options _options;
+
+    std::vector<folly::Executor::KeepAlive<folly::EventBase>> _eventBases;
+    folly::AsyncServerSocket::UniquePtr _socket;
+    folly::Synchronized<Connections> _connections;
+    std::atomic<size_t> _requestCount = 0;
+
+    friend class HttpConnection;
+};
+
+}
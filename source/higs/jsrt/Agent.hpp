@@ -5,6 +5,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdio>
+#include <type_traits>
+
+#include <fmt/format.h>
+#include <folly/ExceptionWrapper.h>
+#include <folly/concurrency/UnboundedQueue.h>
 #include <folly/executors/DrivableExecutor.h>
 #include <folly/executors/ScheduledExecutor.h>
 #include <folly/executors/SequencedExecutor.h>
@@ -12,54 +19,150 @@
 #include <folly/io/async/EventBase.h>
 #include <folly/io/async/ScopedEventBaseThread.h>
 #include <higs/jsrt/RefCounted.hpp>
+#include <higs/jsrt/Rendezvous.hpp>
+#include <higs/jsrt/TaskTracer.hpp>
 
 namespace higs {
 
+/**
+ * Runs tasks of its environments on a dedicated event base thread.
+ *
+ * Tasks are kept in agent's own queues, and drained in batches by a single event base callback.
+ * Only the first task scheduled on an idle agent wakes the event base, so that scheduling does not
+ * allocate a notification per task, and a task is never re-boxed into `folly::Function`.
+ *
+ * Agent is also a folly executor, so that futures and `folly::coro` tasks can continue on it. Tasks
+ * added this way run in order with the other tasks of normal priority.
+ */
 class Agent final
     : public jsrt::Agent
-    , public RefCounted<Agent> {
+    , public RefCounted<Agent>
+    , public folly::SequencedExecutor {
   protected:
     Agent() noexcept = default;
     ~Agent() noexcept = default;
 
   public:
+    /**
+     * Sets tracer recording spans of tasks scheduled on this agent.
+     *
+     * Must be called before any task is scheduled.
+     */
+    void setTracer(TaskTracer::Ptr tracer) noexcept
+    {
+        _tracer = std::move(tracer);
+    }
+
     void runLater(Func function) override
     {
-        _eventBaseThread.add(std::move(function));
+        enqueue(_tasks, traced("runLater", std::move(function)));
     }
 
+    /**
+     * Schedules `function` to run on this agent.
+     *
+     * Tasks with positive priority run before all tasks of normal priority waiting at the moment.
+     */
     void runWithPriority(Func function, int32_t priority) override
     {
-        _eventBaseThread.addWithPriority(std::move(function), priority);
+        enqueue(priority > 0 ? _urgentTasks : _tasks, traced("runWithPriority", std::move(function)));
     }
 
+    /**
+     * Schedules `function` to run on this agent after `delay`.
+     *
+     * Timers are kept by event base, so unlike other tasks, a timer allocates.
+     */
     void runAfter(Func function, std::chrono::milliseconds delay) override
     {
-        _eventBaseThread.getEventBase()->runAfterDelay(std::move(function), delay.count());
+        _eventBaseThread.getEventBase()->runAfterDelay(
+            [function = traced("runAfter", std::move(function))]() { function(); },
+            delay.count()
+        );
     }
 
+    /**
+     * Runs `func` on this agent, and blocks until it finishes.
+     *
+     * Exceptions thrown by `func` are rethrown to the caller. See `call`.
+     */
     void runNowBlocking(Func func) override
     {
-        folly::Baton<> ready;
-        if (_eventBaseThread.getEventBase()->isInEventBaseThread()) {
-            func();
-        }
-        else {
-            _eventBaseThread.getEventBase()->runInEventBaseThread([&ready, func = std::move(func)]() mutable {
-                SCOPE_EXIT
-                {
-                    ready.post();
-                };
-                folly::copy(std::move(func))();
-            });
+        call(func);
+    }
+
+    /**
+     * Runs `func` on this agent synchronously, and returns its result.
+     *
+     * When called from this agent's own thread (e.g. from a task, or reentrantly from another `call`),
+     * `func` runs inline. Otherwise it is queued behind already scheduled tasks, and the calling thread
+     * waits on a stack-allocated rendezvous: it spins briefly, then parks.
+     *
+     * Two agents must not synchronously call each other at the same time, as they would deadlock.
+     *
+     * @param func Function to run
+     * @return Result of `func`
+     * @throws Exception thrown by `func`
+     */
+    template<typename F>
+    auto call(F&& func) -> std::invoke_result_t<F&>
+    {
+        static_assert(!std::is_reference_v<std::invoke_result_t<F&>>, "Result is returned across threads, return a value");
+
+        if (isInAgentThread()) {
+            return func();
         }
 
-        ready.wait();
+        Rendezvous<std::invoke_result_t<F&>> rendezvous;
+        enqueue(_tasks, traced("runNowBlocking", [&rendezvous, &func] { rendezvous.fulfill(func); }));
+        return rendezvous.wait();
+    }
+
+    /**
+     * Whether calling thread is the one running this agent's tasks.
+     */
+    [[nodiscard]]
+    auto isInAgentThread() const noexcept -> bool
+    {
+        return _eventBaseThread.getEventBase()->isInEventBaseThread();
+    }
+
+    /**
+     * Gets event base running this agent's tasks.
+     *
+     * I/O registered on it (e.g. sockets) completes on the agent's thread, between its tasks.
+     */
+    [[nodiscard]]
+    auto getEventBase() const noexcept -> folly::EventBase&
+    {
+        return *_eventBaseThread.getEventBase();
     }
 
     void runInBackground(Func func) override
     {
-        _eventBaseThread.getEventBase()->add(std::move(func));
+        enqueue(_tasks, traced("runInBackground", std::move(func)));
+    }
+
+    /**
+     * Schedules `func` on this agent, as a folly executor.
+     */
+    void add(folly::Func func) override
+    {
+        enqueue(_tasks, traced("add", std::move(func)));
+    }
+
+    /**
+     * Keep-alive tokens of this executor hold a reference to the agent.
+     */
+    auto keepAliveAcquire() noexcept -> bool override
+    {
+        RefCounted<Agent>::retain();
+        return true;
+    }
+
+    void keepAliveRelease() noexcept override
+    {
+        RefCounted<Agent>::release();
     }
 
     bool isRunning() const noexcept override
@@ -73,6 +176,83 @@ class Agent final
     }
 
   private:
+    using TaskQueue = folly::UMPSCQueue<Func, false>;
+
+    /**
+     * Maximum number of tasks run by one drain, before event base gets to process I/O and timers.
+     */
+    static constexpr size_t kDrainBatchSize = 256;
+
+    void enqueue(TaskQueue& queue, Func func)
+    {
+        queue.enqueue(std::move(func));
+        if (!_drainScheduled.exchange(true)) {
+            _eventBaseThread.getEventBase()->runInEventBaseThread([this] { drain(); });
+        }
+    }
+
+    void drain()
+    {
+        // Cleared before draining, so that tasks enqueued meanwhile either get drained now, or schedule another drain
+        _drainScheduled.store(false);
+
+        Func func;
+        for (size_t i = 0; i < kDrainBatchSize; ++i) {
+            if (!_urgentTasks.try_dequeue(func) && !_tasks.try_dequeue(func)) {
+                return;
+            }
+            runTask(func);
+            func = nullptr;
+        }
+
+        if (!_drainScheduled.exchange(true)) {
+            _eventBaseThread.getEventBase()->runInEventBaseThread([this] { drain(); });
+        }
+    }
+
+    /**
+     * Runs `func`, reporting exception it throws, so that one failing task does not stall the ones queued after it.
+     *
+     * Environments report errors of their own tasks, only tasks added directly (e.g. empty `folly::Func`) get here.
+     */
+    static void runTask(Func& func) noexcept
+    {
+        try {
+            func();
+        }
+        catch (...) {
+            reportError(folly::exception_wrapper(std::current_exception()));
+        }
+    }
+
+    static void reportError(const folly::exception_wrapper& error) noexcept
+    {
+        try {
+            fmt::print(stderr, "Uncaught error in agent task: {}\n", error.what().toStdString());
+        }
+        catch (...) {
+            // Standard error is gone, there is nowhere else to report to
+        }
+    }
+
+    auto traced(const char* name, Func func) -> Func
+    {
+        if (_tracer == nullptr || !_tracer->isEnabled()) [[likely]] {
+            return func;
+        }
+
+        return _tracer->wrap(name, std::move(func));
+    }
+
+    TaskTracer::Ptr _tracer;
+
+    /**
+     * Queues must outlive the event base thread, whose destruction runs pending drains.
+     */
+    TaskQueue _tasks;
+    TaskQueue _urgentTasks;
+    std::atomic<bool> _drainScheduled = false;
+
     folly::ScopedEventBaseThread _eventBaseThread;
     friend class higs::RefCounted<Agent>;
 };
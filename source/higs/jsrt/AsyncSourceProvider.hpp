@@ -0,0 +1,71 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <string>
+
+#include <folly/coro/Task.h>
+#include <folly/executors/GlobalExecutor.h>
+#include <jsrt/jsrt.hpp>
+
+namespace higs {
+
+/**
+ * Source provider that loads sources without blocking a thread.
+ *
+ * `jsrt::SourceProvider` returns `std::future`, which can only be waited on by blocking. Providers that
+ * also implement this interface can be awaited from `folly::coro` tasks, see `loadSource`.
+ */
+class AsyncSourceProvider {
+public:
+    virtual ~AsyncSourceProvider() noexcept = default;
+
+    /**
+     * Loads source code for resolved path.
+     *
+     * Same contract as `jsrt::SourceProvider::getSourceFor`.
+     *
+     * @param runtime Instance of `jsrt::Runtime` dispatching this request
+     * @param resolvedPath Path to load
+     * @param originalRequest Original resolve request
+     * @return Task resulting in source code
+     */
+    virtual auto loadSource(
+        const jsrt::Runtime& runtime,
+        const std::string& resolvedPath,
+        const jsrt::ResolveRequest& originalRequest
+    ) const -> folly::coro::Task<std::string>
+        = 0;
+};
+
+/**
+ * Loads source code for resolved path from any source provider.
+ *
+ * Awaits `AsyncSourceProvider::loadSource` when `provider` implements it. Otherwise waits for
+ * `getSourceFor` on a background executor thread, so that the awaiting coroutine's thread is not blocked.
+ *
+ * @code{.cpp}
+ * auto source = co_await loadSource(provider, runtime, provider.resolve(runtime, request), request);
+ * @endcode
+ */
+inline auto loadSource(
+    const jsrt::SourceProvider& provider,
+    const jsrt::Runtime& runtime,
+    std::string resolvedPath,
+    jsrt::ResolveRequest originalRequest
+) -> folly::coro::Task<std::string>
+{
+    if (const auto* async = dynamic_cast<const AsyncSourceProvider*>(&provider)) {
+        co_return co_await async->loadSource(runtime, resolvedPath, originalRequest);
+    }
+
+    auto waitForSource = [&]() -> folly::coro::Task<std::string> {
+        co_return provider.getSourceFor(runtime, resolvedPath, originalRequest).get();
+    };
+    co_return co_await waitForSource().scheduleOn(folly::getGlobalCPUExecutor());
+}
+
+}
@@ -4,54 +4,313 @@
 //
 
 #include "Environment.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <fmt/format.h>
+#include <folly/json/json.h>
+#include <higs/ext/TextCodec.hpp>
+#include <higs/modules/BuiltinModules.hpp>
+#include "MappedFileBuffer.hpp"
 #include "Runtime.hpp"
 
 namespace higs {
 
-Environment::Environment(Runtime& host, Agent& agent, const std::string& name) noexcept
-    : _host(host), _name(name), _agent(agent)
+namespace {
+
+/**
+ * Number of environments currently sampled, Hermes sampling profiler is enabled while non-zero.
+ */
+std::mutex samplingProfilerMutex;
+size_t samplingProfilerUsers = 0;
+
+}
+
+Environment::Environment(Runtime& host, Agent& agent, const std::string& name, const EnvironmentOptions& options) noexcept
+    : _host(host), _name(name), _options(options), _agent(agent)
 {
-    _jsRuntime = std::move(facebook::hermes::makeHermesRuntime(host.jsRuntimeBuilder().build()));
+    auto config = options.toHermesConfig();
+    auto gcConfig = config.getGCConfig()
+                        .rebuild()
+                        .withCallback([timer = &_gcTimer](hermes::vm::GCEventKind kind, const char* description) {
+                            if (kind == hermes::vm::GCEventKind::CollectionStart) {
+                                timer->collectionStarted(description);
+                            }
+                            else if (kind == hermes::vm::GCEventKind::CollectionEnd) {
+                                timer->collectionFinished(description);
+                            }
+                        })
+                        .build();
+
+    _jsRuntime = std::move(facebook::hermes::makeHermesRuntime(config.rebuild().withGCConfig(gcConfig).build()));
+
+    if (options.builtinModules()) {
+        modules::installRequire(*this);
+    }
+    if (options.textCodecs()) {
+        ext::installTextCodecs(*this);
+    }
+}
+
+Environment::~Environment() noexcept
+{
+    if (_registeredForProfiling) {
+        _jsRuntime->unregisterForProfiling();
+    }
+}
+
+auto Environment::eventBase() noexcept -> folly::EventBase&
+{
+    return _agent.getEventBase();
 }
 
 void Environment::runNowBlocking(ScheduledFunction func)
 {
-    this->agent().runNowBlocking([func = std::move(func), this]() mutable {
-        // This should be safe as it is blocking
-        func(*this);
-    });
+    _agent.call([&func, this] { func(*this); });
+}
+
+template<typename F>
+void Environment::schedule(F&& enqueue)
+{
+    // Pairs with `close`: either it sees this thread scheduling and waits, or this thread sees it closed
+    _scheduling.fetch_add(1);
+    if (!_closed.load()) {
+        enqueue();
+    }
+    _scheduling.fetch_sub(1);
 }
 
 void Environment::runLater(ScheduledFunction func)
 {
-    this->agent().runNowBlocking([func = std::move(func), selfRef = asRef()]() mutable {
-        // This should be safe as it is blocking
-        func(*selfRef);
+    schedule([&] {
+        this->agent().runLater([func = std::move(func), work = jsrt::PendingWork(*this)]() mutable {
+            static_cast<Environment&>(work.environment()).runTask(func);
+        });
     });
 }
 
 void Environment::runWithPriority(ScheduledFunction func, int32_t priority)
 {
-    this->agent().runWithPriority([func = std::move(func), selfRef = asRef()]() mutable {
-        // This should be safe as it is blocking
-        func(*selfRef);
-    }, priority);
+    schedule([&] {
+        this->agent().runWithPriority([func = std::move(func), work = jsrt::PendingWork(*this)]() mutable {
+            static_cast<Environment&>(work.environment()).runTask(func);
+        }, priority);
+    });
 }
 
 void Environment::runInBackground(ScheduledFunction func)
 {
-    this->agent().runInBackground([func = std::move(func), selfRef = asRef()]() mutable {
-        // This should be safe as it is blocking
-        func(*selfRef);
+    schedule([&] {
+        this->agent().runInBackground([func = std::move(func), work = jsrt::PendingWork(*this)]() mutable {
+            static_cast<Environment&>(work.environment()).runTask(func);
+        });
     });
 }
 
 void Environment::runAfter(ScheduledFunction func, std::chrono::milliseconds delay)
 {
-    this->agent().runAfter([func = std::move(func), selfRef = asRef()]() mutable {
-        // This should be safe as it is blocking
-        func(*selfRef);
-    }, delay);
+    schedule([&] {
+        this->agent().runAfter([func = std::move(func), work = jsrt::PendingWork(*this)]() mutable {
+            static_cast<Environment&>(work.environment()).runTask(func);
+        }, delay);
+    });
+}
+
+void Environment::beginPendingWork() noexcept
+{
+    RefCounted<Environment>::retain();
+    _pendingWork.fetch_add(1);
+}
+
+void Environment::endPendingWork() noexcept
+{
+    if (_pendingWork.fetch_sub(1) == 1) {
+        std::scoped_lock lock { _idleMutex };
+        _idle.notify_all();
+    }
+    RefCounted<Environment>::release();
+}
+
+void Environment::waitUntilIdle()
+{
+    assert(!_agent.isInAgentThread() && "Environment cannot wait for its own tasks");
+    std::unique_lock lock { _idleMutex };
+    _idle.wait(lock, [this] { return _pendingWork.load() == 0; });
+}
+
+void Environment::close() noexcept
+{
+    _closed.store(true);
+    while (_scheduling.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void Environment::reportError(const folly::exception_wrapper& error) noexcept
+{
+    const auto* jsError = error.get_exception<jsi::JSError>();
+    auto message = jsError != nullptr ? jsError->getStack() : error.what().toStdString();
+    try {
+        fmt::print(stderr, "Uncaught error in environment '{}': {}\n", _name, message);
+    }
+    catch (...) {
+        // Standard error is gone, there is nowhere else to report to
+    }
+}
+
+auto Environment::awaitPromise(const jsi::Value& value) -> folly::SemiFuture<jsi::Value>
+{
+    auto future = jsrt::conv::fromJS<folly::SemiFuture<jsi::Value>>(value, *this);
+
+    // Promise may be settled already, in which case handlers run in the next microtask checkpoint
+    if (_options.microtaskQueue()) {
+        runLater([](jsrt::Environment&) {});
+    }
+
+    return future;
+}
+
+void Environment::runTask(ScheduledFunction& func)
+{
+    try {
+        func(*this);
+    }
+    catch (...) {
+        reportError(folly::exception_wrapper(std::current_exception()));
+    }
+    if (_options.microtaskQueue()) {
+        _jsRuntime->drainMicrotasks();
+    }
+}
+
+auto Environment::evaluateScript(const std::string& script, const std::string& name) & -> jsi::Value
+{
+    if (_snapshotRecorder) {
+        _snapshotRecorder->addScript(name, script);
+    }
+
+    return jsrt::Environment::evaluateScript(script, name);
+}
+
+auto Environment::evaluateFile(const std::string& path) & -> jsi::Value
+{
+    auto loadedPath = path;
+    if (_options.sourcePreference() == SourcePreference::PreferBytecode) {
+        auto bytecodePath = boost::filesystem::path(path).replace_extension(".hbc");
+        if (bytecodePath.string() != path && boost::filesystem::exists(bytecodePath)) {
+            loadedPath = bytecodePath.string();
+        }
+    }
+
+    auto buffer = MappedFileBuffer::load(loadedPath);
+    if (_snapshotRecorder) {
+        _snapshotRecorder->addScript(path, std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()));
+    }
+
+    return _jsRuntime->evaluateJavaScript(buffer, path);
+}
+
+void Environment::startRecordingSnapshot()
+{
+    _snapshotRecorder.emplace();
+}
+
+auto Environment::finishRecordingSnapshot() -> EnvironmentSnapshot::Ptr
+{
+    assert(_snapshotRecorder.has_value());
+    auto snapshot = _snapshotRecorder->build();
+    _snapshotRecorder.reset();
+    return snapshot;
+}
+
+auto Environment::objectForType(std::type_index type, const std::function<jsi::Object(Environment&)>& factory)
+    -> const jsi::Object&
+{
+    if (auto it = _typeBoundObjects.find(type); it != _typeBoundObjects.end()) {
+        return it->second;
+    }
+
+    // Factory may recursively request other objects, so we cannot hold an iterator across it
+    auto object = factory(*this);
+    return _typeBoundObjects.emplace(type, std::move(object)).first->second;
+}
+
+auto Environment::heapMetrics() -> HeapMetrics
+{
+    auto info = _jsRuntime->instrumentation().getHeapInfo(false);
+    auto get = [&info](const char* key) -> uint64_t {
+        auto it = info.find(key);
+        return it != info.end() ? static_cast<uint64_t>(it->second) : 0;
+    };
+
+    HeapMetrics metrics {
+        .heapSize = get("hermes_heapSize"),
+        .allocatedBytes = get("hermes_allocatedBytes"),
+        .totalAllocatedBytes = get("hermes_totalAllocatedBytes"),
+        .externalBytes = get("hermes_externalBytes"),
+        .numCollections = get("hermes_numCollections"),
+    };
+    _gcTimer.fill(metrics);
+
+    return metrics;
+}
+
+void Environment::collectGarbage(const std::string& cause)
+{
+    _jsRuntime->instrumentation().collectGarbage(cause);
+}
+
+void Environment::writeHeapSnapshot(const std::string& path)
+{
+    _jsRuntime->instrumentation().createSnapshotToFile(path);
+}
+
+void Environment::startSamplingProfiler(double meanHzFrequency)
+{
+    if (!_registeredForProfiling) {
+        _jsRuntime->registerForProfiling();
+        _registeredForProfiling = true;
+    }
+
+    std::scoped_lock lock { samplingProfilerMutex };
+    if (samplingProfilerUsers++ == 0) {
+        HermesRuntime::enableSamplingProfiler(meanHzFrequency);
+    }
+}
+
+void Environment::stopSamplingProfiler()
+{
+    std::scoped_lock lock { samplingProfilerMutex };
+    assert(samplingProfilerUsers > 0);
+    if (--samplingProfilerUsers == 0) {
+        HermesRuntime::disableSamplingProfiler();
+    }
+}
+
+void Environment::writeCpuProfile(std::ostream& out)
+{
+    _jsRuntime->sampledTraceToStreamInDevToolsFormat(out);
+}
+
+void Environment::writeChromeTrace(std::ostream& out)
+{
+    std::stringstream hermesTrace;
+    HermesRuntime::dumpSampledTraceToStream(hermesTrace);
+
+    auto trace = folly::parseJson(hermesTrace.str());
+    if (!trace.count("traceEvents")) {
+        trace["traceEvents"] = folly::dynamic::array();
+    }
+
+    auto& traceEvents = trace["traceEvents"];
+    for (auto& event : _host.taskTracer().toTraceEvents()) {
+        traceEvents.push_back(std::move(event));
+    }
+
+    out << folly::toJson(trace);
 }
 
 }
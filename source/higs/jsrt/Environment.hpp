@@ -4,15 +4,31 @@
 //
 
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <typeindex>
 #include <unordered_map>
 
+#include <folly/ExceptionWrapper.h>
+#include <folly/coro/Task.h>
 #include <folly/executors/ExecutorWithPriority.h>
+#include <folly/futures/Future.h>
 #include <hermes/hermes.h>
 #include <higs/common.hpp>
 #include <higs/jsrt/Agent.hpp>
+#include <higs/jsrt/EnvironmentSnapshot.hpp>
+#include <higs/jsrt/HeapMetrics.hpp>
 #include <higs/jsrt/RefCounted.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
 #include <higs/utility/NonCopyable.hpp>
+#include <jsrt/conv.hpp>
 #include <jsrt/jsrt.hpp>
 
 namespace higs {
@@ -27,13 +43,13 @@ class Agent;
  */
 class Environment final: public jsrt::Environment, public RefCounted<Environment> {
 protected:
-    Environment(Runtime& host, Agent& agent, const std::string& name) noexcept;
+    Environment(Runtime& host, Agent& agent, const std::string& name, const EnvironmentOptions& options) noexcept;
 public:
     HIGS_MAKE_NON_COPYABLE(Environment);
 
-    using ScheduledFunction = std::function<void(jsrt::Environment&)>;
+    using ScheduledFunction = jsrt::ScheduledJSFunction;
 
-    ~Environment() noexcept = default;
+    ~Environment() noexcept;
 
     [[nodiscard]]
     auto name() const noexcept -> const std::string& override
@@ -46,20 +62,347 @@ public:
         return _agent;
     }
 
+    /**
+     * Gets event base of this environment's agent, see `Agent::getEventBase`.
+     *
+     * Its callbacks run outside of tasks, JS is called from them using `runLater`.
+     */
+    [[nodiscard]]
+    auto eventBase() noexcept -> folly::EventBase&;
+
+    /**
+     * Gets runtime owning this environment.
+     */
+    [[nodiscard]]
+    auto host() noexcept -> Runtime&
+    {
+        return _host;
+    }
+
+    [[nodiscard]]
+    auto options() const noexcept -> const EnvironmentOptions&
+    {
+        return _options;
+    }
+
     auto jsVirtualMachine() noexcept -> jsi::Runtime& override
     {
         return *_jsRuntime;
     }
 // --
+    /**
+     * Runs `func` on this environment's agent, and blocks until it finishes.
+     *
+     * Exceptions thrown by `func` are rethrown to the caller. See `call`.
+     */
     void runNowBlocking(ScheduledFunction func) override;
+
+    /**
+     * Runs `func` with this environment on its agent synchronously, and returns its result.
+     *
+     * Runs inline when called from the agent's thread. Lets native code synchronously query JS:
+     *
+     * @code{.cpp}
+     * auto title = env.call([](Environment& env) {
+     *     return env.evaluateScript("document.title").asString(env).utf8(env);
+     * });
+     * @endcode
+     *
+     * @param func Function to run
+     * @return Result of `func`
+     * @throws Exception thrown by `func`
+     */
+    template<typename F>
+    auto call(F&& func) -> std::invoke_result_t<F&, Environment&>
+    {
+        return _agent.call([this, &func]() -> std::invoke_result_t<F&, Environment&> { return func(*this); });
+    }
+
+    /**
+     * Schedules `func` on this environment's agent.
+     *
+     * Like all tasks of an environment, `func` is followed by a microtask checkpoint: when the microtask
+     * queue is enabled, promise jobs queued by `func` run before the next task.
+     */
     void runLater(ScheduledFunction func) override;
     void runWithPriority(ScheduledFunction func, int32_t priority) override;
     void runInBackground(ScheduledFunction func) override;
     void runAfter(ScheduledFunction function, std::chrono::milliseconds delay) override;
 
+    /**
+     * Retains this environment, and counts work as pending, until matching `endPendingWork`.
+     *
+     * See `jsrt::PendingWork`. Every scheduled task, timers included, holds one until it has run.
+     */
+    void beginPendingWork() noexcept override;
+    void endPendingWork() noexcept override;
+
+    /**
+     * Blocks until no work is pending: no task is scheduled, and no native operation awaited by JS (e.g. a read,
+     * or a task running on the background executor) is in flight.
+     *
+     * Lets the owner of an environment wait for asynchronous work started by scripts, before destroying it.
+     * Servers listening for connections do not count. Must not be called on this environment's agent thread.
+     */
+    void waitUntilIdle();
+
+    /**
+     * Stops accepting tasks, those scheduled afterward are dropped.
+     *
+     * Called by the runtime before it stops this environment's agent, as work still pending (e.g. a read
+     * completing later) would otherwise schedule on a stopped agent. Blocks until tasks being scheduled
+     * concurrently are queued.
+     */
+    void close() noexcept;
+
+    /**
+     * Reports error that nothing else handles, e.g. thrown by a pooled task or by a JS callback called from
+     * native code, by writing it (its stack for JS errors) to standard error along with the environment's name.
+     */
+    void reportError(const folly::exception_wrapper& error) noexcept;
+
+// -- Coroutines
+    /**
+     * Awaitable moving the awaiting coroutine onto this environment's thread, see `schedule`.
+     */
+    class ScheduleAwaitable {
+      public:
+        explicit ScheduleAwaitable(Environment& env) noexcept: _env(env) {}
+
+        auto await_ready() const noexcept -> bool
+        {
+            return _env._agent.isInAgentThread();
+        }
+
+        void await_suspend(std::coroutine_handle<> continuation)
+        {
+            _env.runLater([continuation](jsrt::Environment&) { continuation.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+        /**
+         * `folly::coro::Task` resumes its awaiters on the task's executor, which would hop straight back.
+         */
+        friend auto co_viaIfAsync(folly::Executor::KeepAlive<>, ScheduleAwaitable awaitable) noexcept -> ScheduleAwaitable
+        {
+            return awaitable;
+        }
+
+      private:
+        Environment& _env;
+    };
+
+    /**
+     * Gets executor running tasks on this environment's agent.
+     *
+     * Keep-alive tokens hold the agent, not the environment.
+     */
+    [[nodiscard]]
+    auto executor() noexcept -> folly::Executor::KeepAlive<folly::SequencedExecutor>
+    {
+        return folly::getKeepAliveToken(_agent);
+    }
+
+    /**
+     * Moves the awaiting coroutine onto this environment's thread.
+     *
+     * Code following `co_await env.schedule()` runs on the environment's thread. A `folly::coro::Task` keeps
+     * its own executor though, and resumes on it after its next suspension. Tasks that should run on this
+     * environment as a whole are better started on it, see `callAsync`:
+     *
+     * @code{.cpp}
+     * auto source = co_await loadSource(provider, runtime, path, request);
+     * co_await env.schedule();
+     * env.evaluateScript(source, path);
+     * @endcode
+     */
+    [[nodiscard]]
+    auto schedule() noexcept -> ScheduleAwaitable
+    {
+        return ScheduleAwaitable { *this };
+    }
+
+    /**
+     * Runs `func` with this environment on its agent, and resumes the awaiting task with its result.
+     *
+     * Unlike `call`, no thread is blocked meanwhile. Result is returned across threads, so it must not
+     * hold JS values. Coroutines are started on this environment using `scheduleOn(env.executor())` instead.
+     *
+     * @param func Function to run
+     * @return Task resulting in result of `func`
+     */
+    template<typename F>
+    auto callAsync(F func) -> folly::coro::Task<std::invoke_result_t<F&, Environment&>>
+    {
+        auto onAgent = [](Environment& env, F func) -> folly::coro::Task<std::invoke_result_t<F&, Environment&>> {
+            co_return func(env);
+        };
+        co_return co_await onAgent(*this, std::move(func)).scheduleOn(executor());
+    }
+
+    /**
+     * Evaluates `script` on this environment's thread, and awaits its completion value.
+     *
+     * When the completion value is a promise (or another thenable), it is awaited as well, which makes
+     * async functions and top-level promise chains awaitable from native code:
+     *
+     * @code{.cpp}
+     * auto status = co_await env.evaluateAsync<int>("fetchStatus()", "status.js");
+     * @endcode
+     *
+     * Result is converted using `jsrt::conv::fromJS` before leaving the environment's thread, so `T` must not
+     * hold JS values.
+     *
+     * @tparam T Native type of the result, `void` discards it
+     * @param script Source code to evaluate
+     * @param name Name of the script
+     * @throws jsi::JSError When evaluation throws, or the promise is rejected
+     */
+    template<typename T = void>
+    auto evaluateAsync(std::string script, std::string name = "<async>") -> folly::coro::Task<T>
+    {
+        auto onAgent = [](Environment& env, std::string script, std::string name) -> folly::coro::Task<T> {
+            [[maybe_unused]] auto result = co_await env.awaitPromise(env.evaluateScript(script, name));
+            if constexpr (!std::is_void_v<T>) {
+                co_return jsrt::conv::fromJS<T>(result, env);
+            }
+        };
+        co_return co_await onAgent(*this, std::move(script), std::move(name)).scheduleOn(executor());
+    }
+
+    /**
+     * Awaits settlement of a JS promise.
+     *
+     * Same as `jsrt::conv::fromJS<folly::SemiFuture<jsi::Value>>`, followed by a microtask checkpoint, so that
+     * handlers of an already settled promise run even when called outside of an environment task.
+     *
+     * Must be called on this environment's thread, and the future must be consumed on it, as it holds a JS value.
+     * Awaiting it from a task running on `executor()` does so.
+     *
+     * @param value Promise to await
+     * @return Future resulting in the promise's value
+     */
+    auto awaitPromise(const jsi::Value& value) -> folly::SemiFuture<jsi::Value>;
+
+    using jsrt::Environment::evaluateScript;
+
+    auto evaluateScript(const std::string& script, const std::string& name) & -> jsi::Value override;
+
+    /**
+     * Evaluates script file at `path`.
+     *
+     * File is memory mapped rather than read. When `options().sourcePreference()` prefers bytecode and a file
+     * with the same name and `.hbc` extension exists next to it, the precompiled bytecode is evaluated instead.
+     *
+     * @param path Path to the script
+     * @return Completion value of the script
+     */
+    auto evaluateFile(const std::string& path) & -> jsi::Value;
+
+// -- Snapshots
+    /**
+     * Starts recording scripts evaluated by this environment, so that they can be replayed in other
+     * environments using a snapshot.
+     */
+    void startRecordingSnapshot();
+
+    /**
+     * Stops recording and returns snapshot of scripts evaluated since `startRecordingSnapshot`.
+     */
+    [[nodiscard]]
+    auto finishRecordingSnapshot() -> EnvironmentSnapshot::Ptr;
+
+    /**
+     * Gets JS object bound to native type `type` within this environment.
+     *
+     * Object is created using `factory` on first use, and reused afterward. Used to share
+     * prototypes of native classes between all of their instances.
+     *
+     * Must be called on this environment's thread.
+     *
+     * @param type Native type key
+     * @param factory Creates the object if not yet present
+     * @return Cached object
+     */
+    auto objectForType(std::type_index type, const std::function<jsi::Object(Environment&)>& factory)
+        -> const jsi::Object&;
+
+// -- Instrumentation
+    /**
+     * Collects JS heap and GC statistics of this environment.
+     *
+     * Must be called on this environment's thread.
+     *
+     * @return Current heap metrics
+     */
+    [[nodiscard]]
+    auto heapMetrics() -> HeapMetrics;
+
+    /**
+     * Forces full garbage collection.
+     *
+     * @param cause Reason reported to GC statistics
+     */
+    void collectGarbage(const std::string& cause = "higs");
+
+    /**
+     * Writes heap snapshot, readable by Chrome DevTools, into file at `path`.
+     */
+    void writeHeapSnapshot(const std::string& path);
+
+// -- Profiling
+    /**
+     * Starts sampling JS stacks of this environment.
+     *
+     * Hermes sampling profiler is process-wide: this registers environment's JS runtime for sampling and
+     * enables the profiler if no other environment did. Must be called on this environment's thread.
+     *
+     * @param meanHzFrequency Mean sampling frequency
+     */
+    void startSamplingProfiler(double meanHzFrequency = 100);
+
+    /**
+     * Stops sampling JS stacks of this environment.
+     *
+     * Collected samples are kept, and can be written using `writeCpuProfile` or `writeChromeTrace`.
+     */
+    void stopSamplingProfiler();
+
+    /**
+     * Writes samples collected for this environment as DevTools `.cpuprofile`.
+     */
+    void writeCpuProfile(std::ostream& out);
+
+    /**
+     * Writes samples collected by sampling profiler in Chrome trace format.
+     *
+     * Task spans recorded by the runtime's `TaskTracer` are merged into the same trace.
+     */
+    void writeChromeTrace(std::ostream& out);
+
 private:
+    /**
+     * Runs task `func`, followed by a microtask checkpoint.
+     *
+     * Exception thrown by `func` is reported, and the checkpoint still runs.
+     */
+    void runTask(ScheduledFunction& func);
+
+    /**
+     * Calls `enqueue` to queue a task on the agent, unless this environment is closed.
+     */
+    template<typename F>
+    void schedule(F&& enqueue);
+
     Runtime& _host;
     std::string _name;
+    EnvironmentOptions _options;
+
+    /**
+     * Must outlive `_jsRuntime`, whose GC reports to it.
+     */
+    GCTimer _gcTimer;
     std::unique_ptr<HermesRuntime> _jsRuntime;
 
     Agent& _agent;
@@ -72,6 +415,28 @@ private:
      */
     Synchronized<std::unordered_map<String, jsi::Object>> _importInstanceMap;
 
+    /**
+     * Objects bound to native types, see `objectForType`.
+     */
+    std::unordered_map<std::type_index, jsi::Object> _typeBoundObjects;
+
+    bool _registeredForProfiling = false;
+
+    /**
+     * Set by `close`, and number of threads scheduling a task meanwhile, which `close` waits for.
+     */
+    std::atomic<bool> _closed = false;
+    std::atomic<size_t> _scheduling = 0;
+
+    /**
+     * Number of pending work tokens, see `waitUntilIdle`.
+     */
+    std::atomic<size_t> _pendingWork = 0;
+    std::mutex _idleMutex;
+    std::condition_variable _idle;
+
+    std::optional<EnvironmentSnapshot::Builder> _snapshotRecorder;
+
     friend class higs::RefCounted<Environment>;
 };
 
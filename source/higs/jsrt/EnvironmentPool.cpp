@@ -0,0 +1,137 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "EnvironmentPool.hpp"
+
+#include <fmt/format.h>
+#include <folly/ScopeGuard.h>
+#include <folly/executors/InlineExecutor.h>
+#include "Runtime.hpp"
+
+namespace higs {
+
+EnvironmentPool::EnvironmentPool(
+    Runtime& host,
+    size_t size,
+    const EnvironmentOptions& options,
+    EnvironmentSnapshot::Ptr bootstrap,
+    DispatchStrategy strategy
+)
+    : _host(host), _inFlight(std::make_unique<std::atomic<size_t>[]>(size)), _strategy(strategy)
+{
+    assert(size > 0);
+    _envs.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        auto name = fmt::format("pool-{}", i);
+        auto& env = bootstrap ? host.createEnvironment(name, options, *bootstrap) : host.createEnvironment(name, options);
+        _envs.push_back(&env);
+    }
+}
+
+EnvironmentPool::~EnvironmentPool() noexcept
+{
+    wait();
+    for (auto* env : _envs) {
+        _host.destroyEnvironment(*env);
+    }
+}
+
+auto EnvironmentPool::run(ScheduledFunction func) -> size_t
+{
+    auto index = pick();
+    runOn(index, std::move(func));
+    return index;
+}
+
+auto EnvironmentPool::runAsync(AsyncFunction func) -> size_t
+{
+    auto index = pick();
+    started(index);
+
+    _envs[index]->runLater([this, index, func = std::move(func)](jsrt::Environment& env) {
+        auto done = folly::makeSemiFuture();
+        try {
+            done = func(env);
+        }
+        catch (...) {
+            _envs[index]->reportError(folly::exception_wrapper(std::current_exception()));
+        }
+
+        std::move(done)
+            .via(&folly::InlineExecutor::instance())
+            .thenTry([this, index](folly::Try<folly::Unit>&& result) {
+                if (result.hasException()) {
+                    _envs[index]->reportError(result.exception());
+                }
+                finished(index);
+            });
+    });
+    return index;
+}
+
+void EnvironmentPool::runOn(size_t index, ScheduledFunction func)
+{
+    started(index);
+
+    _envs[index]->runLater([this, index, func = std::move(func)](jsrt::Environment& env) {
+        SCOPE_EXIT
+        {
+            finished(index);
+        };
+
+        try {
+            func(env);
+        }
+        catch (...) {
+            _envs[index]->reportError(folly::exception_wrapper(std::current_exception()));
+        }
+    });
+}
+
+void EnvironmentPool::wait()
+{
+    std::unique_lock lock { _pendingMutex };
+    _idle.wait(lock, [this] { return _pending == 0; });
+}
+
+auto EnvironmentPool::pick() noexcept -> size_t
+{
+    if (_strategy == DispatchStrategy::RoundRobin) {
+        return _nextIndex.fetch_add(1, std::memory_order_relaxed) % _envs.size();
+    }
+
+    // Start scanning at a rotating offset, so that ties are not always resolved in favour of the first environment
+    auto start = _nextIndex.fetch_add(1, std::memory_order_relaxed);
+    auto best = start % _envs.size();
+    for (size_t i = 1; i < _envs.size(); ++i) {
+        auto candidate = (start + i) % _envs.size();
+        if (load(candidate) < load(best)) {
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+void EnvironmentPool::started(size_t index) noexcept
+{
+    {
+        std::scoped_lock lock { _pendingMutex };
+        ++_pending;
+    }
+    _inFlight[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void EnvironmentPool::finished(size_t index) noexcept
+{
+    _inFlight[index].fetch_sub(1, std::memory_order_relaxed);
+
+    std::scoped_lock lock { _pendingMutex };
+    if (--_pending == 0) {
+        _idle.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,145 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/futures/Future.h>
+#include <higs/jsrt/Environment.hpp>
+#include <higs/jsrt/EnvironmentSnapshot.hpp>
+#include <higs/jsrt/RefCounted.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
+
+namespace higs {
+
+class Runtime;
+
+/**
+ * Determines which environment of a pool runs the next task.
+ */
+enum class DispatchStrategy {
+    /**
+     * Environments take turns.
+     */
+    RoundRobin,
+
+    /**
+     * Environment with the fewest unfinished tasks is picked.
+     */
+    LeastLoaded,
+};
+
+/**
+ * Fixed set of environments, each running on its own agent, that tasks are dispatched to.
+ *
+ * Lets many small, independent workloads (scripts, requests) run in parallel within a single process,
+ * paying environment startup only once per pool member. Tasks dispatched to the same environment share
+ * its global state.
+ */
+class EnvironmentPool final : public RefCounted<EnvironmentPool> {
+protected:
+    /**
+     * @param host Runtime owning pooled environments
+     * @param size Number of environments
+     * @param options Options of every environment
+     * @param bootstrap Optional snapshot every environment is restored from
+     * @param strategy How tasks are distributed
+     */
+    EnvironmentPool(
+        Runtime& host,
+        size_t size,
+        const EnvironmentOptions& options,
+        EnvironmentSnapshot::Ptr bootstrap = nullptr,
+        DispatchStrategy strategy = DispatchStrategy::LeastLoaded
+    );
+
+    /**
+     * Waits for all dispatched tasks, and destroys pooled environments.
+     */
+    ~EnvironmentPool() noexcept;
+
+public:
+    HIGS_MAKE_NON_COPYABLE(EnvironmentPool);
+
+    using ScheduledFunction = Environment::ScheduledFunction;
+
+    /**
+     * Task that finishes once the future it returns completes, e.g. once a promise of JS it runs settles.
+     */
+    using AsyncFunction = jsrt::UniqueFunction<folly::SemiFuture<folly::Unit>(jsrt::Environment&), 64>;
+
+    [[nodiscard]]
+    auto size() const noexcept -> size_t
+    {
+        return _envs.size();
+    }
+
+    [[nodiscard]]
+    auto environment(size_t index) noexcept -> Environment&
+    {
+        return *_envs[index];
+    }
+
+    /**
+     * Number of tasks dispatched to environment at `index`, that have not finished yet.
+     */
+    [[nodiscard]]
+    auto load(size_t index) const noexcept -> size_t
+    {
+        return _inFlight[index].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Runs `func` on one of pooled environments, picked according to dispatch strategy.
+     *
+     * `func` should handle its own errors, exceptions escaping it are reported by `Environment::reportError`.
+     *
+     * @return Index of environment that runs the task
+     */
+    auto run(ScheduledFunction func) -> size_t;
+
+    /**
+     * Same as `run`, but the task counts as unfinished (for `load`, `wait` and picking environments) until the
+     * future returned by `func` completes, rather than until `func` returns. A failed future is reported like
+     * an exception escaping `func`.
+     *
+     * @return Index of environment that runs the task
+     */
+    auto runAsync(AsyncFunction func) -> size_t;
+
+    /**
+     * Runs `func` on environment at `index`.
+     */
+    void runOn(size_t index, ScheduledFunction func);
+
+    /**
+     * Blocks until every task dispatched so far has finished.
+     */
+    void wait();
+
+private:
+    auto pick() noexcept -> size_t;
+    void started(size_t index) noexcept;
+    void finished(size_t index) noexcept;
+
+    Runtime& _host;
+    std::vector<Environment*> _envs;
+    std::unique_ptr<std::atomic<size_t>[]> _inFlight;
+    DispatchStrategy _strategy;
+    std::atomic<size_t> _nextIndex = 0;
+
+    std::mutex _pendingMutex;
+    std::condition_variable _idle;
+    size_t _pending = 0;
+
+    friend class higs::RefCounted<EnvironmentPool>;
+};
+
+}
@@ -0,0 +1,277 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "EnvironmentSnapshot.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#include <fmt/format.h>
+#include <hermes/hermes.h>
+#include "Environment.hpp"
+
+namespace higs {
+
+namespace {
+
+constexpr std::array<char, 8> snapshotMagic = { 'H', 'I', 'G', 'S', 'S', 'N', 'A', 'P' };
+constexpr uint32_t snapshotFormatVersion = 1;
+
+auto isBytecode(const std::string& code) -> bool
+{
+    return HermesRuntime::isHermesBytecode(reinterpret_cast<const uint8_t*>(code.data()), code.size());
+}
+
+template<typename T>
+void writePod(std::ostream& out, T value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString(std::ostream& out, const std::string& value)
+{
+    writePod<uint64_t>(out, value.size());
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+template<typename T>
+auto readPod(std::istream& in, T& value) -> bool
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/**
+ * Gets number of bytes between current position and end of `in`, or 0 when it cannot seek.
+ */
+auto remainingBytes(std::istream& in) -> uint64_t
+{
+    auto position = in.tellg();
+    if (position == std::streampos(-1) || !in.seekg(0, std::ios::end)) {
+        return 0;
+    }
+    std::streamoff remaining = in.tellg() - position;
+    in.seekg(position);
+    return remaining > 0 ? static_cast<uint64_t>(remaining) : 0;
+}
+
+auto readString(std::istream& in, std::string& value) -> bool
+{
+    uint64_t size = 0;
+    if (!readPod(in, size)) {
+        return false;
+    }
+
+    // Size of a malformed (e.g. truncated) snapshot must not be allocated before reading fails
+    if (size > remainingBytes(in)) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(value.data(), static_cast<std::streamsize>(size)));
+}
+
+/**
+ * Defines `name` on global object using `Object.defineProperty`.
+ */
+void defineGlobal(jsi::Runtime& runtime, const std::string& name, const jsi::Object& descriptor)
+{
+    auto global = runtime.global();
+    auto defineProperty = global.getPropertyAsObject(runtime, "Object").getPropertyAsFunction(runtime, "defineProperty");
+    defineProperty.call(runtime, global, jsi::String::createFromUtf8(runtime, name), descriptor);
+}
+
+}
+
+struct EnvironmentSnapshot::PreparedCache {
+    std::vector<std::shared_ptr<const jsi::PreparedJavaScript>> scripts;
+    std::vector<std::shared_ptr<const jsi::PreparedJavaScript>> initializers;
+};
+
+auto EnvironmentSnapshot::Builder::addScript(std::string name, std::string code) -> Builder&
+{
+    auto bytecode = isBytecode(code);
+    _scripts.push_back({ std::move(name), std::move(code), bytecode });
+    return *this;
+}
+
+auto EnvironmentSnapshot::Builder::addLazyGlobal(std::string name, std::string initializer) -> Builder&
+{
+    _lazyGlobals.push_back({ std::move(name), std::move(initializer) });
+    return *this;
+}
+
+auto EnvironmentSnapshot::Builder::build() -> Ptr
+{
+    return EnvironmentSnapshot::create(std::move(_scripts), std::move(_lazyGlobals));
+}
+
+EnvironmentSnapshot::EnvironmentSnapshot(std::vector<Script> scripts, std::vector<LazyGlobal> lazyGlobals) noexcept
+    : _scripts(std::move(scripts)), _lazyGlobals(std::move(lazyGlobals))
+{
+}
+
+EnvironmentSnapshot::~EnvironmentSnapshot() noexcept = default;
+
+auto EnvironmentSnapshot::prepared(Environment& env) const -> const PreparedCache&
+{
+    if (auto cache = *_prepared.rlock()) {
+        return *cache;
+    }
+
+    // Compile outside of the lock, in the worst case two environments prepare the same scripts
+    auto& runtime = env.jsVirtualMachine();
+    auto cache = std::make_shared<PreparedCache>();
+    for (const auto& script : _scripts) {
+        cache->scripts.push_back(runtime.prepareJavaScript(std::make_shared<jsi::StringBuffer>(script.code), script.name));
+    }
+    for (const auto& global : _lazyGlobals) {
+        cache->initializers.push_back(
+            runtime.prepareJavaScript(std::make_shared<jsi::StringBuffer>(global.initializer), global.name)
+        );
+    }
+
+    auto prepared = _prepared.wlock();
+    if (*prepared == nullptr) {
+        *prepared = std::move(cache);
+    }
+
+    return **prepared;
+}
+
+void EnvironmentSnapshot::restore(Environment& env) const
+{
+    auto& runtime = env.jsVirtualMachine();
+    const auto& cache = prepared(env);
+
+    for (const auto& script : cache.scripts) {
+        runtime.evaluatePreparedJavaScript(script);
+    }
+
+    for (size_t i = 0; i < _lazyGlobals.size(); ++i) {
+        const auto& name = _lazyGlobals[i].name;
+        auto getter = jsi::Function::createFromHostFunction(
+            runtime,
+            jsi::PropNameID::forUtf8(runtime, name),
+            0,
+            [name, initializer = cache.initializers[i]](jsi::Runtime& rt, const jsi::Value&, const jsi::Value*, size_t)
+                -> jsi::Value {
+                auto value = rt.evaluatePreparedJavaScript(initializer);
+
+                // Replace accessor with plain data property, so that successive reads are regular property lookups
+                jsi::Object descriptor { rt };
+                descriptor.setProperty(rt, "value", value);
+                descriptor.setProperty(rt, "writable", true);
+                descriptor.setProperty(rt, "configurable", true);
+                defineGlobal(rt, name, descriptor);
+
+                return value;
+            }
+        );
+
+        jsi::Object descriptor { runtime };
+        descriptor.setProperty(runtime, "get", std::move(getter));
+        descriptor.setProperty(runtime, "configurable", true);
+        defineGlobal(runtime, name, descriptor);
+    }
+}
+
+void EnvironmentSnapshot::writeToFile(const std::string& path) const
+{
+    std::ofstream out { path, std::ios::out | std::ios::binary | std::ios::trunc };
+    out.exceptions(std::ios::failbit | std::ios::badbit);
+
+    out.write(snapshotMagic.data(), snapshotMagic.size());
+    writePod<uint32_t>(out, snapshotFormatVersion);
+    writePod<uint32_t>(out, HermesRuntime::getBytecodeVersion());
+
+    writePod<uint32_t>(out, _scripts.size());
+    for (const auto& script : _scripts) {
+        writeString(out, script.name);
+        writeString(out, script.code);
+    }
+
+    writePod<uint32_t>(out, _lazyGlobals.size());
+    for (const auto& global : _lazyGlobals) {
+        writeString(out, global.name);
+        writeString(out, global.initializer);
+    }
+}
+
+auto EnvironmentSnapshot::tryReadFromFile(const std::string& path) -> SnapshotResult<Ptr>
+{
+    std::ifstream in { path, std::ios::in | std::ios::binary };
+    if (!in) {
+        return makeUnexpected(SnapshotError { fmt::format("Could not open snapshot {}", path) });
+    }
+
+    auto malformed = [&path]() {
+        return makeUnexpected(SnapshotError { fmt::format("Snapshot {} is malformed", path) });
+    };
+
+    std::array<char, snapshotMagic.size()> magic {};
+    uint32_t formatVersion = 0;
+    uint32_t bytecodeVersion = 0;
+    if (!in.read(magic.data(), magic.size()) || magic != snapshotMagic || !readPod(in, formatVersion)
+        || !readPod(in, bytecodeVersion)) {
+        return malformed();
+    }
+
+    if (formatVersion != snapshotFormatVersion) {
+        return makeUnexpected(SnapshotError { fmt::format("Snapshot {} has unsupported version {}", path, formatVersion) });
+    }
+
+    Builder builder;
+    bool hasBytecode = false;
+
+    uint32_t scriptCount = 0;
+    if (!readPod(in, scriptCount)) {
+        return malformed();
+    }
+    for (uint32_t i = 0; i < scriptCount; ++i) {
+        std::string name;
+        std::string code;
+        if (!readString(in, name) || !readString(in, code)) {
+            return malformed();
+        }
+        hasBytecode |= isBytecode(code);
+        builder.addScript(std::move(name), std::move(code));
+    }
+
+    uint32_t globalCount = 0;
+    if (!readPod(in, globalCount)) {
+        return malformed();
+    }
+    for (uint32_t i = 0; i < globalCount; ++i) {
+        std::string name;
+        std::string initializer;
+        if (!readString(in, name) || !readString(in, initializer)) {
+            return malformed();
+        }
+        builder.addLazyGlobal(std::move(name), std::move(initializer));
+    }
+
+    if (hasBytecode && bytecodeVersion != HermesRuntime::getBytecodeVersion()) {
+        return makeUnexpected(SnapshotError { fmt::format(
+            "Snapshot {} contains bytecode version {}, expected {}",
+            path,
+            bytecodeVersion,
+            HermesRuntime::getBytecodeVersion()
+        ) });
+    }
+
+    return builder.build();
+}
+
+auto EnvironmentSnapshot::readFromFile(const std::string& path) -> Ptr
+{
+    auto result = tryReadFromFile(path);
+    if (result.hasError()) {
+        throw std::runtime_error(result.error().message);
+    }
+
+    return std::move(result).value();
+}
+
+}
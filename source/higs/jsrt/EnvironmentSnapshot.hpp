@@ -0,0 +1,135 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <higs/common.hpp>
+#include <higs/jsrt/RefCounted.hpp>
+
+namespace higs {
+
+class Environment;
+
+/**
+ * Error returned when snapshot cannot be read.
+ */
+struct SnapshotError {
+    std::string message;
+};
+
+template<typename T>
+using SnapshotResult = Expected<T, SnapshotError>;
+
+/**
+ * Serializable bootstrap state of an `Environment`.
+ *
+ * Hermes cannot serialize its heap, so instead of a heap image a snapshot stores everything that is needed
+ * to bring a fresh environment into the bootstrapped state as cheaply as possible:
+ *
+ *  - bootstrap scripts, evaluated in order when restoring. Scripts that are Hermes bytecode (produced by `hermesc`)
+ *    are evaluated without parsing or compilation. Source scripts are compiled once per process,
+ *    and the compiled form is shared by all environments restored from the same snapshot.
+ *  - lazy globals, installed as accessors on the global object. Their initializer runs on first access,
+ *    so that parts of large bundles that a given environment never touches are never initialised.
+ *
+ * Snapshot can be recorded from a live environment using `Environment::startRecordingSnapshot`, or built
+ * using `EnvironmentSnapshot::Builder`.
+ */
+class EnvironmentSnapshot final : public RefCounted<EnvironmentSnapshot> {
+public:
+    struct Script {
+        std::string name;
+        std::string code;
+        bool isBytecode = false;
+    };
+
+    struct LazyGlobal {
+        std::string name;
+
+        /**
+         * Script whose completion value becomes value of the global.
+         */
+        std::string initializer;
+    };
+
+    class Builder {
+    public:
+        /**
+         * Adds script evaluated when restoring, `code` can be either JS source or Hermes bytecode.
+         */
+        auto addScript(std::string name, std::string code) -> Builder&;
+
+        /**
+         * Adds global `name`, whose value is computed by `initializer` on first access.
+         */
+        auto addLazyGlobal(std::string name, std::string initializer) -> Builder&;
+
+        [[nodiscard]]
+        auto build() -> Ptr;
+
+    private:
+        std::vector<Script> _scripts;
+        std::vector<LazyGlobal> _lazyGlobals;
+    };
+
+protected:
+    EnvironmentSnapshot(std::vector<Script> scripts, std::vector<LazyGlobal> lazyGlobals) noexcept;
+    ~EnvironmentSnapshot() noexcept;
+
+public:
+    [[nodiscard]]
+    auto scripts() const noexcept -> const std::vector<Script>&
+    {
+        return _scripts;
+    }
+
+    [[nodiscard]]
+    auto lazyGlobals() const noexcept -> const std::vector<LazyGlobal>&
+    {
+        return _lazyGlobals;
+    }
+
+    /**
+     * Brings `env` into the state captured by this snapshot.
+     *
+     * Should be called on a freshly created environment, on its thread.
+     */
+    void restore(Environment& env) const;
+
+    /**
+     * Serializes snapshot into file at `path`.
+     */
+    void writeToFile(const std::string& path) const;
+
+    /**
+     * Reads snapshot previously written by `writeToFile`.
+     *
+     * Fails when file is malformed, or contains bytecode compiled by a different Hermes version.
+     */
+    static auto tryReadFromFile(const std::string& path) -> SnapshotResult<Ptr>;
+
+    static auto readFromFile(const std::string& path) -> Ptr;
+
+private:
+    struct PreparedCache;
+
+    auto prepared(Environment& env) const -> const PreparedCache&;
+
+    std::vector<Script> _scripts;
+    std::vector<LazyGlobal> _lazyGlobals;
+
+    /**
+     * Compiled scripts and initializers, shared between all environments restored from this snapshot.
+     */
+    mutable Synchronized<std::shared_ptr<const PreparedCache>> _prepared;
+
+    friend class higs::RefCounted<EnvironmentSnapshot>;
+};
+
+}
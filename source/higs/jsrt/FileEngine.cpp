@@ -0,0 +1,136 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "FileEngine.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <folly/executors/InlineExecutor.h>
+#include <folly/futures/Future.h>
+
+namespace higs {
+
+namespace {
+
+class ThreadPoolFileEngine final : public FileEngine {
+public:
+    explicit ThreadPoolFileEngine(folly::Executor::KeepAlive<> executor) noexcept : _executor(std::move(executor)) {}
+
+    [[nodiscard]]
+    auto name() const noexcept -> std::string_view override
+    {
+        return "thread-pool";
+    }
+
+    using FileEngine::read;
+
+    auto read(std::span<const FileReadRequest> requests) -> std::vector<folly::SemiFuture<size_t>> override
+    {
+        std::vector<folly::SemiFuture<size_t>> results;
+        results.reserve(requests.size());
+        for (const auto& request : requests) {
+            results.push_back(folly::via(_executor, [request] {
+                auto bytesRead = folly::preadFull(request.fd, request.buffer.data(), request.buffer.size(), static_cast<off_t>(request.offset));
+                if (bytesRead < 0) {
+                    folly::throwSystemError("pread");
+                }
+                return static_cast<size_t>(bytesRead);
+            }).semi());
+        }
+        return results;
+    }
+
+    auto registerBuffers(std::span<const std::span<uint8_t>>) -> bool override
+    {
+        return false;
+    }
+
+private:
+    folly::Executor::KeepAlive<> _executor;
+};
+
+}
+
+auto FileEngine::readFile(const std::string& path, size_t chunkSize)
+    -> folly::SemiFuture<std::shared_ptr<ext::NativeBuffer>>
+{
+    return folly::makeSemiFutureWith([&]() -> folly::SemiFuture<std::shared_ptr<ext::NativeBuffer>> {
+        auto fd = folly::openNoInt(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            folly::throwSystemError("open '", path, "'");
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            std::string contents;
+            auto success = folly::readFile(fd, contents);
+            folly::closeNoInt(fd);
+            if (!success) {
+                folly::throwSystemError("read '", path, "'");
+            }
+
+            auto buffer = ext::NativeBuffer::allocate(contents.size());
+            std::memcpy(buffer->data(), contents.data(), contents.size());
+            return buffer;
+        }
+
+        auto size = static_cast<size_t>(info.st_size);
+        auto buffer = ext::NativeBuffer::allocate(size);
+        std::vector<FileReadRequest> requests;
+        for (size_t offset = 0; offset < size; offset += chunkSize) {
+            requests.push_back({
+                .fd = fd,
+                .buffer = buffer->bytes().subspan(offset, std::min(chunkSize, size - offset)),
+                .offset = offset,
+            });
+        }
+
+        // Waits for every read, even after one failed, as the buffer must outlive all of them. Continuation
+        // keeps the buffer alive while reads are in flight, even if the result is dropped.
+        return folly::collectAll(read(requests))
+            .via(&folly::InlineExecutor::instance())
+            .thenValue([fd, buffer, chunkSize](std::vector<folly::Try<size_t>>&& results) {
+                folly::closeNoInt(fd);
+
+                // File may have been truncated meanwhile, its contents end at the first short read
+                size_t total = 0;
+                for (auto& result : results) {
+                    auto chunkBytes = result.value();
+                    total += chunkBytes;
+                    if (chunkBytes < chunkSize) {
+                        break;
+                    }
+                }
+                buffer->truncate(std::min(total, buffer->size()));
+                return buffer;
+            })
+            .semi();
+    });
+}
+
+auto createThreadPoolFileEngine(folly::Executor::KeepAlive<> executor) -> std::unique_ptr<FileEngine>
+{
+    return std::make_unique<ThreadPoolFileEngine>(std::move(executor));
+}
+
+auto createFileEngine(FileEngineKind kind, folly::Executor::KeepAlive<> executor, unsigned queueDepth)
+    -> std::unique_ptr<FileEngine>
+{
+    if (kind != FileEngineKind::ThreadPool) {
+        if (auto engine = createIoUringFileEngine(queueDepth)) {
+            return engine;
+        }
+    }
+
+    return createThreadPoolFileEngine(std::move(executor));
+}
+
+}
@@ -0,0 +1,114 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
+
+namespace higs {
+
+/**
+ * Single positional read submitted to a `FileEngine`.
+ */
+struct FileReadRequest {
+    int fd;
+
+    /**
+     * Memory read into, must stay valid until the read completes.
+     */
+    std::span<uint8_t> buffer;
+    uint64_t offset;
+
+    /**
+     * Index of registered buffer that `buffer` lies within, or -1.
+     */
+    int registeredBuffer = -1;
+};
+
+/**
+ * Performs positional file reads asynchronously.
+ *
+ * Requests submitted together form one batch, which engines use to save system calls. Results are numbers
+ * of bytes read, which are only short at end of file. Errors are reported as `std::system_error`. Futures have
+ * no executor, continuations run on the engine's thread unless scheduled elsewhere using `via`.
+ *
+ * Engines are thread safe, and created by `FollyExecutionPlatform` according to `RuntimeOptions::fileEngine`.
+ */
+class FileEngine {
+public:
+    virtual ~FileEngine() noexcept = default;
+
+    /**
+     * Name of the engine, for diagnostics.
+     */
+    [[nodiscard]]
+    virtual auto name() const noexcept -> std::string_view = 0;
+
+    /**
+     * Submits `requests` as one batch.
+     *
+     * @return Future of bytes read per request, in order of `requests`
+     */
+    virtual auto read(std::span<const FileReadRequest> requests) -> std::vector<folly::SemiFuture<size_t>> = 0;
+
+    /**
+     * Registers buffers with the kernel, so that reads into them skip per-request page pinning.
+     *
+     * Replaces previously registered buffers, which must not be in use by pending reads.
+     *
+     * @return Whether the engine registered the buffers, reads work either way
+     */
+    virtual auto registerBuffers(std::span<const std::span<uint8_t>> buffers) -> bool = 0;
+
+    /**
+     * Reads up to `buffer.size()` bytes at `offset`.
+     */
+    auto read(int fd, std::span<uint8_t> buffer, uint64_t offset) -> folly::SemiFuture<size_t>
+    {
+        FileReadRequest request { .fd = fd, .buffer = buffer, .offset = offset };
+        return std::move(read(std::span<const FileReadRequest>(&request, 1)).front());
+    }
+
+    /**
+     * Reads whole file at `path`.
+     *
+     * File is opened on the calling thread, and read in chunks of `chunkSize` submitted as one batch.
+     * Files of unknown size (pipes, procfs) are read on the calling thread.
+     */
+    auto readFile(const std::string& path, size_t chunkSize = kDefaultChunkSize)
+        -> folly::SemiFuture<std::shared_ptr<ext::NativeBuffer>>;
+
+    static constexpr size_t kDefaultChunkSize = 1 << 20;
+};
+
+/**
+ * Creates engine performing blocking system calls on `executor`.
+ */
+auto createThreadPoolFileEngine(folly::Executor::KeepAlive<> executor) -> std::unique_ptr<FileEngine>;
+
+/**
+ * Creates io_uring engine, or returns `nullptr` when io_uring is not supported by the build or the kernel.
+ *
+ * @param queueDepth Number of submission queue entries
+ */
+auto createIoUringFileEngine(unsigned queueDepth) -> std::unique_ptr<FileEngine>;
+
+/**
+ * Creates engine of preferred `kind`, falling back to thread pool when io_uring is unavailable.
+ */
+auto createFileEngine(FileEngineKind kind, folly::Executor::KeepAlive<> executor, unsigned queueDepth)
+    -> std::unique_ptr<FileEngine>;
+
+}
@@ -5,11 +5,12 @@
 
 #include "FileSystemSourceProvider.hpp"
 
-#include <fstream>
-#include <sstream>
 #include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <folly/FileUtil.h>
 #include <folly/executors/GlobalExecutor.h>
-#include <folly/futures/Future.h>
+#include "Runtime.hpp"
 
 namespace fs = std::filesystem;
 
@@ -17,12 +18,50 @@ namespace higs {
 
 // TODO: handle tsconf
 
-auto readRequiredFile(const std::string& resolvedPath) -> folly::Future<std::string>
+namespace {
+
+auto readRequiredFile(const std::string& resolvedPath) -> std::string
+{
+    std::string contents;
+    if (!folly::readFile(resolvedPath.c_str(), contents)) {
+        throw std::runtime_error("Could not read " + resolvedPath);
+    }
+    return contents;
+}
+
+/**
+ * Takes path by value, so that it is owned by the task rather than by the task's creator.
+ */
+auto readSource(std::string path) -> folly::coro::Task<std::string>
 {
-    std::ifstream reader { resolvedPath, std::ios::in };
-    std::stringstream buffer;
-    buffer << reader.rdbuf();
-    return buffer.str();
+    co_return readRequiredFile(path);
+}
+
+auto readSourceWithEngine(FileEngine& engine, std::string path) -> folly::coro::Task<std::string>
+{
+    auto buffer = co_await engine.readFile(path);
+    co_return std::string { reinterpret_cast<const char*>(buffer->data()), buffer->size() };
+}
+
+/**
+ * Reads file at `path` using file engine of `host`, when it is a higs runtime.
+ *
+ * File is opened on the global IO executor in either case.
+ */
+auto scheduleRead(const jsrt::Runtime& host, std::string path) -> folly::coro::TaskWithExecutor<std::string>
+{
+    if (const auto* runtime = dynamic_cast<const Runtime*>(&host)) {
+        return readSourceWithEngine(runtime->platform().getFileEngine(), std::move(path))
+            .scheduleOn(folly::getGlobalIOExecutor());
+    }
+    return readSource(std::move(path)).scheduleOn(folly::getGlobalIOExecutor());
+}
+
+auto readSourceOnIOThread(folly::coro::TaskWithExecutor<std::string> read) -> folly::coro::Task<std::string>
+{
+    co_return co_await std::move(read);
+}
+
 }
 
 auto FileSystemSourceProvider::resolve(const jsrt::Runtime& host, const jsrt::ResolveRequest& request) const -> std::string
@@ -39,15 +78,27 @@ auto FileSystemSourceProvider::getSourceFor(
     const jsrt::ResolveRequest& originalRequest
 ) const -> std::future<std::string>
 {
-    auto promise = std::promise<std::string>{};
-    auto stdFuture = promise.get_future();
-    const auto executor = folly::getGlobalIOExecutor();
-    folly::makeSemiFuture()
-        .via(executor)
-        .then([&](auto&&) { return readRequiredFile(resolvedPath); });
-        // .then([&](auto&& source) { promise.set_value(std::move(source)); });
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto stdFuture = promise->get_future();
+    scheduleRead(host, resolvedPath).start([promise](folly::Try<std::string>&& source) {
+            if (source.hasException()) {
+                promise->set_exception(source.exception().to_exception_ptr());
+            }
+            else {
+                promise->set_value(std::move(source).value());
+            }
+        });
 
     return stdFuture;
 }
 
+auto FileSystemSourceProvider::loadSource(
+    const jsrt::Runtime& host,
+    const std::string& resolvedPath,
+    const jsrt::ResolveRequest& originalRequest
+) const -> folly::coro::Task<std::string>
+{
+    return readSourceOnIOThread(scheduleRead(host, resolvedPath));
+}
+
 }
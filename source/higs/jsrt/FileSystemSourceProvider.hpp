@@ -6,12 +6,18 @@
 #pragma once
 
 #include <boost/filesystem.hpp>
+#include <higs/jsrt/AsyncSourceProvider.hpp>
 #include <higs/jsrt/RefCounted.hpp>
 #include <jsrt/jsrt.hpp>
 
 namespace higs {
 
-class FileSystemSourceProvider: public jsrt::SourceProvider, public RefCounted<FileSystemSourceProvider> {
+/**
+ * Loads sources from files, relative to the requesting script.
+ *
+ * Files are read on the global IO executor, using the file engine of the runtime when it is a higs `Runtime`.
+ */
+class FileSystemSourceProvider: public jsrt::SourceProvider, public AsyncSourceProvider, public RefCounted<FileSystemSourceProvider> {
 protected:
     FileSystemSourceProvider() noexcept: _baseDir(boost::filesystem::current_path()) {}
     FileSystemSourceProvider(const std::string& baseDir) noexcept: _baseDir(baseDir) {}
@@ -30,6 +36,12 @@ public:
         const std::string& resolvedPath,
         const jsrt::ResolveRequest& originalRequest
     ) const -> std::future<std::string> override;
+
+    auto loadSource(
+        const jsrt::Runtime& host,
+        const std::string& resolvedPath,
+        const jsrt::ResolveRequest& originalRequest
+    ) const -> folly::coro::Task<std::string> override;
 private:
     boost::filesystem::path _baseDir;
 
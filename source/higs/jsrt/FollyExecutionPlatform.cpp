@@ -4,14 +4,21 @@
 //
 #include "FollyExecutionPlatform.hpp"
 #include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
 
 
 namespace higs {
 
-FollyExecutionPlatform::FollyExecutionPlatform(size_t numThreads) noexcept
+FollyExecutionPlatform::FollyExecutionPlatform(
+    size_t numThreads,
+    size_t numIOThreads,
+    FileEngineKind fileEngine,
+    unsigned ioUringQueueDepth
+) noexcept
 {
     _threadPoolExecutor = std::move(std::make_unique<folly::CPUThreadPoolExecutor>(numThreads));
-    // _ioExecutor = std::move(std::make_unique<folly::IOExecutor>());
+    _ioExecutor = std::move(std::make_unique<folly::IOThreadPoolExecutor>(numIOThreads));
+    _fileEngine = createFileEngine(fileEngine, folly::getKeepAliveToken(*_ioExecutor), ioUringQueueDepth);
 }
 
 folly::IOExecutor& FollyExecutionPlatform::getIOExecutor() noexcept
@@ -20,10 +27,22 @@ folly::IOExecutor& FollyExecutionPlatform::getIOExecutor() noexcept
     return *_ioExecutor;
 }
 
+auto FollyExecutionPlatform::getIOEventBases() -> std::vector<folly::Executor::KeepAlive<folly::EventBase>>
+{
+    assert(_ioExecutor != nullptr);
+    return static_cast<folly::IOThreadPoolExecutor&>(*_ioExecutor).getAllEventBases();
+}
+
 folly::Executor& FollyExecutionPlatform::getBackgroundExecutor() noexcept
 {
     assert(_threadPoolExecutor != nullptr);
     return *_threadPoolExecutor;
 }
 
+FileEngine& FollyExecutionPlatform::getFileEngine() const noexcept
+{
+    assert(_fileEngine != nullptr);
+    return *_fileEngine;
+}
+
 }
@@ -6,28 +6,53 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <folly/Executor.h>
+#include <folly/executors/IOExecutor.h>
 #include <folly/executors/ThreadPoolExecutor.h>
 #include <folly/io/async/EventBase.h>
+#include <higs/jsrt/FileEngine.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
 #include <jsrt/jsrt.hpp>
 
 namespace higs {
 
 class FollyExecutionPlatform final : public jsrt::ExecutionPlatform {
   public:
-    FollyExecutionPlatform(size_t numThreads) noexcept;
+    FollyExecutionPlatform(
+        size_t numThreads,
+        size_t numIOThreads,
+        FileEngineKind fileEngine = FileEngineKind::Auto,
+        unsigned ioUringQueueDepth = 256
+    ) noexcept;
     ~FollyExecutionPlatform() noexcept override = default;
 
     [[nodiscard]]
     auto getIOExecutor() noexcept -> folly::IOExecutor&;
 
+    /**
+     * Gets event bases of all I/O threads, e.g. to spread accepted connections across them.
+     */
+    [[nodiscard]]
+    auto getIOEventBases() -> std::vector<folly::Executor::KeepAlive<folly::EventBase>>;
+
     [[nodiscard]]
     auto getBackgroundExecutor() noexcept -> folly::Executor&;
+
+    /**
+     * Gets engine performing file reads, io_uring when available and not disabled by options.
+     *
+     * Engine is thread safe, so it is usable through a const platform.
+     */
+    [[nodiscard]]
+    auto getFileEngine() const noexcept -> FileEngine&;
 private:
     std::unique_ptr<folly::EventBase> _eventBase;
     std::unique_ptr<folly::ThreadPoolExecutor> _threadPoolExecutor;
     std::unique_ptr<folly::IOExecutor> _ioExecutor;
+    // Declared after I/O executor, as thread pool engine keeps it alive
+    std::unique_ptr<FileEngine> _fileEngine;
 };
 
 }
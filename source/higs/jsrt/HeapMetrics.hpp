@@ -0,0 +1,135 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+namespace higs {
+
+/**
+ * Snapshot of JS heap and garbage collector statistics.
+ *
+ * Collected per `Environment`, and aggregated per `Runtime` (sums, except for maximums).
+ */
+struct HeapMetrics {
+    /**
+     * Size of the heap reserved by the GC.
+     */
+    uint64_t heapSize = 0;
+
+    /**
+     * Bytes currently allocated in the heap.
+     */
+    uint64_t allocatedBytes = 0;
+
+    /**
+     * Bytes allocated since the environment was created.
+     */
+    uint64_t totalAllocatedBytes = 0;
+
+    /**
+     * Native memory attributed to JS objects, e.g. via `setExternalMemoryPressure`.
+     */
+    uint64_t externalBytes = 0;
+
+    /**
+     * Number of finished garbage collections.
+     */
+    uint64_t numCollections = 0;
+
+    /**
+     * Total time JS was paused by young generation collections, which stop it for their whole duration.
+     */
+    std::chrono::microseconds totalGCPauseTime { 0 };
+
+    /**
+     * Longest single young generation collection.
+     */
+    std::chrono::microseconds maxGCPauseTime { 0 };
+
+    /**
+     * Total wall time of old generation collections.
+     *
+     * Hermes collects the old generation mostly concurrently with JS, so only a small part of this is a pause.
+     */
+    std::chrono::microseconds totalOldGenGCTime { 0 };
+
+    auto operator+=(const HeapMetrics& other) noexcept -> HeapMetrics&
+    {
+        heapSize += other.heapSize;
+        allocatedBytes += other.allocatedBytes;
+        totalAllocatedBytes += other.totalAllocatedBytes;
+        externalBytes += other.externalBytes;
+        numCollections += other.numCollections;
+        totalGCPauseTime += other.totalGCPauseTime;
+        maxGCPauseTime = std::max(maxGCPauseTime, other.maxGCPauseTime);
+        totalOldGenGCTime += other.totalOldGenGCTime;
+        return *this;
+    }
+};
+
+/**
+ * Accumulates garbage collection timings reported by GC event callbacks.
+ *
+ * Young and old generation collections are told apart by the description Hermes passes with the events, and are
+ * timed separately, as an old generation collection may run concurrently with young generation ones. Callbacks can
+ * be invoked from GC background threads, so all counters are atomic.
+ */
+class GCTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void collectionStarted(const char* description) noexcept
+    {
+        generationOf(description).startedAt.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    void collectionFinished(const char* description) noexcept
+    {
+        auto& generation = generationOf(description);
+        auto startedAt = Clock::time_point(Clock::duration(generation.startedAt.load(std::memory_order_relaxed)));
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startedAt).count();
+
+        generation.totalMicros.fetch_add(elapsed, std::memory_order_relaxed);
+        auto max = generation.maxMicros.load(std::memory_order_relaxed);
+        while (elapsed > max && !generation.maxMicros.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Fills GC timings in `metrics`.
+     */
+    void fill(HeapMetrics& metrics) const noexcept
+    {
+        metrics.totalGCPauseTime = std::chrono::microseconds(_young.totalMicros.load(std::memory_order_relaxed));
+        metrics.maxGCPauseTime = std::chrono::microseconds(_young.maxMicros.load(std::memory_order_relaxed));
+        metrics.totalOldGenGCTime = std::chrono::microseconds(_old.totalMicros.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct Generation {
+        std::atomic<Clock::rep> startedAt = 0;
+        std::atomic<int64_t> totalMicros = 0;
+        std::atomic<int64_t> maxMicros = 0;
+    };
+
+    /**
+     * Gets timings of generation collected by collection described as `description`, e.g. `"GC Young Gen"`.
+     */
+    auto generationOf(const char* description) noexcept -> Generation&
+    {
+        return description != nullptr && std::strstr(description, "Young") != nullptr ? _young : _old;
+    }
+
+    Generation _young;
+    Generation _old;
+};
+
+}
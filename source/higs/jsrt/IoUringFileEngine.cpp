@@ -0,0 +1,433 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "FileEngine.hpp"
+
+#if HIGS_HAVE_IO_URING
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <folly/FileUtil.h>
+#include <liburing.h>
+
+namespace higs {
+
+namespace {
+
+/**
+ * File engine submitting reads to a single io_uring.
+ *
+ * Submission is serialized by a mutex, a batch of requests costs one `io_uring_enter`. A dedicated thread
+ * reaps completions, and fulfills promises of completed reads.
+ *
+ * No more reads are in flight than the completion queue holds, so that completions never overflow it. Further
+ * reads wait in the engine, and are submitted as completions are reaped. When the kernel is busy, entries stay
+ * queued and the completion thread submits them after reaping.
+ *
+ * When the ring fails, reads it did not take fail with that error, and so do all reads submitted afterward.
+ */
+class IoUringFileEngine final : public FileEngine {
+public:
+    IoUringFileEngine() noexcept = default;
+
+    ~IoUringFileEngine() noexcept override
+    {
+        if (!_completionThread.joinable()) {
+            return;
+        }
+
+        // Completion thread stops once no read is pending, including parts of short reads resubmitted by it
+        _stopping.store(true);
+        wake();
+        _completionThread.join();
+
+        folly::closeNoInt(_wakeFd);
+        io_uring_queue_exit(&_ring);
+    }
+
+    /**
+     * Sets up the ring, and starts the completion thread.
+     *
+     * @return Whether the kernel supports io_uring
+     */
+    auto start(unsigned queueDepth) -> bool
+    {
+        if (io_uring_queue_init(queueDepth, &_ring, 0) < 0) {
+            return false;
+        }
+        _wakeFd = ::eventfd(0, EFD_CLOEXEC);
+        if (_wakeFd < 0) {
+            io_uring_queue_exit(&_ring);
+            return false;
+        }
+        _capacity = _ring.cq.ring_entries;
+
+        _completionThread = std::thread([this] { reapCompletions(); });
+        return true;
+    }
+
+    [[nodiscard]]
+    auto name() const noexcept -> std::string_view override
+    {
+        return "io_uring";
+    }
+
+    using FileEngine::read;
+
+    auto read(std::span<const FileReadRequest> requests) -> std::vector<folly::SemiFuture<size_t>> override
+    {
+        std::vector<folly::SemiFuture<size_t>> results;
+        results.reserve(requests.size());
+
+        std::vector<Operation*> failed;
+        int error = 0;
+        bool busy = false;
+        {
+            std::scoped_lock lock { _submitMutex };
+            for (const auto& request : requests) {
+                auto* operation = new Operation { .request = request };
+                results.push_back(operation->promise.getSemiFuture());
+                _operations.insert(operation);
+                _waiting.push_back(operation);
+            }
+            pump();
+            busy = _busy;
+            failed = takeUnsubmitted();
+            error = _error;
+        }
+        failAll(failed, error);
+        if (busy) {
+            // Only the completion thread can make room, by reaping
+            wake();
+        }
+
+        return results;
+    }
+
+    auto registerBuffers(std::span<const std::span<uint8_t>> buffers) -> bool override
+    {
+        std::vector<iovec> vectors;
+        vectors.reserve(buffers.size());
+        for (auto buffer : buffers) {
+            vectors.push_back({ .iov_base = buffer.data(), .iov_len = buffer.size() });
+        }
+
+        std::scoped_lock lock { _submitMutex };
+        if (_hasRegisteredBuffers) {
+            io_uring_unregister_buffers(&_ring);
+            _hasRegisteredBuffers = false;
+        }
+        if (vectors.empty()) {
+            return true;
+        }
+
+        _hasRegisteredBuffers = io_uring_register_buffers(&_ring, vectors.data(), static_cast<unsigned>(vectors.size())) == 0;
+        return _hasRegisteredBuffers;
+    }
+
+private:
+    struct Operation {
+        FileReadRequest request;
+        size_t transferred = 0;
+        folly::Promise<size_t> promise;
+    };
+
+    /**
+     * Prepares entries for waiting operations while the completion queue has room for them, and submits them.
+     *
+     * Must be called with submit mutex held.
+     */
+    void pump()
+    {
+        while (_error == 0 && !_waiting.empty() && _inFlight < _capacity) {
+            auto* sqe = io_uring_get_sqe(&_ring);
+            if (sqe == nullptr) {
+                if (!submit()) {
+                    return;
+                }
+                continue;
+            }
+
+            auto* operation = _waiting.front();
+            _waiting.pop_front();
+            prepareRead(sqe, operation);
+            _queued.push_back(operation);
+            ++_inFlight;
+        }
+        submit();
+    }
+
+    /**
+     * Prepares read of the part of `operation` not transferred yet into `sqe`.
+     */
+    void prepareRead(io_uring_sqe* sqe, Operation* operation)
+    {
+        const auto& request = operation->request;
+        auto buffer = request.buffer.subspan(operation->transferred);
+        auto offset = request.offset + operation->transferred;
+        if (request.registeredBuffer >= 0 && _hasRegisteredBuffers) {
+            io_uring_prep_read_fixed(sqe, request.fd, buffer.data(), static_cast<unsigned>(buffer.size()), offset, request.registeredBuffer);
+        }
+        else {
+            io_uring_prep_read(sqe, request.fd, buffer.data(), static_cast<unsigned>(buffer.size()), offset);
+        }
+        io_uring_sqe_set_data(sqe, operation);
+    }
+
+    /**
+     * Submits queued entries to the kernel, or records failure of the ring.
+     *
+     * The kernel takes entries in order, and none of them when it fails, so entries it did not take are the
+     * last ones queued. When it is busy (`EBUSY` with completions to reap, or `EAGAIN` out of resources), they
+     * stay queued until the completion thread retries. Otherwise they are never taken, as the ring is no
+     * longer entered.
+     *
+     * Must be called with submit mutex held.
+     *
+     * @return Whether all queued entries were submitted
+     */
+    auto submit() -> bool
+    {
+        _busy = false;
+        while (_error == 0) {
+            auto result = io_uring_submit(&_ring);
+            if (result >= 0) {
+                auto taken = std::min(static_cast<size_t>(result), _queued.size());
+                _queued.erase(_queued.begin(), _queued.begin() + static_cast<ptrdiff_t>(taken));
+                return true;
+            }
+            if (result == -EBUSY || result == -EAGAIN) {
+                _busy = true;
+                return false;
+            }
+            if (result != -EINTR) {
+                _error = -result;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Takes operations the ring did not take because it failed, to fail them without the mutex held.
+     *
+     * Must be called with submit mutex held.
+     */
+    auto takeUnsubmitted() -> std::vector<Operation*>
+    {
+        if (_error == 0) {
+            return {};
+        }
+        std::vector<Operation*> failed { _queued.begin(), _queued.end() };
+        failed.insert(failed.end(), _waiting.begin(), _waiting.end());
+        _queued.clear();
+        _waiting.clear();
+        for (auto* operation : failed) {
+            _operations.erase(operation);
+        }
+        return failed;
+    }
+
+    static void failAll(const std::vector<Operation*>& operations, int error)
+    {
+        for (auto* operation : operations) {
+            operation->promise.setException(std::system_error(error, std::generic_category(), "io_uring submit"));
+            delete operation;
+        }
+    }
+
+    /**
+     * Handles completion of `operation`, queueing the rest of a short read which did not reach end of file.
+     */
+    void complete(Operation* operation, int result)
+    {
+        if (result > 0 && operation->transferred + static_cast<size_t>(result) < operation->request.buffer.size()) {
+            operation->transferred += static_cast<size_t>(result);
+
+            std::scoped_lock lock { _submitMutex };
+            _waiting.push_back(operation);
+            return;
+        }
+
+        {
+            std::scoped_lock lock { _submitMutex };
+            _operations.erase(operation);
+        }
+        if (result < 0) {
+            operation->promise.setException(std::system_error(-result, std::generic_category(), "io_uring read"));
+        } else {
+            operation->promise.setValue(operation->transferred + static_cast<size_t>(result));
+        }
+        delete operation;
+    }
+
+    /**
+     * Wakes the completion thread.
+     */
+    void wake() noexcept
+    {
+        uint64_t wake = 1;
+        [[maybe_unused]] auto written = ::write(_wakeFd, &wake, sizeof(wake));
+    }
+
+    /**
+     * Waits for completions (or wake up by the destructor) by polling the ring, and handles them.
+     *
+     * After reaping, it submits reads waiting for room in the completion queue, and entries the kernel was too
+     * busy to take. While the kernel stays busy, it polls with a timeout to retry.
+     */
+    void reapCompletions()
+    {
+        std::array<pollfd, 2> fds { {
+            { .fd = _ring.ring_fd, .events = POLLIN, .revents = 0 },
+            { .fd = _wakeFd, .events = POLLIN, .revents = 0 },
+        } };
+
+        while (true) {
+            // Completions overflowed from a full queue are only flushed back to it by entering the kernel
+            if (io_uring_cq_has_overflow(&_ring)) {
+                io_uring_get_events(&_ring);
+            }
+
+            // Reap every completion available, not just the one waited for
+            io_uring_cqe* cqe = nullptr;
+            unsigned head;
+            unsigned reaped = 0;
+            io_uring_for_each_cqe(&_ring, head, cqe)
+            {
+                ++reaped;
+                complete(static_cast<Operation*>(io_uring_cqe_get_data(cqe)), cqe->res);
+            }
+            io_uring_cq_advance(&_ring, reaped);
+
+            std::vector<Operation*> failed;
+            int error = 0;
+            bool busy = false;
+            {
+                std::scoped_lock lock { _submitMutex };
+                _inFlight -= reaped;
+                pump();
+                busy = _busy;
+                failed = takeUnsubmitted();
+                error = _error;
+            }
+            failAll(failed, error);
+
+            if (_stopping.load()) {
+                std::scoped_lock lock { _submitMutex };
+                if (_operations.empty()) {
+                    return;
+                }
+            }
+
+            if (::poll(fds.data(), fds.size(), busy ? kBusyRetryMilliseconds : -1) < 0 && errno != EINTR) {
+                // Completions can no longer be waited for, so every read fails
+                std::vector<Operation*> failed;
+                int error = errno;
+                {
+                    std::scoped_lock lock { _submitMutex };
+                    _error = error;
+                    failed = { _operations.begin(), _operations.end() };
+                    _operations.clear();
+                    _queued.clear();
+                    _waiting.clear();
+                }
+                failAll(failed, error);
+                return;
+            }
+            if ((fds[1].revents & POLLIN) != 0) {
+                uint64_t wake = 0;
+                [[maybe_unused]] auto consumed = ::read(_wakeFd, &wake, sizeof(wake));
+            }
+        }
+    }
+
+    /**
+     * Interval of retrying submission while the kernel is busy.
+     */
+    static constexpr int kBusyRetryMilliseconds = 1;
+
+    io_uring _ring {};
+    std::mutex _submitMutex;
+
+    /**
+     * Operations not completed yet, guarded by the submit mutex.
+     */
+    std::unordered_set<Operation*> _operations;
+
+    /**
+     * Operations with entries queued and not taken by the kernel yet, in order, guarded by the submit mutex.
+     */
+    std::deque<Operation*> _queued;
+
+    /**
+     * Operations waiting for room in the completion queue, in order, guarded by the submit mutex.
+     */
+    std::deque<Operation*> _waiting;
+
+    /**
+     * Number of entries prepared and not reaped yet, and the most the completion queue holds, guarded by
+     * the submit mutex.
+     */
+    unsigned _inFlight = 0;
+    unsigned _capacity = 0;
+
+    /**
+     * Whether the kernel was too busy to take queued entries on last submission, guarded by the submit mutex.
+     */
+    bool _busy = false;
+    bool _hasRegisteredBuffers = false;
+
+    /**
+     * Error the ring failed with, or 0, guarded by the submit mutex.
+     */
+    int _error = 0;
+
+    /**
+     * Eventfd waking the completion thread, to stop it.
+     */
+    int _wakeFd = -1;
+    std::atomic<bool> _stopping = false;
+    std::thread _completionThread;
+};
+
+}
+
+auto createIoUringFileEngine(unsigned queueDepth) -> std::unique_ptr<FileEngine>
+{
+    auto engine = std::make_unique<IoUringFileEngine>();
+    if (!engine->start(queueDepth)) {
+        return nullptr;
+    }
+    return engine;
+}
+
+}
+
+#else
+
+namespace higs {
+
+auto createIoUringFileEngine(unsigned) -> std::unique_ptr<FileEngine>
+{
+    return nullptr;
+}
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "MappedFileBuffer.hpp"
+
+#include <unistd.h>
+
+#include <folly/FileUtil.h>
+#include <hermes/hermes.h>
+
+namespace higs {
+
+MappedFileBuffer::MappedFileBuffer(const std::string& path) : _mapping(path.c_str())
+{
+}
+
+auto MappedFileBuffer::isNullTerminated() const noexcept -> bool
+{
+    static const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size() % pageSize != 0;
+}
+
+auto MappedFileBuffer::isBytecode() const noexcept -> bool
+{
+    return HermesRuntime::isHermesBytecode(data(), size());
+}
+
+auto MappedFileBuffer::load(const std::string& path) -> std::shared_ptr<const jsi::Buffer>
+{
+    auto mapped = std::make_shared<MappedFileBuffer>(path);
+    if (mapped->isBytecode() || mapped->isNullTerminated()) {
+        return mapped;
+    }
+
+    std::string contents;
+    if (!folly::readFile(path.c_str(), contents)) {
+        throw std::runtime_error("Could not read " + path);
+    }
+    return std::make_shared<jsi::StringBuffer>(std::move(contents));
+}
+
+}
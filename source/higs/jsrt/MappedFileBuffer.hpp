@@ -0,0 +1,65 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <folly/system/MemoryMapping.h>
+#include <higs/common.hpp>
+
+namespace higs {
+
+/**
+ * `jsi::Buffer` backed by a read-only memory mapped file.
+ *
+ * Lets Hermes evaluate scripts (and especially bytecode, which is executed directly from the buffer)
+ * without copying file contents into memory.
+ */
+class MappedFileBuffer final : public jsi::Buffer {
+public:
+    explicit MappedFileBuffer(const std::string& path);
+
+    [[nodiscard]]
+    auto size() const -> size_t override
+    {
+        return _mapping.range().size();
+    }
+
+    [[nodiscard]]
+    auto data() const -> const uint8_t* override
+    {
+        return _mapping.range().data();
+    }
+
+    /**
+     * Whether mapped data is followed by a zero byte.
+     *
+     * Hermes parser requires source buffers to be null-terminated. Mappings are zero-filled up to
+     * the page boundary, so this holds unless file size is a multiple of the page size.
+     */
+    [[nodiscard]]
+    auto isNullTerminated() const noexcept -> bool;
+
+    /**
+     * Whether mapped file contains Hermes bytecode.
+     */
+    [[nodiscard]]
+    auto isBytecode() const noexcept -> bool;
+
+    /**
+     * Loads file at `path` into a buffer suitable for evaluation.
+     *
+     * Uses memory mapping whenever possible, and falls back to reading the file into memory when
+     * a source file could not be safely mapped.
+     */
+    static auto load(const std::string& path) -> std::shared_ptr<const jsi::Buffer>;
+
+private:
+    folly::MemoryMapping _mapping;
+};
+
+}
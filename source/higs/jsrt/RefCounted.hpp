@@ -6,12 +6,17 @@
 #pragma once
 
 #include <atomic>
+#include <cassert>
 #include <limits>
 #include <memory>
+#include <thread>
+#include <type_traits>
 
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
 #include <higs/utility/NonCopyable.hpp>
 #include <higs/utility/NonMoveable.hpp>
+#include <higs/utility/TypesafeTemplateOption.hpp>
+#include <higs/jsrt/WeakRefTable.hpp>
 #include <jsrt/jsrt.hpp>
 
 #include "higs/concepts.hpp"
@@ -23,37 +28,91 @@ class intrusive_ptr;
 
 namespace higs {
 
-template<typename Derived>
+template<typename T>
+class WeakRef;
+
+/**
+ * Determines whether reference count of `RefCounted` can be modified from multiple threads.
+ */
+using ThreadSafetyOption = TypesafeTemplateOption<struct ThreadSafetyOptionTag>;
+
+/**
+ * Base of intrusively reference counted objects.
+ *
+ * By default references can be retained and released from any thread, at the cost of an atomic
+ * read-modify-write per operation. Objects confined to a single thread (e.g. state owned by one agent)
+ * can opt out using `ThreadSafetyOption::disable`, which uses a plain counter instead:
+ *
+ * @code{.cpp}
+ * class Cache : public RefCounted<Cache, ThreadSafetyOption::disable> {};
+ * @endcode
+ *
+ * In debug builds, thread-confined objects assert that their count is only touched by the owner thread,
+ * which is the creating thread until `transferOwnership` is called.
+ *
+ * Objects can be observed without being kept alive using `WeakRef`. Reference count stays a single word:
+ * its top bit marks objects that ever had a weak reference, whose control block lives in `WeakRefTable`
+ * and is only consulted when such an object is destroyed.
+ *
+ * @tparam Derived Reference counted class
+ * @tparam ThreadSafety Whether reference count is atomic
+ */
+template<typename Derived, ThreadSafetyOption ThreadSafety = ThreadSafetyOption::enable>
 class RefCounted : public jsrt::RefCounted {
 public:
     using Ptr = boost::intrusive_ptr<Derived>;
     HIGS_MAKE_NON_COPYABLE(RefCounted);
     HIGS_MAKE_NON_MOVEABLE(RefCounted);
 
+    static constexpr bool IsThreadSafe = ThreadSafety.isEnabled;
+
 protected:
     RefCounted() = default;
     ~RefCounted() = default;
 
 public:
     /**
-     * Atomically increases number of references of this object.
+     * Increases number of references of this object.
+     *
+     * Atomic, unless the object is thread-confined.
      */
     void retain() const noexcept
     {
-        [[maybe_unused]] auto oldCount = _refCount.fetch_add(1, std::memory_order_relaxed);
-        assert(oldCount > 0);
-        assert(oldCount < std::numeric_limits<decltype(oldCount)>::max());
+        assertOwnerThread();
+        [[maybe_unused]] std::size_t oldCount;
+        if constexpr (IsThreadSafe) {
+            oldCount = _refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            oldCount = _refCount++;
+        }
+        assert((oldCount & kCountMask) > 0);
+        assert((oldCount & kCountMask) < kCountMask);
     }
 
     /**
-     * Atomically decreases number of references of this object.
+     * Decreases number of references of this object, and deletes it when none are left.
+     *
+     * Atomic, unless the object is thread-confined.
      */
     void release() const noexcept
     {
-        auto oldCount = _refCount.fetch_sub(1, std::memory_order_release);
-        assert(oldCount > 0);
-        if (oldCount == 1) {
-            std::atomic_thread_fence(std::memory_order_acquire);
+        assertOwnerThread();
+        std::size_t oldCount;
+        if constexpr (IsThreadSafe) {
+            oldCount = _refCount.fetch_sub(1, std::memory_order_release);
+        }
+        else {
+            oldCount = _refCount--;
+        }
+        assert((oldCount & kCountMask) > 0);
+        if ((oldCount & kCountMask) == 1) {
+            if constexpr (IsThreadSafe) {
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            if (oldCount & kWeakFlag) [[unlikely]] {
+                WeakRefTable::objectDestroyed(this);
+            }
             delete static_cast<const Derived*>(this);
         }
     }
@@ -65,7 +124,25 @@ public:
      */
     auto refCount() const noexcept -> std::size_t
     {
-        return this->_refCount.load(std::memory_order_relaxed);
+        if constexpr (IsThreadSafe) {
+            return this->_refCount.load(std::memory_order_relaxed) & kCountMask;
+        }
+        else {
+            return this->_refCount & kCountMask;
+        }
+    }
+
+    /**
+     * Makes calling thread the owner of a thread-confined object.
+     *
+     * Used when an object is created on one thread and handed over to another (e.g. to an agent) before
+     * being used there. Caller must guarantee that the previous owner no longer touches the object.
+     */
+    void transferOwnership() const noexcept requires(!IsThreadSafe)
+    {
+#ifndef NDEBUG
+        _ownerThread = std::this_thread::get_id();
+#endif
     }
 
     /**
@@ -85,9 +162,94 @@ public:
     }
 
 private:
-    mutable std::atomic<std::size_t> _refCount = 1;
+    /**
+     * Set in reference count of objects that have (or had) weak references.
+     */
+    static constexpr std::size_t kWeakFlag = std::size_t { 1 } << (std::numeric_limits<std::size_t>::digits - 1);
+    static constexpr std::size_t kCountMask = ~kWeakFlag;
+
+    /**
+     * Marks this object as weakly referenced, so that its destruction is reported to `WeakRefTable`.
+     */
+    void markWeaklyReferenced() const noexcept
+    {
+        assertOwnerThread();
+        if constexpr (IsThreadSafe) {
+            _refCount.fetch_or(kWeakFlag, std::memory_order_relaxed);
+        }
+        else {
+            _refCount |= kWeakFlag;
+        }
+    }
+
+    /**
+     * Key identifying this object in `WeakRefTable`.
+     */
+    auto weakKey() const noexcept -> const void*
+    {
+        return this;
+    }
+
+    /**
+     * Retains this object unless its last reference was already released.
+     *
+     * Called by `WeakRef::lock` while holding control block lock, which keeps the object from being
+     * deleted, but not from reaching zero references.
+     */
+    auto tryRetain() const noexcept -> bool
+    {
+        if constexpr (IsThreadSafe) {
+            auto count = _refCount.load(std::memory_order_relaxed);
+            while ((count & kCountMask) != 0) {
+                if (_refCount.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        else {
+            assertOwnerThread();
+            if ((_refCount & kCountMask) == 0) {
+                return false;
+            }
+            ++_refCount;
+            return true;
+        }
+    }
+
+    void assertOwnerThread() const noexcept
+    {
+#ifndef NDEBUG
+        if constexpr (!IsThreadSafe) {
+            assert(_ownerThread == std::this_thread::get_id() && "Thread-confined object used from another thread");
+        }
+#endif
+    }
+
+    using CounterType = std::conditional_t<IsThreadSafe, std::atomic<std::size_t>, std::size_t>;
+    mutable CounterType _refCount = 1;
+
+#ifndef NDEBUG
+    struct NoOwner {};
+    using OwnerType = std::conditional_t<IsThreadSafe, NoOwner, std::thread::id>;
+
+    static auto creatingThread() noexcept -> OwnerType
+    {
+        if constexpr (IsThreadSafe) {
+            return {};
+        }
+        else {
+            return std::this_thread::get_id();
+        }
+    }
+
+    [[no_unique_address]]
+    mutable OwnerType _ownerThread = creatingThread();
+#endif
     template <typename X>
     friend class boost::intrusive_ptr;
+    template <typename T>
+    friend class WeakRef;
     friend void intrusive_ptr_add_ref(const RefCounted* p) BOOST_SP_NOEXCEPT;
     friend void intrusive_ptr_release(const RefCounted* p) BOOST_SP_NOEXCEPT;
     template <typename T, typename... Args>
@@ -96,14 +258,14 @@ private:
 
 }
 
-template <typename DerivedT>
-inline void intrusive_ptr_add_ref(higs::RefCounted<DerivedT>* p) BOOST_SP_NOEXCEPT
+template <typename DerivedT, higs::ThreadSafetyOption ThreadSafety>
+inline void intrusive_ptr_add_ref(higs::RefCounted<DerivedT, ThreadSafety>* p) BOOST_SP_NOEXCEPT
 {
     p->retain();
 }
 
-template <typename DerivedT>
-inline void intrusive_ptr_release(higs::RefCounted<DerivedT>* p) BOOST_SP_NOEXCEPT
+template <typename DerivedT, higs::ThreadSafetyOption ThreadSafety>
+inline void intrusive_ptr_release(higs::RefCounted<DerivedT, ThreadSafety>* p) BOOST_SP_NOEXCEPT
 {
     p->release();
 }
@@ -118,8 +280,8 @@ std::shared_ptr<T> make_shared_from_refcounted(Args&&... args)
     return {instance, intrusive_ptr_release};
 }
 
-template <typename DerivedT>
-std::shared_ptr<DerivedT> make_shared(higs::RefCounted<DerivedT>* ptr) noexcept
+template <typename DerivedT, higs::ThreadSafetyOption ThreadSafety>
+std::shared_ptr<DerivedT> make_shared(higs::RefCounted<DerivedT, ThreadSafety>* ptr) noexcept
 {
     return {ptr, intrusive_ptr_release};
 }
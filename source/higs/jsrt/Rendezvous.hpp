@@ -0,0 +1,68 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+#include <folly/Try.h>
+#include <folly/synchronization/Baton.h>
+#include <folly/synchronization/WaitOptions.h>
+#include <higs/utility/NonCopyable.hpp>
+#include <higs/utility/NonMoveable.hpp>
+
+namespace higs {
+
+/**
+ * One-shot handoff of a result (or exception) from a task to a thread blocked waiting for it.
+ *
+ * Lives on the waiting thread's stack, so a synchronous call does not allocate. Waiting spins for
+ * a short while before parking the thread, since tasks queried synchronously are typically short,
+ * and a futex wakeup costs more than they do.
+ *
+ * @tparam T Result type, can be `void`
+ */
+template<typename T>
+class Rendezvous final {
+public:
+    HIGS_MAKE_NON_COPYABLE(Rendezvous);
+    HIGS_MAKE_NON_MOVEABLE(Rendezvous);
+
+    /**
+     * How long waiting thread spins before it parks.
+     */
+    static constexpr std::chrono::microseconds kSpinTime { 20 };
+
+    Rendezvous() noexcept = default;
+
+    /**
+     * Runs `func`, stores its result or exception, and wakes the waiting thread.
+     */
+    template<typename Func>
+    void fulfill(Func&& func) noexcept
+    {
+        _result = folly::makeTryWith(std::forward<Func>(func));
+        _done.post();
+    }
+
+    /**
+     * Blocks until fulfilled.
+     *
+     * @return Result of the task
+     * @throws Exception thrown by the task
+     */
+    auto wait() -> T
+    {
+        _done.wait(folly::WaitOptions().spin_max(kSpinTime));
+        return std::move(_result).value();
+    }
+
+private:
+    folly::Baton<> _done;
+    folly::Try<T> _result;
+};
+
+}
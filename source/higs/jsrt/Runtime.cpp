@@ -5,6 +5,8 @@
 
 #include "Runtime.hpp"
 
+#include <algorithm>
+
 #include <boost/filesystem.hpp>
 #include "Agent.hpp"
 #include "FileSystemSourceProvider.hpp"
@@ -13,28 +15,99 @@ namespace fs = boost::filesystem;
 
 namespace higs {
 
-Runtime::Runtime() noexcept
+Runtime::Runtime(const RuntimeOptions& options) noexcept
+    : _options(options)
 {
-    _builder = hermes::vm::RuntimeConfig::Builder()
-                   .withArrayBuffer(true)
-                   .withEnableGenerator(true)
-                   .withMicrotaskQueue(true)
-                   .withES6Class(true)
-                   .withES6Promise(true)
-                   .withES6Proxy(true)
-                   .withES6BlockScoping(true)
-                   .withIntl(false);
-
+    _platform = std::make_unique<FollyExecutionPlatform>(
+        options.backgroundThreads(),
+        options.ioThreads(),
+        options.fileEngine(),
+        options.ioUringQueueDepth()
+    );
+    _tracer = TaskTracer::create();
     _mainAgent = Agent::create();
-    _mainEnv = Environment::create(*this, *_mainAgent, "main");
+    _mainAgent->setTracer(_tracer);
+    _mainEnv = Environment::create(*this, *_mainAgent, "main", options.defaultEnvironmentOptions());
     // auto provider = FileSystemSourceProvider::create(fs::current_path());
     // _sourceProviders.push_back(boost::dynamic_pointer_cast<jsrt::SourceProvider>(provider));
 }
 
-// auto Runtime::createEnvironment(const std::string& name) & noexcept -> Environment&
-// {
-//     auto ctx = std::make_unique<Environment>(*this, name);
-//     return *_envs.emplace_back(std::move(ctx));
-// }
+Runtime::~Runtime() noexcept
+{
+    // Work still pending keeps environments alive past the runtime, but can no longer schedule on their agents
+    for (auto& env : *_envs.wlock()) {
+        env->close();
+    }
+    _mainEnv->close();
+}
+
+auto Runtime::heapMetrics() -> HeapMetrics
+{
+    auto collect = [](Environment& env) { return env.heapMetrics(); };
+
+    auto total = _mainEnv->call(collect);
+    for (auto& env : _envs.copy()) {
+        total += env->call(collect);
+    }
+
+    return total;
+}
+
+auto Runtime::createEnvironment(const std::string& name) & -> Environment&
+{
+    return createEnvironment(name, _options.defaultEnvironmentOptions());
+}
+
+auto Runtime::createEnvironment(const std::string& name, const EnvironmentOptions& options) & -> Environment&
+{
+    auto agent = Agent::create();
+    agent->setTracer(_tracer);
+    auto env = Environment::create(*this, *agent, name, options);
+
+    _agents.wlock()->push_back(std::move(agent));
+    return *_envs.wlock()->emplace_back(std::move(env));
+}
+
+auto Runtime::createEnvironment(
+    const std::string& name,
+    const EnvironmentOptions& options,
+    const EnvironmentSnapshot& snapshot
+) & -> Environment&
+{
+    auto& env = createEnvironment(name, options);
+    try {
+        env.call([&snapshot](Environment& env) { snapshot.restore(env); });
+    }
+    catch (...) {
+        // Partially restored environment is of no use
+        destroyEnvironment(env);
+        throw;
+    }
+    return env;
+}
+
+void Runtime::destroyEnvironment(Environment& env)
+{
+    Environment::Ptr removedEnv;
+    Agent::Ptr removedAgent;
+
+    {
+        auto envs = _envs.wlock();
+        auto agents = _agents.wlock();
+        auto it = std::find_if(envs->begin(), envs->end(), [&env](auto& candidate) { return candidate.get() == &env; });
+        assert(it != envs->end());
+
+        auto index = std::distance(envs->begin(), it);
+        removedEnv = std::move(*it);
+        removedAgent = std::move((*agents)[index]);
+        envs->erase(it);
+        agents->erase(agents->begin() + index);
+    }
+
+    // Stop agent first, so that no scheduled task outlives the environment. Work still pending keeps the
+    // environment alive, but can no longer schedule on it.
+    removedEnv->close();
+    removedAgent.reset();
+}
 
 }
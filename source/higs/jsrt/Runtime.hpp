@@ -15,6 +15,8 @@
 #include <higs/jsrt/Environment.hpp>
 #include <higs/jsrt/FollyExecutionPlatform.hpp>
 #include <higs/jsrt/RefCounted.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
+#include <higs/jsrt/TaskTracer.hpp>
 #include <jsrt/jsrt.hpp>
 
 namespace higs {
@@ -23,20 +25,49 @@ class Runtime final
     : public jsrt::Runtime
     , public RefCounted<Runtime> {
   protected:
-    // TODO: accept options / builder
-    Runtime() noexcept;
+    explicit Runtime(const RuntimeOptions& options = {}) noexcept;
 
   public:
     HIGS_MAKE_NON_COPYABLE(Runtime);
-    ~Runtime() noexcept = default;
+    ~Runtime() noexcept;
 
-    auto jsRuntimeBuilder() noexcept -> hermes::vm::RuntimeConfig::Builder&
+    [[nodiscard]]
+    auto options() const noexcept -> const RuntimeOptions&
     {
-        return _builder;
+        return _options;
     }
 
-    // [[nodiscard]]
-    // auto createEnvironment(const std::string& name) & noexcept -> Environment&;
+    /**
+     * Creates a new environment running on its own agent.
+     *
+     * @param name Name of the environment
+     * @param options Options of the environment, defaults to runtime's default environment options
+     * @return Created environment, owned by this runtime
+     */
+    [[nodiscard]]
+    auto createEnvironment(const std::string& name) & -> Environment&;
+
+    [[nodiscard]]
+    auto createEnvironment(const std::string& name, const EnvironmentOptions& options) & -> Environment&;
+
+    /**
+     * Creates a new environment, and restores it from `snapshot`.
+     *
+     * @throws jsi::JSError When a script of the snapshot throws, after destroying the environment
+     */
+    [[nodiscard]]
+    auto createEnvironment(
+        const std::string& name,
+        const EnvironmentOptions& options,
+        const EnvironmentSnapshot& snapshot
+    ) & -> Environment&;
+
+    /**
+     * Destroys environment previously created using `createEnvironment`, and stops its agent.
+     *
+     * Environment must not be used afterward.
+     */
+    void destroyEnvironment(Environment& env);
 
     auto sourceProviders() noexcept -> std::vector<jsrt::SourceProvider*> override
     {
@@ -55,23 +86,53 @@ class Runtime final
         return *_platform;
     }
 
+    /**
+     * Gets executors shared by all environments of this runtime, e.g. for offloading I/O.
+     */
     [[nodiscard]]
-    auto mainEnvironment()& noexcept -> jsrt::Environment& override
+    auto platform() & noexcept -> FollyExecutionPlatform&
     {
-        return *_mainEnv;
+        return *_platform;
     }
 
     [[nodiscard]]
-    auto mainEnvironment() const& noexcept -> const jsrt::Environment& override
+    auto platform() const& noexcept -> const FollyExecutionPlatform&
     {
-        return *_mainEnv;
+        return *_platform;
     }
 
-  private:
     /**
+     * Collects heap metrics of all environments of this runtime, and aggregates them.
      *
+     * Blocks until every environment reported its metrics on its own thread, so must not be
+     * called from an agent's thread.
      */
-    hermes::vm::RuntimeConfig::Builder _builder;
+    [[nodiscard]]
+    auto heapMetrics() -> HeapMetrics;
+
+    /**
+     * Gets tracer recording tasks scheduled on agents of this runtime.
+     */
+    [[nodiscard]]
+    auto taskTracer() noexcept -> TaskTracer&
+    {
+        return *_tracer;
+    }
+
+    [[nodiscard]]
+    auto mainEnvironment()& noexcept -> Environment& override
+    {
+        return *_mainEnv;
+    }
+
+    [[nodiscard]]
+    auto mainEnvironment() const& noexcept -> const Environment& override
+    {
+        return *_mainEnv;
+    }
+
+  private:
+    RuntimeOptions _options;
 
     /**
      * Represents a map of known modules.
@@ -83,10 +144,17 @@ class Runtime final
 
     std::vector<jsrt::SourceProvider*> _sourceProviders {};
 
+    /**
+     * Declared before agents and environments, so that it outlives them: their tasks use its executors
+     * while agents shut down.
+     */
+    std::unique_ptr<FollyExecutionPlatform> _platform;
+
+    TaskTracer::Ptr _tracer;
     Agent::Ptr _mainAgent;
     Environment::Ptr _mainEnv;
-    std::vector<Environment::Ptr> _envs;
-    std::unique_ptr<FollyExecutionPlatform> _platform;
+    Synchronized<std::vector<Agent::Ptr>> _agents;
+    Synchronized<std::vector<Environment::Ptr>> _envs;
 
     friend class higs::RefCounted<Runtime>;
 };
@@ -0,0 +1,37 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "RuntimeOptions.hpp"
+
+namespace higs {
+
+auto EnvironmentOptions::toHermesConfig() const -> hermes::vm::RuntimeConfig
+{
+    auto gcConfig = hermes::vm::GCConfig::Builder()
+                        .withMinHeapSize(_minHeapSize)
+                        .withInitHeapSize(_initHeapSize)
+                        .withMaxHeapSize(_maxHeapSize)
+                        .withOccupancyTarget(_occupancyTarget)
+                        .withAllocInYoung(_allocInYoung)
+                        .withShouldReleaseUnused(
+                            _releaseUnusedMemory ? hermes::vm::kReleaseUnusedOld : hermes::vm::kReleaseUnusedNone
+                        )
+                        .build();
+
+    return hermes::vm::RuntimeConfig::Builder()
+        .withGCConfig(gcConfig)
+        .withArrayBuffer(true)
+        .withEnableEval(_eval)
+        .withEnableGenerator(_generators)
+        .withMicrotaskQueue(_microtaskQueue)
+        .withES6Class(true)
+        .withES6Promise(true)
+        .withES6Proxy(_proxy)
+        .withES6BlockScoping(true)
+        .withIntl(_intl)
+        .build();
+}
+
+}
@@ -0,0 +1,387 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#include <hermes/hermes.h>
+
+namespace higs {
+
+/**
+ * Determines which representation of a script is loaded, when both source and precompiled
+ * bytecode are available.
+ */
+enum class SourcePreference {
+    /**
+     * Load bytecode when present, fall back to source.
+     */
+    PreferBytecode,
+
+    /**
+     * Always load source, ignoring bytecode. Useful while developing, when bytecode might be stale.
+     */
+    PreferSource,
+};
+
+/**
+ * Determines how file I/O of a runtime is performed, see `FileEngine`.
+ */
+enum class FileEngineKind {
+    /**
+     * Use io_uring when supported by both the build and the kernel, thread pool otherwise.
+     */
+    Auto,
+
+    /**
+     * Blocking system calls on I/O executor threads.
+     */
+    ThreadPool,
+
+    /**
+     * io_uring, falling back to thread pool when unavailable.
+     */
+    IoUring,
+};
+
+/**
+ * Options of a single `Environment`.
+ *
+ * Controls JS heap sizing, garbage collector heuristics and enabled language features.
+ * Each option has a fluent setter (`with*`), so options can be built in one expression:
+ *
+ * @code{.cpp}
+ * auto options = EnvironmentOptions()
+ *     .withInitHeapSize(4 << 20)
+ *     .withMaxHeapSize(64 << 20)
+ *     .withIntl(false);
+ * @endcode
+ *
+ * Kind of the garbage collector (and whether it collects concurrently) is selected when Hermes is built,
+ * and cannot be changed per environment. GC behaviour is instead tuned through heap sizes,
+ * occupancy target and young generation allocation.
+ */
+class EnvironmentOptions {
+public:
+    using HeapSize = hermes::vm::gcheapsize_t;
+
+// -- Heap
+    /**
+     * Heap is never shrunk below this size.
+     */
+    auto withMinHeapSize(HeapSize bytes) noexcept -> EnvironmentOptions&
+    {
+        _minHeapSize = bytes;
+        return *this;
+    }
+
+    /**
+     * Heap size reserved when environment is created.
+     */
+    auto withInitHeapSize(HeapSize bytes) noexcept -> EnvironmentOptions&
+    {
+        _initHeapSize = bytes;
+        return *this;
+    }
+
+    /**
+     * Heap never grows beyond this size, allocations exceeding it throw out of memory error.
+     */
+    auto withMaxHeapSize(HeapSize bytes) noexcept -> EnvironmentOptions&
+    {
+        _maxHeapSize = bytes;
+        return *this;
+    }
+
+    /**
+     * Fraction of the heap that live data should occupy after collection.
+     *
+     * Lower values make the heap grow more eagerly, trading memory for fewer collections.
+     */
+    auto withOccupancyTarget(double target) noexcept -> EnvironmentOptions&
+    {
+        _occupancyTarget = target;
+        return *this;
+    }
+
+    /**
+     * Whether objects are allocated in the young generation first.
+     *
+     * Disabling this avoids young generation collections for workloads where most objects are long-lived
+     * (e.g. a bootstrap phase of large bundles).
+     */
+    auto withAllocInYoung(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _allocInYoung = enabled;
+        return *this;
+    }
+
+    /**
+     * Whether unused heap memory is returned to the OS after collections.
+     */
+    auto withReleaseUnusedMemory(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _releaseUnusedMemory = enabled;
+        return *this;
+    }
+
+// -- Loading
+    auto withSourcePreference(SourcePreference preference) noexcept -> EnvironmentOptions&
+    {
+        _sourcePreference = preference;
+        return *this;
+    }
+
+// -- Features
+    auto withEval(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _eval = enabled;
+        return *this;
+    }
+
+    auto withProxy(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _proxy = enabled;
+        return *this;
+    }
+
+    auto withIntl(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _intl = enabled;
+        return *this;
+    }
+
+    auto withGenerators(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _generators = enabled;
+        return *this;
+    }
+
+    auto withMicrotaskQueue(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _microtaskQueue = enabled;
+        return *this;
+    }
+
+    /**
+     * Whether global `require` loading built-in modules (e.g. `fs`) is defined.
+     */
+    auto withBuiltinModules(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _builtinModules = enabled;
+        return *this;
+    }
+
+    /**
+     * Whether native global `TextEncoder` and `TextDecoder` are defined.
+     */
+    auto withTextCodecs(bool enabled) noexcept -> EnvironmentOptions&
+    {
+        _textCodecs = enabled;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto minHeapSize() const noexcept -> HeapSize
+    {
+        return _minHeapSize;
+    }
+
+    [[nodiscard]]
+    auto initHeapSize() const noexcept -> HeapSize
+    {
+        return _initHeapSize;
+    }
+
+    [[nodiscard]]
+    auto maxHeapSize() const noexcept -> HeapSize
+    {
+        return _maxHeapSize;
+    }
+
+    [[nodiscard]]
+    auto occupancyTarget() const noexcept -> double
+    {
+        return _occupancyTarget;
+    }
+
+    [[nodiscard]]
+    auto allocInYoung() const noexcept -> bool
+    {
+        return _allocInYoung;
+    }
+
+    [[nodiscard]]
+    auto releaseUnusedMemory() const noexcept -> bool
+    {
+        return _releaseUnusedMemory;
+    }
+
+    [[nodiscard]]
+    auto sourcePreference() const noexcept -> SourcePreference
+    {
+        return _sourcePreference;
+    }
+
+    [[nodiscard]]
+    auto eval() const noexcept -> bool
+    {
+        return _eval;
+    }
+
+    [[nodiscard]]
+    auto proxy() const noexcept -> bool
+    {
+        return _proxy;
+    }
+
+    [[nodiscard]]
+    auto intl() const noexcept -> bool
+    {
+        return _intl;
+    }
+
+    [[nodiscard]]
+    auto generators() const noexcept -> bool
+    {
+        return _generators;
+    }
+
+    [[nodiscard]]
+    auto microtaskQueue() const noexcept -> bool
+    {
+        return _microtaskQueue;
+    }
+
+    [[nodiscard]]
+    auto builtinModules() const noexcept -> bool
+    {
+        return _builtinModules;
+    }
+
+    [[nodiscard]]
+    auto textCodecs() const noexcept -> bool
+    {
+        return _textCodecs;
+    }
+
+    /**
+     * Creates Hermes runtime config from these options.
+     */
+    [[nodiscard]]
+    auto toHermesConfig() const -> hermes::vm::RuntimeConfig;
+
+private:
+    HeapSize _minHeapSize = 0;
+    HeapSize _initHeapSize = 32 << 20;
+    HeapSize _maxHeapSize = 3U << 30;
+    double _occupancyTarget = 0.5;
+    bool _allocInYoung = true;
+    bool _releaseUnusedMemory = true;
+
+    SourcePreference _sourcePreference = SourcePreference::PreferBytecode;
+
+    bool _eval = true;
+    bool _proxy = true;
+    bool _intl = false;
+    bool _generators = true;
+    bool _microtaskQueue = true;
+    bool _builtinModules = true;
+    bool _textCodecs = true;
+};
+
+/**
+ * Options of a `Runtime`.
+ */
+class RuntimeOptions {
+public:
+    /**
+     * Number of threads executing background (CPU-bound) work.
+     */
+    auto withBackgroundThreads(size_t count) noexcept -> RuntimeOptions&
+    {
+        _backgroundThreads = count;
+        return *this;
+    }
+
+    /**
+     * Number of threads executing I/O work.
+     */
+    auto withIOThreads(size_t count) noexcept -> RuntimeOptions&
+    {
+        _ioThreads = count;
+        return *this;
+    }
+
+    /**
+     * How file I/O is performed.
+     */
+    auto withFileEngine(FileEngineKind kind) noexcept -> RuntimeOptions&
+    {
+        _fileEngine = kind;
+        return *this;
+    }
+
+    /**
+     * Number of submission queue entries of io_uring file engine.
+     */
+    auto withIoUringQueueDepth(unsigned depth) noexcept -> RuntimeOptions&
+    {
+        _ioUringQueueDepth = depth;
+        return *this;
+    }
+
+    /**
+     * Options used by the main environment, and by environments created without explicit options.
+     */
+    auto withDefaultEnvironmentOptions(EnvironmentOptions options) noexcept -> RuntimeOptions&
+    {
+        _defaultEnvironmentOptions = std::move(options);
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto backgroundThreads() const noexcept -> size_t
+    {
+        return _backgroundThreads;
+    }
+
+    [[nodiscard]]
+    auto ioThreads() const noexcept -> size_t
+    {
+        return _ioThreads;
+    }
+
+    [[nodiscard]]
+    auto fileEngine() const noexcept -> FileEngineKind
+    {
+        return _fileEngine;
+    }
+
+    [[nodiscard]]
+    auto ioUringQueueDepth() const noexcept -> unsigned
+    {
+        return _ioUringQueueDepth;
+    }
+
+    [[nodiscard]]
+    auto defaultEnvironmentOptions() const noexcept -> const EnvironmentOptions&
+    {
+        return _defaultEnvironmentOptions;
+    }
+
+private:
+    size_t _backgroundThreads = std::max(1U, std::thread::hardware_concurrency());
+    size_t _ioThreads = 2;
+    FileEngineKind _fileEngine = FileEngineKind::Auto;
+    unsigned _ioUringQueueDepth = 256;
+    EnvironmentOptions _defaultEnvironmentOptions;
+};
+
+}
@@ -0,0 +1,63 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "TaskTracer.hpp"
+
+#include <unistd.h>
+
+namespace higs {
+
+namespace {
+
+auto toMicros(TaskTracer::Clock::time_point time) -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+}
+
+void TaskTracer::record(const TaskSpan& span)
+{
+    _spans.wlock()->push_back(span);
+}
+
+void TaskTracer::clear()
+{
+    _spans.wlock()->clear();
+}
+
+auto TaskTracer::spans() const -> std::vector<TaskSpan>
+{
+    return *_spans.rlock();
+}
+
+auto TaskTracer::toTraceEvents() const -> folly::dynamic
+{
+    auto events = folly::dynamic::array();
+    auto pid = static_cast<int64_t>(::getpid());
+    auto spans = _spans.rlock();
+
+    int64_t id = 0;
+    for (const auto& span : *spans) {
+        auto tid = static_cast<int64_t>(span.threadId);
+        auto queuedUs = toMicros(span.startedAt) - toMicros(span.enqueuedAt);
+        auto runUs = toMicros(span.finishedAt) - toMicros(span.startedAt);
+
+        events.push_back(folly::dynamic::object("name", span.name)("cat", "higs.agent.queue")("ph", "b")("id", id)(
+            "ts", toMicros(span.enqueuedAt)
+        )("pid", pid)("tid", tid));
+        events.push_back(folly::dynamic::object("name", span.name)("cat", "higs.agent.queue")("ph", "e")("id", id)(
+            "ts", toMicros(span.startedAt)
+        )("pid", pid)("tid", tid));
+        events.push_back(folly::dynamic::object("name", span.name)("cat", "higs.agent")("ph", "X")(
+            "ts", toMicros(span.startedAt)
+        )("dur", runUs)("pid", pid)("tid", tid)("args", folly::dynamic::object("queuedUs", queuedUs)));
+        ++id;
+    }
+
+    return events;
+}
+
+}
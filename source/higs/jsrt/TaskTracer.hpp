@@ -0,0 +1,106 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <folly/json/dynamic.h>
+#include <folly/system/ThreadId.h>
+#include <higs/common.hpp>
+#include <higs/jsrt/RefCounted.hpp>
+
+namespace higs {
+
+/**
+ * Records spans of tasks executed by `Agent`s.
+ *
+ * Each span tracks when the task was scheduled, when it started running and when it finished,
+ * so that both queueing delay and run time are visible. Spans are exported as Chrome trace
+ * events, using the same clock as Hermes sampling profiler, so that native scheduling and
+ * JS samples can be shown on one timeline.
+ *
+ * Tracing is disabled by default, and costs a single relaxed load per scheduled task when disabled.
+ */
+class TaskTracer final : public RefCounted<TaskTracer> {
+protected:
+    TaskTracer() noexcept = default;
+    ~TaskTracer() noexcept = default;
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct TaskSpan {
+        /**
+         * Name of the span, must be a string with static storage duration.
+         */
+        const char* name;
+        uint64_t threadId;
+        Clock::time_point enqueuedAt;
+        Clock::time_point startedAt;
+        Clock::time_point finishedAt;
+    };
+
+    void start() noexcept
+    {
+        _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void stop() noexcept
+    {
+        _enabled.store(false, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]]
+    auto isEnabled() const noexcept -> bool
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    void record(const TaskSpan& span);
+
+    void clear();
+
+    /**
+     * Returns copy of all recorded spans.
+     */
+    [[nodiscard]]
+    auto spans() const -> std::vector<TaskSpan>;
+
+    /**
+     * Converts recorded spans into an array of Chrome trace events.
+     *
+     * Run time is emitted as a complete (`X`) event on the executing thread, queue time as
+     * an async (`b`/`e`) event pair, so that overlapping waits do not break nesting.
+     */
+    [[nodiscard]]
+    auto toTraceEvents() const -> folly::dynamic;
+
+    /**
+     * Wraps `func`, so that its execution is recorded as a span named `name`.
+     *
+     * Enqueue time is taken at the moment of wrapping.
+     */
+    template<typename Func>
+    auto wrap(const char* name, Func func) -> Func
+    {
+        return [tracer = asRef(), name, enqueuedAt = Clock::now(), func = std::move(func)]() mutable {
+            auto startedAt = Clock::now();
+            func();
+            tracer->record({ name, folly::getOSThreadID(), enqueuedAt, startedAt, Clock::now() });
+        };
+    }
+
+private:
+    std::atomic<bool> _enabled = false;
+    Synchronized<std::vector<TaskSpan>> _spans;
+
+    friend class higs::RefCounted<TaskTracer>;
+};
+
+}
@@ -0,0 +1,124 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <utility>
+
+#include <higs/jsrt/RefCounted.hpp>
+#include <higs/jsrt/WeakRefTable.hpp>
+
+namespace higs {
+
+/**
+ * Non-owning reference to a `RefCounted` object.
+ *
+ * Does not keep the object alive; `lock` upgrades it to a strong reference if the object still exists.
+ * Lets schedulers, caches and registries observe environments or agents without delaying their destruction.
+ *
+ * @code{.cpp}
+ * WeakRef<Environment> weakEnv { env.asRef() };
+ * // ...
+ * if (auto env = weakEnv.lock()) {
+ *     env->runLater(...);
+ * }
+ * @endcode
+ *
+ * Creating, copying and destroying weak references takes a lock, and is meant to be far less frequent
+ * than strong reference operations. Weak references to thread-confined objects must be locked on the
+ * owner thread.
+ *
+ * @tparam T Reference counted type
+ */
+template<typename T>
+class WeakRef final {
+public:
+    using Ptr = boost::intrusive_ptr<T>;
+
+    WeakRef() noexcept = default;
+
+    explicit WeakRef(const Ptr& ref) : WeakRef(ref.get())
+    {
+    }
+
+    /**
+     * @param object Live object, caller must hold a strong reference to it
+     */
+    explicit WeakRef(T* object)
+    {
+        if (object != nullptr) {
+            object->markWeaklyReferenced();
+            _object = object;
+            _block = WeakRefTable::acquire(object->weakKey());
+        }
+    }
+
+    WeakRef(const WeakRef& other) noexcept : _object(other._object), _block(other._block)
+    {
+        if (_block != nullptr) {
+            WeakRefTable::retain(_block);
+        }
+    }
+
+    WeakRef(WeakRef&& other) noexcept
+        : _object(std::exchange(other._object, nullptr)), _block(std::exchange(other._block, nullptr))
+    {
+    }
+
+    auto operator=(WeakRef other) noexcept -> WeakRef&
+    {
+        std::swap(_object, other._object);
+        std::swap(_block, other._block);
+        return *this;
+    }
+
+    ~WeakRef() noexcept
+    {
+        reset();
+    }
+
+    /**
+     * Gets strong reference to the object, or null if it was already destroyed.
+     */
+    [[nodiscard]]
+    auto lock() const noexcept -> Ptr
+    {
+        if (_block == nullptr) {
+            return nullptr;
+        }
+
+        return WeakRefTable::withObject(_block, [this](const void* object) -> Ptr {
+            if (object == nullptr || !_object->tryRetain()) {
+                return nullptr;
+            }
+            return Ptr(_object, false);
+        });
+    }
+
+    /**
+     * Whether the object was destroyed (or this reference is empty).
+     *
+     * Result can be outdated as soon as it is returned, use `lock` to access the object.
+     */
+    [[nodiscard]]
+    auto expired() const noexcept -> bool
+    {
+        return _block == nullptr || WeakRefTable::withObject(_block, [](const void* object) { return object == nullptr; });
+    }
+
+    void reset() noexcept
+    {
+        if (_block != nullptr) {
+            WeakRefTable::release(std::exchange(_block, nullptr));
+            _object = nullptr;
+        }
+    }
+
+private:
+    T* _object = nullptr;
+    WeakControlBlock* _block = nullptr;
+};
+
+}
@@ -0,0 +1,103 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "WeakRefTable.hpp"
+
+#include <array>
+#include <cassert>
+#include <functional>
+
+#include <folly/container/F14Map.h>
+#include <folly/lang/Align.h>
+
+namespace higs {
+
+namespace {
+
+constexpr std::size_t kShardCount = 64;
+
+struct alignas(folly::hardware_destructive_interference_size) Shard {
+    std::mutex mutex;
+    folly::F14FastMap<const void*, WeakControlBlock*> blocks;
+};
+
+auto shards() -> std::array<Shard, kShardCount>&
+{
+    // Leaked, so that objects destroyed during static destruction can still report it
+    static auto* instance = new std::array<Shard, kShardCount>();
+    return *instance;
+}
+
+auto shardOf(const void* object) noexcept -> std::size_t
+{
+    return std::hash<const void*>{}(object) % kShardCount;
+}
+
+}
+
+auto WeakRefTable::acquire(const void* object) -> WeakControlBlock*
+{
+    auto index = shardOf(object);
+    auto& shard = shards()[index];
+
+    std::scoped_lock lock { shard.mutex };
+    auto [it, inserted] = shard.blocks.try_emplace(object, nullptr);
+    if (inserted) {
+        it->second = new WeakControlBlock { .object = object, .weakCount = 0, .shard = index };
+    }
+
+    ++it->second->weakCount;
+    return it->second;
+}
+
+void WeakRefTable::retain(WeakControlBlock* block) noexcept
+{
+    std::scoped_lock lock { shardMutex(block->shard) };
+    ++block->weakCount;
+}
+
+void WeakRefTable::release(WeakControlBlock* block) noexcept
+{
+    bool shouldDelete;
+    {
+        std::scoped_lock lock { shardMutex(block->shard) };
+        assert(block->weakCount > 0);
+        shouldDelete = --block->weakCount == 0 && block->object == nullptr;
+    }
+
+    if (shouldDelete) {
+        delete block;
+    }
+}
+
+void WeakRefTable::objectDestroyed(const void* object) noexcept
+{
+    auto& shard = shards()[shardOf(object)];
+
+    WeakControlBlock* orphan = nullptr;
+    {
+        std::scoped_lock lock { shard.mutex };
+        auto it = shard.blocks.find(object);
+        if (it == shard.blocks.end()) {
+            return;
+        }
+
+        auto* block = it->second;
+        shard.blocks.erase(it);
+        block->object = nullptr;
+        if (block->weakCount == 0) {
+            orphan = block;
+        }
+    }
+
+    delete orphan;
+}
+
+auto WeakRefTable::shardMutex(std::size_t shard) noexcept -> std::mutex&
+{
+    return shards()[shard].mutex;
+}
+
+}
@@ -0,0 +1,82 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+
+namespace higs {
+
+/**
+ * Shared state of all weak references to one object.
+ *
+ * Allocated when the first weak reference to an object is created, and freed when both the object
+ * and all of its weak references are gone. Fields are guarded by the lock of the table shard the
+ * block belongs to.
+ */
+struct WeakControlBlock {
+    /**
+     * Observed object, or null once it has been destroyed.
+     */
+    const void* object;
+
+    /**
+     * Number of `WeakRef`s pointing to this block.
+     */
+    std::size_t weakCount;
+
+    std::size_t shard;
+};
+
+/**
+ * Process-wide table mapping weakly referenced objects to their control blocks.
+ *
+ * Keeping control blocks out of objects lets reference counted objects stay a single word in the common
+ * case of never being weakly referenced. Table is sharded by object address, so that unrelated objects
+ * rarely contend on a lock.
+ */
+class WeakRefTable final {
+public:
+    WeakRefTable() = delete;
+
+    /**
+     * Gets control block of live `object`, creating it on first use, and adds a weak reference to it.
+     */
+    static auto acquire(const void* object) -> WeakControlBlock*;
+
+    /**
+     * Adds a weak reference to an existing control block.
+     */
+    static void retain(WeakControlBlock* block) noexcept;
+
+    /**
+     * Removes a weak reference, and frees the block once its object is destroyed and no references remain.
+     */
+    static void release(WeakControlBlock* block) noexcept;
+
+    /**
+     * Detaches control block of `object`, which is about to be deleted.
+     *
+     * Must be called after object's reference count dropped to zero, and before its memory is freed.
+     */
+    static void objectDestroyed(const void* object) noexcept;
+
+    /**
+     * Runs `func` with the object observed by `block` (null if destroyed), while the object can not be
+     * deleted.
+     */
+    template<typename Func>
+    static auto withObject(WeakControlBlock* block, Func&& func)
+    {
+        std::scoped_lock lock { shardMutex(block->shard) };
+        return func(block->object);
+    }
+
+private:
+    static auto shardMutex(std::size_t shard) noexcept -> std::mutex&;
+};
+
+}
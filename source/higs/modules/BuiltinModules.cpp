@@ -0,0 +1,110 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "BuiltinModules.hpp"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include <fmt/format.h>
+#include "BytesModule.hpp"
+#include "ChildProcessModule.hpp"
+#include "CompressionModule.hpp"
+#include "DigestModule.hpp"
+#include "FileSystemModule.hpp"
+#include "NetModule.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+struct BuiltinModule {
+    std::string_view name;
+    ModuleFactory factory;
+};
+
+constexpr std::array builtinModules {
+    BuiltinModule { "bytes", &createBytesModule },
+    BuiltinModule { "child_process", &createChildProcessModule },
+    BuiltinModule { "compression", &createCompressionModule },
+    BuiltinModule { "digest", &createDigestModule },
+    BuiltinModule { "fs", &createFileSystemModule },
+    BuiltinModule { "net", &createNetModule },
+};
+
+constexpr std::string_view kSchemePrefix = "higs:";
+
+}
+
+auto findBuiltinModule(std::string_view name) noexcept -> ModuleFactory
+{
+    if (name.starts_with(kSchemePrefix)) {
+        name.remove_prefix(kSchemePrefix.size());
+    }
+
+    for (const auto& module : builtinModules) {
+        if (module.name == name) {
+            return module.factory;
+        }
+    }
+
+    return nullptr;
+}
+
+void throwError(jsrt::Environment& env, const char* constructor, const std::string& message)
+{
+    auto error = env.globalObject().getPropertyAsFunction(env, constructor).callAsConstructor(
+        env,
+        jsi::String::createFromUtf8(env, message)
+    );
+    throw jsi::JSError(env, std::move(error));
+}
+
+auto integerArgument(jsrt::Environment& env, const jsi::Value& value, const char* name, int64_t min, int64_t max)
+    -> int64_t
+{
+    if (!value.isNumber()) {
+        throw jsi::JSError(env, fmt::format("'{}' must be a number", name));
+    }
+    auto number = value.asNumber();
+    if (!(number >= static_cast<double>(min) && number <= static_cast<double>(max)) || std::trunc(number) != number) {
+        throwError(env, "RangeError", fmt::format("'{}' must be an integer from {} to {}", name, min, max));
+    }
+    return static_cast<int64_t>(number);
+}
+
+void installRequire(Environment& env)
+{
+    auto cache = std::make_shared<jsi::Object>(env);
+    auto require = jsi::Function::createFromHostFunction(
+        env,
+        jsi::PropNameID::forAscii(env, "require"),
+        1,
+        [&env, cache](jsi::Runtime&, const jsi::Value&, const jsi::Value* args, size_t count) -> jsi::Value {
+            auto name = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+            auto factory = findBuiltinModule(name);
+            if (factory == nullptr) {
+                throw jsi::JSError(env, fmt::format("Cannot find module '{}'", name));
+            }
+
+            // Modules are cached under their canonical name, so that `fs` and `higs:fs` share exports
+            auto canonicalName = name.starts_with(kSchemePrefix) ? name.substr(kSchemePrefix.size()) : name;
+            auto cached = cache->getProperty(env, canonicalName.c_str());
+            if (cached.isObject()) {
+                return cached;
+            }
+
+            auto exports = factory(env);
+            cache->setProperty(env, canonicalName.c_str(), exports);
+            return exports;
+        }
+    );
+    require.setProperty(env, "cache", *cache);
+    env.globalObject().setProperty(env, "require", std::move(require));
+}
+
+}
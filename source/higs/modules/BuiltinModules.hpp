@@ -0,0 +1,144 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <folly/executors/InlineExecutor.h>
+#include <folly/futures/Future.h>
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+#include <higs/jsrt/Runtime.hpp>
+#include <jsrt/conv.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports object of a built-in module in `env`.
+ */
+using ModuleFactory = jsi::Object (*)(Environment& env);
+
+/**
+ * Finds factory of built-in module `name`, e.g. `"fs"`.
+ *
+ * @return Factory, or `nullptr` when there is no such module
+ */
+auto findBuiltinModule(std::string_view name) noexcept -> ModuleFactory;
+
+/**
+ * Defines global `require` function, loading built-in modules.
+ *
+ * Each module is created once per environment on first `require`, and cached in `require.cache`.
+ * Names may be prefixed with `higs:`, e.g. `require('higs:fs')`.
+ */
+void installRequire(Environment& env);
+
+/**
+ * Defines host function `name` on `target`.
+ *
+ * Callback receives the environment it is defined in, instead of bare `jsi::Runtime`.
+ */
+template<typename F>
+void defineFunction(Environment& env, const jsi::Object& target, const char* name, unsigned arity, F callback)
+{
+    auto propName = jsi::PropNameID::forAscii(env, name);
+    auto func = jsi::Function::createFromHostFunction(
+        env,
+        propName,
+        arity,
+        [&env, callback = std::move(callback)](jsi::Runtime&, const jsi::Value&, const jsi::Value* args, size_t count) {
+            return callback(env, args, count);
+        }
+    );
+    target.setProperty(env, propName, std::move(func));
+}
+
+/**
+ * Throws JS error created by global constructor `constructor`, e.g. `"RangeError"`.
+ */
+[[noreturn]] void throwError(jsrt::Environment& env, const char* constructor, const std::string& message);
+
+/**
+ * Gets argument at `index`, or `undefined` when fewer arguments were passed.
+ */
+inline auto argumentAt(const jsi::Value* args, size_t count, size_t index) noexcept -> const jsi::Value&
+{
+    static const jsi::Value undefined;
+    return index < count ? args[index] : undefined;
+}
+
+/**
+ * Largest integer a JS number holds exactly.
+ */
+constexpr int64_t kMaxSafeInteger = (int64_t(1) << 53) - 1;
+
+/**
+ * Gets argument (or option) `name` that is an integer from `min` to `max`, e.g. a port or a buffer size.
+ *
+ * @throws jsi::JSError When the argument is not a number, or `RangeError` when it is fractional, out of range
+ * or not finite
+ */
+auto integerArgument(jsrt::Environment& env, const jsi::Value& value, const char* name, int64_t min, int64_t max)
+    -> int64_t;
+
+/**
+ * Gets argument that is an integer from 0 to `max`, e.g. a size or a file descriptor.
+ */
+inline auto integerArgument(
+    jsrt::Environment& env, const jsi::Value& value, const char* name, int64_t max = kMaxSafeInteger
+) -> int64_t
+{
+    return integerArgument(env, value, name, 0, max);
+}
+
+/**
+ * Runs `func` on the runtime's I/O executor, and returns a JS promise of its result.
+ *
+ * Result is converted using `jsrt::conv::toJS` on the environment's thread, exceptions reject the promise.
+ * `func` runs off the JS thread, so it must only capture native values.
+ */
+template<typename F>
+auto runOnIOThread(Environment& env, F func) -> jsi::Value
+{
+    auto& executor = env.host().platform().getIOExecutor();
+    return jsrt::conv::toJS(folly::via(folly::getKeepAliveToken(executor), std::move(func)).semi(), env);
+}
+
+/**
+ * Same as `runOnIOThread`, but runs `func` on the runtime's background executor.
+ *
+ * Meant for CPU-bound work, which would otherwise delay I/O completions.
+ */
+template<typename F>
+auto runInBackground(Environment& env, F func) -> jsi::Value
+{
+    auto& executor = env.host().platform().getBackgroundExecutor();
+    return jsrt::conv::toJS(folly::via(folly::getKeepAliveToken(executor), std::move(func)).semi(), env);
+}
+
+/**
+ * Calls `callback` with result of `future` on the environment's thread, once the future completes.
+ *
+ * Unlike `jsrt::conv::toJS` of a future, no promise is created, so native state confined to the environment's
+ * thread can be updated by `callback`.
+ */
+template<typename T, typename F>
+void continueOnEnvironment(Environment& env, folly::SemiFuture<T> future, F callback)
+{
+    std::move(future)
+        .via(&folly::InlineExecutor::instance())
+        .thenTry([work = jsrt::PendingWork(env), callback = std::move(callback)](folly::Try<T>&& result) mutable {
+            work.environment().runLater([callback = std::move(callback), result = std::move(result)](jsrt::Environment&) mutable {
+                callback(std::move(result));
+            });
+        });
+}
+
+}
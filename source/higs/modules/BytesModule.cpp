@@ -0,0 +1,264 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "BytesModule.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/ByteKernels.hpp>
+#include <simdutf.h>
+#include "BuiltinModules.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+using ext::NativeBuffer;
+
+/**
+ * Gets index argument `name`, clamped to `[0, size]`.
+ */
+auto indexArgument(Environment& env, const jsi::Value& value, const char* name, size_t size, size_t fallback) -> size_t
+{
+    if (value.isUndefined()) {
+        return fallback;
+    }
+    if (!value.isNumber()) {
+        throw jsi::JSError(env, fmt::format("Argument '{}' must be a number", name));
+    }
+    auto index = value.asNumber();
+    return std::isnan(index) ? 0 : static_cast<size_t>(std::clamp(index, 0.0, static_cast<double>(size)));
+}
+
+auto byteArgument(Environment& env, const jsi::Value& value, const char* name) -> uint8_t
+{
+    if (!value.isNumber()) {
+        throw jsi::JSError(env, fmt::format("Argument '{}' must be a number", name));
+    }
+    // Wraps like assignment to Uint8Array elements, reducing the double itself, which may be out of integer range
+    auto number = value.asNumber();
+    if (!std::isfinite(number)) {
+        return 0;
+    }
+    auto byte = std::fmod(std::trunc(number), 256.0);
+    return static_cast<uint8_t>(byte < 0 ? byte + 256.0 : byte);
+}
+
+auto base64Options(Environment& env, const jsi::Value& value) -> simdutf::base64_options
+{
+    if (value.isUndefined()) {
+        return simdutf::base64_default;
+    }
+
+    auto alphabet = value.asObject(env).getProperty(env, "alphabet");
+    if (alphabet.isUndefined()) {
+        return simdutf::base64_default;
+    }
+
+    auto name = jsrt::fromJS<std::string>(alphabet, env);
+    if (name == "base64") {
+        return simdutf::base64_default;
+    }
+    if (name == "base64url") {
+        return simdutf::base64_url;
+    }
+    throw jsi::JSError(env, fmt::format("Unknown base64 alphabet '{}'", name));
+}
+
+/**
+ * Loads `T` stored at `data` with given byte order, which may be unaligned.
+ */
+template<typename T>
+auto loadValue(const uint8_t* data, bool littleEndian) noexcept -> T
+{
+    std::array<uint8_t, sizeof(T)> bytes;
+    std::memcpy(bytes.data(), data, sizeof(T));
+    if (littleEndian != (std::endian::native == std::endian::little)) {
+        std::ranges::reverse(bytes);
+    }
+    return std::bit_cast<T>(bytes);
+}
+
+template<typename T>
+void defineRead(Environment& env, const jsi::Object& exports, const char* name)
+{
+    defineFunction(env, exports, name, 3, [](Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+        auto bytes = ext::bytesOf(env, argumentAt(args, count, 0));
+        auto offset = static_cast<size_t>(integerArgument(env, argumentAt(args, count, 1), "offset"));
+        if (offset + sizeof(T) > bytes.size()) {
+            throw jsi::JSError(env, fmt::format("Offset {} is outside the bounds of {} bytes", offset, bytes.size()));
+        }
+
+        const auto& littleEndian = argumentAt(args, count, 2);
+        auto value = loadValue<T>(bytes.data() + offset, littleEndian.isBool() && littleEndian.getBool());
+        if constexpr (std::is_same_v<T, int64_t>) {
+            return jsi::BigInt::fromInt64(env, value);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return jsi::BigInt::fromUint64(env, value);
+        } else {
+            return static_cast<double>(value);
+        }
+    });
+}
+
+}
+
+auto createBytesModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+    const auto& kernels = ext::byteKernels();
+
+    //
+    // --------------------------------------------------------------------------------------------- Encodings
+    //
+    defineFunction(env, exports, "toHex", 1, [&kernels](Environment& env, const jsi::Value* args, size_t count) {
+        auto bytes = ext::bytesOf(env, argumentAt(args, count, 0));
+        std::string digits(bytes.size() * 2, '\0');
+        kernels.hexEncode(bytes.data(), bytes.size(), digits.data());
+        return jsi::String::createFromAscii(env, digits.data(), digits.size());
+    });
+
+    defineFunction(env, exports, "fromHex", 1, [&kernels](Environment& env, const jsi::Value* args, size_t count) {
+        std::string storage;
+        auto digits = ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage);
+        auto buffer = NativeBuffer::allocate(digits.size() / 2);
+        if (!kernels.hexDecode(reinterpret_cast<const char*>(digits.data()), digits.size(), buffer->data())) {
+            throw jsi::JSError(env, "Input is not a string of hexadecimal digit pairs");
+        }
+        return ext::toArrayBuffer(env, std::move(buffer));
+    });
+
+    defineFunction(env, exports, "toBase64", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto bytes = ext::bytesOf(env, argumentAt(args, count, 0));
+        auto options = base64Options(env, argumentAt(args, count, 1));
+
+        std::string encoded(simdutf::base64_length_from_binary(bytes.size(), options), '\0');
+        auto length = simdutf::binary_to_base64(reinterpret_cast<const char*>(bytes.data()), bytes.size(), encoded.data(), options);
+        return jsi::String::createFromAscii(env, encoded.data(), length);
+    });
+
+    defineFunction(env, exports, "fromBase64", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        std::string storage;
+        auto encoded = ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage);
+        auto options = base64Options(env, argumentAt(args, count, 1));
+        const auto* chars = reinterpret_cast<const char*>(encoded.data());
+
+        auto buffer = NativeBuffer::allocate(simdutf::maximal_binary_length_from_base64(chars, encoded.size()));
+        auto result = simdutf::base64_to_binary(chars, encoded.size(), reinterpret_cast<char*>(buffer->data()), options);
+        if (result.error != simdutf::error_code::SUCCESS) {
+            throw jsi::JSError(env, fmt::format("Invalid base64 input at character {}", result.count));
+        }
+        buffer->truncate(result.count);
+        return ext::toArrayBuffer(env, std::move(buffer));
+    });
+
+    //
+    // --------------------------------------------------------------------------------------------- Search and compare
+    //
+    defineFunction(env, exports, "indexOf", 3, [&kernels](Environment& env, const jsi::Value* args, size_t count) {
+        auto haystack = ext::bytesOf(env, argumentAt(args, count, 0));
+        const auto& needleArgument = argumentAt(args, count, 1);
+        auto from = indexArgument(env, argumentAt(args, count, 2), "fromIndex", haystack.size(), 0);
+
+        std::string storage;
+        uint8_t byte = 0;
+        std::span<const uint8_t> needle;
+        if (needleArgument.isNumber()) {
+            byte = byteArgument(env, needleArgument, "needle");
+            needle = { &byte, 1 };
+        } else {
+            needle = ext::bytesOrUtf8Of(env, needleArgument, storage);
+        }
+
+        const auto* found = kernels.find(haystack.data() + from, haystack.size() - from, needle.data(), needle.size());
+        return found == nullptr ? -1.0 : static_cast<double>(found - haystack.data());
+    });
+
+    defineFunction(env, exports, "compare", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto first = ext::bytesOf(env, argumentAt(args, count, 0));
+        auto second = ext::bytesOf(env, argumentAt(args, count, 1));
+
+        auto order = std::memcmp(first.data(), second.data(), std::min(first.size(), second.size()));
+        if (order == 0) {
+            order = first.size() < second.size() ? -1 : first.size() > second.size() ? 1 : 0;
+        }
+        return static_cast<double>(order < 0 ? -1 : order > 0 ? 1 : 0);
+    });
+
+    //
+    // --------------------------------------------------------------------------------------------- Construction
+    //
+    defineFunction(env, exports, "fill", 4, [](Environment& env, const jsi::Value* args, size_t count) {
+        const auto& target = argumentAt(args, count, 0);
+        auto bytes = ext::bytesOf(env, target);
+        auto byte = byteArgument(env, argumentAt(args, count, 1), "byte");
+        auto start = indexArgument(env, argumentAt(args, count, 2), "start", bytes.size(), 0);
+        auto end = indexArgument(env, argumentAt(args, count, 3), "end", bytes.size(), bytes.size());
+
+        if (start < end) {
+            std::memset(bytes.data() + start, byte, end - start);
+        }
+        return jsi::Value(env, target);
+    });
+
+    defineFunction(env, exports, "concat", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto list = argumentAt(args, count, 0).asObject(env).asArray(env);
+        auto length = list.size(env);
+
+        // Reading views runs getters, which may detach buffers read before, so bytes are only taken once all
+        // views are read, and no JS runs from then on
+        std::vector<ext::BufferView> views;
+        views.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            views.push_back(ext::viewOf(env, list.getValueAtIndex(env, i)));
+        }
+
+        std::vector<std::span<uint8_t>> parts;
+        parts.reserve(length);
+        size_t total = 0;
+        for (const auto& view : views) {
+            parts.push_back(view.bytes(env));
+            total += parts.back().size();
+        }
+
+        auto buffer = NativeBuffer::allocate(total);
+        auto* output = buffer->data();
+        for (const auto& part : parts) {
+            if (!part.empty()) {
+                std::memcpy(output, part.data(), part.size());
+                output += part.size();
+            }
+        }
+        return ext::toArrayBuffer(env, std::move(buffer));
+    });
+
+    //
+    // --------------------------------------------------------------------------------------------- Integer reads
+    //
+    defineRead<uint8_t>(env, exports, "readUint8");
+    defineRead<int8_t>(env, exports, "readInt8");
+    defineRead<uint16_t>(env, exports, "readUint16");
+    defineRead<int16_t>(env, exports, "readInt16");
+    defineRead<uint32_t>(env, exports, "readUint32");
+    defineRead<int32_t>(env, exports, "readInt32");
+    defineRead<float>(env, exports, "readFloat32");
+    defineRead<double>(env, exports, "readFloat64");
+    defineRead<uint64_t>(env, exports, "readBigUint64");
+    defineRead<int64_t>(env, exports, "readBigInt64");
+
+    return exports;
+}
+
+}
@@ -0,0 +1,33 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `bytes` module.
+ *
+ * Binary arguments are ArrayBuffers, typed arrays or DataViews. All operations run synchronously:
+ *
+ * - `toHex(data)`, `fromHex(string)`: lowercase hexadecimal digits, decoding accepts either case
+ * - `toBase64(data, { alphabet? }?)`, `fromBase64(string)`: alphabet is `'base64'` (default) or `'base64url'`
+ * - `indexOf(haystack, needle, fromIndex?)`: needle is a byte value, a string (as UTF-8) or binary data
+ * - `compare(a, b)`: -1, 0 or 1, comparing bytes lexicographically
+ * - `fill(target, byte, start?, end?)`: fills `target` in place, and returns it
+ * - `concat(list)`: single ArrayBuffer with contents of all binary values in `list`
+ * - `readUint8(data, offset)`, `readInt8`, `readUint16(data, offset, littleEndian?)`, `readInt16`, `readUint32`,
+ *   `readInt32`, `readFloat32`, `readFloat64`, `readBigUint64` and `readBigInt64`: same as DataView getters,
+ *   big endian unless `littleEndian` is `true`
+ *
+ * Decoded and concatenated data is returned as ArrayBuffer. Hex encoding and byte search use SIMD kernels
+ * selected for the CPU at runtime, see `ext::byteKernels`.
+ */
+auto createBytesModule(Environment& env) -> jsi::Object;
+
+}
@@ -0,0 +1,431 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "ChildProcess.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <fmt/format.h>
+#include <folly/Exception.h>
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/NativeClass.hpp>
+#include "BuiltinModules.hpp"
+
+extern char** environ;
+
+namespace higs::modules {
+
+namespace {
+
+/**
+ * Interval of polling exit of a child, when the kernel has no pidfd.
+ */
+constexpr std::chrono::milliseconds kExitPollInterval { 10 };
+
+struct Signal {
+    std::string_view name;
+    int number;
+};
+
+constexpr Signal kSignals[] = {
+    { "SIGHUP", SIGHUP },   { "SIGINT", SIGINT },   { "SIGQUIT", SIGQUIT }, { "SIGABRT", SIGABRT },
+    { "SIGKILL", SIGKILL }, { "SIGUSR1", SIGUSR1 }, { "SIGSEGV", SIGSEGV }, { "SIGUSR2", SIGUSR2 },
+    { "SIGPIPE", SIGPIPE }, { "SIGALRM", SIGALRM }, { "SIGTERM", SIGTERM }, { "SIGCONT", SIGCONT },
+    { "SIGSTOP", SIGSTOP }, { "SIGTSTP", SIGTSTP },
+};
+
+auto signalName(int number) -> std::string
+{
+    for (const auto& signal : kSignals) {
+        if (signal.number == number) {
+            return std::string(signal.name);
+        }
+    }
+    return std::to_string(number);
+}
+
+/**
+ * Parses signal given as a number, or a name like `'SIGTERM'`.
+ */
+auto signalArgument(Environment& env, const jsi::Value& value) -> int
+{
+    if (value.isUndefined()) {
+        return SIGTERM;
+    }
+    if (value.isNumber()) {
+        return static_cast<int>(integerArgument(env, value, "signal", NSIG - 1));
+    }
+    if (value.isString()) {
+        auto name = value.asString(env).utf8(env);
+        for (const auto& signal : kSignals) {
+            if (signal.name == name) {
+                return signal.number;
+            }
+        }
+        throw jsi::JSError(env, fmt::format("Unknown signal '{}'", name));
+    }
+    throw jsi::JSError(env, "Argument 'signal' must be a number or a name");
+}
+
+/**
+ * Ignores SIGPIPE, unless the embedder installed its own handler.
+ */
+void ignoreBrokenPipes() noexcept
+{
+    static std::once_flag once;
+    std::call_once(once, [] {
+        struct sigaction current {};
+        if (::sigaction(SIGPIPE, nullptr, &current) == 0 && current.sa_handler == SIG_DFL) {
+            ::signal(SIGPIPE, SIG_IGN);
+        }
+    });
+}
+
+void checkSpawnCall(int error, const char* what)
+{
+    if (error != 0) {
+        folly::throwSystemErrorExplicit(error, what);
+    }
+}
+
+auto processClass() -> const ext::NativeClass<ChildProcess>&
+{
+    static const auto binding
+        = ext::NativeClass<ChildProcess>("ChildProcess")
+              .method(
+                  "write",
+                  [](ChildProcess& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      std::string storage;
+                      auto data = ext::copyBytes(ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage));
+                      return jsrt::conv::toJS(self.write(ext::toIOBuf(std::move(data))), env);
+                  },
+                  1
+              )
+              .method(
+                  "end",
+                  [](ChildProcess& self, Environment&, const jsi::Value*, size_t) -> jsi::Value {
+                      self.end();
+                      return jsi::Value::undefined();
+                  }
+              )
+              .method(
+                  "kill",
+                  [](ChildProcess& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      auto signal = signalArgument(env, argumentAt(args, count, 0));
+                      try {
+                          self.kill(signal);
+                      }
+                      catch (const std::system_error& error) {
+                          throw jsi::JSError(env, fmt::format("Cannot kill process {}: {}", self.pid(), error.what()));
+                      }
+                      return jsi::Value::undefined();
+                  },
+                  1
+              )
+              .getter(
+                  "pid", [](ChildProcess& self, Environment&) -> jsi::Value { return static_cast<double>(self.pid()); }
+              )
+              .getter(
+                  "stdout",
+                  [](ChildProcess& self, Environment& env) -> jsi::Value {
+                      auto reader = self.stdoutReader();
+                      return reader ? toJS(std::move(reader), env) : jsi::Value::null();
+                  }
+              )
+              .getter(
+                  "stderr",
+                  [](ChildProcess& self, Environment& env) -> jsi::Value {
+                      auto reader = self.stderrReader();
+                      return reader ? toJS(std::move(reader), env) : jsi::Value::null();
+                  }
+              )
+              .getter("exited", [](ChildProcess& self, Environment& env) -> jsi::Value {
+                  return jsrt::conv::toJS(self.exited(), env);
+              });
+    return binding;
+}
+
+}
+
+auto toJS(const ExitStatus& status, jsrt::Environment& env) -> jsi::Value
+{
+    jsi::Object result { env };
+    result.setProperty(env, "code", status.code ? jsi::Value(*status.code) : jsi::Value::null());
+    result.setProperty(
+        env, "signal", status.signal ? jsi::Value(jsi::String::createFromUtf8(env, signalName(*status.signal))) : jsi::Value::null()
+    );
+    return result;
+}
+
+auto toJS(std::shared_ptr<ChildProcess> process, jsrt::Environment& env) -> jsi::Value
+{
+    return processClass().wrap(static_cast<Environment&>(env), std::move(process));
+}
+
+//
+// ------------------------------------------------------------------------------------------------- ExitHandler
+//
+/**
+ * Watches pidfd of the child, which becomes readable once it exits.
+ */
+class ChildProcess::ExitHandler final : public folly::EventHandler {
+public:
+    ExitHandler(ChildProcess& process, int pidfd) noexcept
+        : folly::EventHandler(&process._eventBase, folly::NetworkSocket::fromFd(pidfd)), _process(process), _pidfd(pidfd)
+    {
+    }
+
+    HIGS_MAKE_NON_COPYABLE(ExitHandler);
+
+    ~ExitHandler() noexcept override
+    {
+        unregisterHandler();
+        folly::closeNoInt(_pidfd);
+    }
+
+    void handlerReady(uint16_t) noexcept override
+    {
+        _process.tryReap();
+    }
+
+private:
+    ChildProcess& _process;
+    int _pidfd;
+};
+
+//
+// ------------------------------------------------------------------------------------------------- ChildProcess
+//
+auto ChildProcess::spawn(
+    folly::EventBase& eventBase,
+    const std::string& file,
+    const std::vector<std::string>& args,
+    const Options& options
+) -> std::shared_ptr<ChildProcess>
+{
+    ignoreBrokenPipes();
+
+    posix_spawn_file_actions_t actions;
+    checkSpawnCall(::posix_spawn_file_actions_init(&actions), "posix_spawn_file_actions_init");
+    SCOPE_EXIT
+    {
+        ::posix_spawn_file_actions_destroy(&actions);
+    };
+
+    // Ends of the pipes used by the parent, and by the child (closed once it is spawned)
+    std::array<folly::File, 3> parentEnds;
+    std::array<folly::File, 3> childEnds;
+    for (int fd = 0; fd < 3; ++fd) {
+        switch (options.stdio[fd]) {
+        case Stdio::Pipe: {
+            int ends[2];
+            if (::pipe2(ends, O_CLOEXEC) != 0) {
+                folly::throwSystemError("pipe");
+            }
+            folly::File readEnd { ends[0], true };
+            folly::File writeEnd { ends[1], true };
+            // Child gets blocking stdio, as it would expect
+            parentEnds[fd] = fd == STDIN_FILENO ? std::move(writeEnd) : std::move(readEnd);
+            childEnds[fd] = fd == STDIN_FILENO ? std::move(readEnd) : std::move(writeEnd);
+            if (::fcntl(parentEnds[fd].fd(), F_SETFL, O_NONBLOCK) != 0) {
+                folly::throwSystemError("fcntl");
+            }
+            checkSpawnCall(::posix_spawn_file_actions_adddup2(&actions, childEnds[fd].fd(), fd), "posix_spawn_file_actions_adddup2");
+            break;
+        }
+        case Stdio::Ignore:
+            checkSpawnCall(
+                ::posix_spawn_file_actions_addopen(&actions, fd, "/dev/null", fd == STDIN_FILENO ? O_RDONLY : O_WRONLY, 0),
+                "posix_spawn_file_actions_addopen"
+            );
+            break;
+        case Stdio::Inherit:
+            break;
+        }
+    }
+    if (!options.cwd.empty()) {
+        checkSpawnCall(::posix_spawn_file_actions_addchdir_np(&actions, options.cwd.c_str()), "posix_spawn_file_actions_addchdir_np");
+    }
+
+    posix_spawnattr_t attributes;
+    checkSpawnCall(::posix_spawnattr_init(&attributes), "posix_spawnattr_init");
+    SCOPE_EXIT
+    {
+        ::posix_spawnattr_destroy(&attributes);
+    };
+
+    // Ignored SIGPIPE would be inherited through exec, and the event base thread may block signals
+    sigset_t defaultSignals;
+    ::sigemptyset(&defaultSignals);
+    ::sigaddset(&defaultSignals, SIGPIPE);
+    sigset_t mask;
+    ::sigemptyset(&mask);
+    checkSpawnCall(::posix_spawnattr_setsigdefault(&attributes, &defaultSignals), "posix_spawnattr_setsigdefault");
+    checkSpawnCall(::posix_spawnattr_setsigmask(&attributes, &mask), "posix_spawnattr_setsigmask");
+    checkSpawnCall(::posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK), "posix_spawnattr_setflags");
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(file.c_str()));
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    std::vector<char*> envp;
+    if (options.env) {
+        for (const auto& entry : *options.env) {
+            envp.push_back(const_cast<char*>(entry.c_str()));
+        }
+        envp.push_back(nullptr);
+    }
+
+    pid_t pid = 0;
+    auto error = ::posix_spawnp(&pid, file.c_str(), &actions, &attributes, argv.data(), options.env ? envp.data() : environ);
+    if (error != 0) {
+        folly::throwSystemErrorExplicit(error, "spawn '", file, "'");
+    }
+
+    Pipes pipes {
+        .stdinFd = parentEnds[STDIN_FILENO] ? parentEnds[STDIN_FILENO].release() : -1,
+        .stdoutFd = parentEnds[STDOUT_FILENO] ? parentEnds[STDOUT_FILENO].release() : -1,
+        .stderrFd = parentEnds[STDERR_FILENO] ? parentEnds[STDERR_FILENO].release() : -1,
+    };
+    std::shared_ptr<ChildProcess> process { new ChildProcess(eventBase, pid, pipes, options.highWaterMark) };
+    process->watchExit();
+    return process;
+}
+
+ChildProcess::ChildProcess(folly::EventBase& eventBase, pid_t pid, const Pipes& pipes, size_t highWaterMark)
+    : _eventBase(eventBase), _pid(pid)
+{
+    if (pipes.stdinFd >= 0) {
+        _stdin = folly::AsyncPipeWriter::newWriter(&_eventBase, folly::NetworkSocket::fromFd(pipes.stdinFd));
+    }
+    if (pipes.stdoutFd >= 0) {
+        _stdout = folly::AsyncPipeReader::newReader(&_eventBase, folly::NetworkSocket::fromFd(pipes.stdoutFd));
+        _stdoutReader = std::make_unique<StreamReader>(*_stdout, highWaterMark);
+    }
+    if (pipes.stderrFd >= 0) {
+        _stderr = folly::AsyncPipeReader::newReader(&_eventBase, folly::NetworkSocket::fromFd(pipes.stderrFd));
+        _stderrReader = std::make_unique<StreamReader>(*_stderr, highWaterMark);
+    }
+}
+
+ChildProcess::~ChildProcess() noexcept = default;
+
+auto ChildProcess::stdoutReader() -> std::shared_ptr<StreamReader>
+{
+    if (!_stdoutReader) {
+        return nullptr;
+    }
+    return { shared_from_this(), _stdoutReader.get() };
+}
+
+auto ChildProcess::stderrReader() -> std::shared_ptr<StreamReader>
+{
+    if (!_stderrReader) {
+        return nullptr;
+    }
+    return { shared_from_this(), _stderrReader.get() };
+}
+
+auto ChildProcess::write(std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>
+{
+    if (!_stdin || _stdin->closed()) {
+        return folly::makeSemiFuture<folly::Unit>(std::logic_error("Stdin of the process is not piped, or was ended"));
+    }
+    return writeAsync(*_stdin, std::move(data));
+}
+
+void ChildProcess::end() noexcept
+{
+    if (_stdin) {
+        _stdin->closeOnEmpty();
+    }
+}
+
+void ChildProcess::kill(int signal)
+{
+    // Once reaped, the pid may already belong to another process
+    if (_reaped) {
+        return;
+    }
+    if (::kill(_pid, signal) != 0) {
+        folly::throwSystemError("kill");
+    }
+}
+
+auto ChildProcess::exited() -> folly::SemiFuture<ExitStatus>
+{
+    return _exited.getSemiFuture();
+}
+
+void ChildProcess::watchExit()
+{
+    _self = shared_from_this();
+
+#ifdef SYS_pidfd_open
+    auto pidfd = static_cast<int>(::syscall(SYS_pidfd_open, _pid, 0));
+    if (pidfd >= 0) {
+        _exitHandler = std::make_unique<ExitHandler>(*this, pidfd);
+        _exitHandler->registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
+        return;
+    }
+#endif
+
+    // Kernels before 5.3 have no pidfd
+    _exitPoll = folly::AsyncTimeout::make(_eventBase, [this]() noexcept {
+        if (!tryReap()) {
+            _exitPoll->scheduleTimeout(kExitPollInterval);
+        }
+    });
+    _exitPoll->scheduleTimeout(kExitPollInterval);
+}
+
+auto ChildProcess::tryReap() noexcept -> bool
+{
+    int status = 0;
+    auto result = ::waitpid(_pid, &status, WNOHANG);
+    if (result == 0 || (result < 0 && errno == EINTR)) {
+        return false;
+    }
+
+    // Without the child (ECHILD), it was reaped elsewhere, e.g. with SIGCHLD ignored, and its status is lost
+    ExitStatus exitStatus;
+    if (result == _pid) {
+        if (WIFEXITED(status)) {
+            exitStatus.code = WEXITSTATUS(status);
+        } else if (WIFSIGNALED(status)) {
+            exitStatus.signal = WTERMSIG(status);
+        }
+    }
+
+    _reaped = true;
+    if (_exitHandler) {
+        _exitHandler->unregisterHandler();
+    }
+    _exited.setValue(exitStatus);
+
+    // Handler or timeout calling this is released once it returns
+    _eventBase.runInLoop([self = std::move(_self)] {});
+    return true;
+}
+
+}
@@ -0,0 +1,192 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <folly/futures/Future.h>
+#include <folly/futures/SharedPromise.h>
+#include <folly/io/async/AsyncPipe.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+#include "StreamReader.hpp"
+
+namespace higs::modules {
+
+/**
+ * How a child process is exited, with either `code` or `signal` set.
+ */
+struct ExitStatus {
+    std::optional<int> code;
+    std::optional<int> signal;
+};
+
+auto toJS(const ExitStatus& status, jsrt::Environment& env) -> jsi::Value;
+
+/**
+ * Child process spawned with `posix_spawnp`, with its standard streams piped to an environment's event base.
+ *
+ * Output of the child is buffered by a `StreamReader` for each of stdout and stderr, up to `highWaterMark`
+ * bytes. Past that, the pipe fills up and the child blocks on its writes until JS reads more, so that
+ * a chatty child never grows memory of the parent.
+ *
+ * Exit of the child is watched through a pidfd when the kernel supports it, or else by polling `waitpid`.
+ * A process keeps itself alive until it is reaped, even when JS no longer references it, so that no zombie
+ * is left behind.
+ *
+ * Like its event base, a process is confined to the environment's thread.
+ */
+class ChildProcess final : public std::enable_shared_from_this<ChildProcess> {
+public:
+    /**
+     * Where a standard stream of the child is connected.
+     */
+    enum class Stdio {
+        Pipe,
+        Inherit,
+        Ignore,
+    };
+
+    struct Options {
+        /**
+         * Working directory of the child, or empty to inherit the parent's.
+         */
+        std::string cwd;
+
+        /**
+         * Environment of the child as `NAME=value` entries, or empty to inherit the parent's.
+         */
+        std::optional<std::vector<std::string>> env;
+
+        /**
+         * Stdin, stdout and stderr of the child.
+         */
+        std::array<Stdio, 3> stdio { Stdio::Pipe, Stdio::Pipe, Stdio::Pipe };
+
+        size_t highWaterMark = 1 << 20;
+    };
+
+    /**
+     * Spawns `file`, looked up in `PATH` unless it contains a slash, with `args` following its name.
+     *
+     * SIGPIPE is ignored in the parent from then on, if it had its default action, as writing to the stdin of
+     * a child which exited would otherwise kill the whole runtime. The child has SIGPIPE reset, and an empty
+     * signal mask.
+     *
+     * @throws std::system_error When the process cannot be spawned, e.g. when `file` is not found
+     */
+    static auto spawn(
+        folly::EventBase& eventBase,
+        const std::string& file,
+        const std::vector<std::string>& args,
+        const Options& options
+    ) -> std::shared_ptr<ChildProcess>;
+
+    HIGS_MAKE_NON_COPYABLE(ChildProcess);
+    ~ChildProcess() noexcept;
+
+    [[nodiscard]]
+    auto pid() const noexcept -> pid_t
+    {
+        return _pid;
+    }
+
+    /**
+     * Gets reader of stdout, or `nullptr` when it is not piped.
+     *
+     * Reader shares ownership of the process.
+     */
+    auto stdoutReader() -> std::shared_ptr<StreamReader>;
+
+    /**
+     * Gets reader of stderr, or `nullptr` when it is not piped.
+     */
+    auto stderrReader() -> std::shared_ptr<StreamReader>;
+
+    /**
+     * Writes `data` to stdin, and completes once it is handed to the kernel.
+     *
+     * Fails when stdin is not piped, or was ended.
+     */
+    auto write(std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>;
+
+    /**
+     * Closes stdin once pending writes complete, e.g. for the child to see end of its input.
+     */
+    void end() noexcept;
+
+    /**
+     * Sends `signal` to the child, unless it was already reaped.
+     *
+     * @throws std::system_error When the signal cannot be sent
+     */
+    void kill(int signal);
+
+    /**
+     * Completes once the child exits.
+     */
+    auto exited() -> folly::SemiFuture<ExitStatus>;
+
+private:
+    class ExitHandler;
+
+    struct Pipes {
+        int stdinFd = -1;
+        int stdoutFd = -1;
+        int stderrFd = -1;
+    };
+
+    ChildProcess(folly::EventBase& eventBase, pid_t pid, const Pipes& pipes, size_t highWaterMark);
+
+    /**
+     * Starts watching exit of the child, using pidfd or else polling.
+     */
+    void watchExit();
+
+    /**
+     * Reaps the child if it exited, and completes `exited`.
+     *
+     * @return Whether the child was reaped
+     */
+    auto tryReap() noexcept -> bool;
+
+    folly::EventBase& _eventBase;
+    pid_t _pid;
+    bool _reaped = false;
+
+    folly::AsyncPipeWriter::UniquePtr _stdin;
+    folly::AsyncPipeReader::UniquePtr _stdout;
+    folly::AsyncPipeReader::UniquePtr _stderr;
+    std::unique_ptr<StreamReader> _stdoutReader;
+    std::unique_ptr<StreamReader> _stderrReader;
+
+    std::unique_ptr<ExitHandler> _exitHandler;
+    std::unique_ptr<folly::AsyncTimeout> _exitPoll;
+    folly::SharedPromise<ExitStatus> _exited;
+
+    /**
+     * Reference keeping the process alive until the child is reaped.
+     */
+    std::shared_ptr<ChildProcess> _self;
+};
+
+/**
+ * Converts process to JS object.
+ *
+ * Object has properties `pid`, `stdout` and `stderr` (readers with `read()`, or `null` when not piped),
+ * and `exited`, methods `write(data)`, `end()` and `kill(signal)`.
+ */
+auto toJS(std::shared_ptr<ChildProcess> process, jsrt::Environment& env) -> jsi::Value;
+
+}
@@ -0,0 +1,138 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "ChildProcessModule.hpp"
+
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fmt/format.h>
+#include "BuiltinModules.hpp"
+#include "ChildProcess.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+constexpr int64_t kMaxHighWaterMark = int64_t(1) << 30;
+
+auto stdioOf(Environment& env, const jsi::Value& value) -> ChildProcess::Stdio
+{
+    auto name = value.isString() ? value.asString(env).utf8(env) : std::string();
+    if (name == "pipe") {
+        return ChildProcess::Stdio::Pipe;
+    }
+    if (name == "inherit") {
+        return ChildProcess::Stdio::Inherit;
+    }
+    if (name == "ignore") {
+        return ChildProcess::Stdio::Ignore;
+    }
+    throw jsi::JSError(env, "Option 'stdio' must be 'pipe', 'inherit' or 'ignore', or an array of these");
+}
+
+auto argumentsOf(Environment& env, const jsi::Value& value) -> std::vector<std::string>
+{
+    std::vector<std::string> args;
+    if (value.isUndefined()) {
+        return args;
+    }
+    if (!value.isObject() || !value.getObject(env).isArray(env)) {
+        throw jsi::JSError(env, "Argument 'args' must be an array of strings");
+    }
+
+    auto array = value.getObject(env).getArray(env);
+    auto length = array.size(env);
+    args.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        auto arg = array.getValueAtIndex(env, i);
+        if (!arg.isString()) {
+            throw jsi::JSError(env, "Argument 'args' must be an array of strings");
+        }
+        args.push_back(arg.asString(env).utf8(env));
+    }
+    return args;
+}
+
+auto optionsOf(Environment& env, const jsi::Value& value) -> ChildProcess::Options
+{
+    ChildProcess::Options options;
+    if (value.isUndefined()) {
+        return options;
+    }
+    if (!value.isObject()) {
+        throw jsi::JSError(env, "Argument 'options' must be an object");
+    }
+    auto object = value.getObject(env);
+
+    auto cwd = object.getProperty(env, "cwd");
+    if (!cwd.isUndefined()) {
+        options.cwd = jsrt::fromJS<std::string>(cwd, env);
+    }
+
+    auto environment = object.getProperty(env, "env");
+    if (!environment.isUndefined()) {
+        if (!environment.isObject()) {
+            throw jsi::JSError(env, "Option 'env' must be an object");
+        }
+        auto variables = environment.getObject(env);
+        auto names = variables.getPropertyNames(env);
+        options.env.emplace();
+        for (size_t i = 0; i < names.size(env); ++i) {
+            auto name = names.getValueAtIndex(env, i).asString(env).utf8(env);
+            auto variable = variables.getProperty(env, name.c_str());
+            options.env->push_back(name + "=" + variable.toString(env).utf8(env));
+        }
+    }
+
+    auto stdio = object.getProperty(env, "stdio");
+    if (stdio.isObject() && stdio.getObject(env).isArray(env)) {
+        auto array = stdio.getObject(env).getArray(env);
+        if (array.size(env) != options.stdio.size()) {
+            throw jsi::JSError(env, "Option 'stdio' must have an entry for each of stdin, stdout and stderr");
+        }
+        for (size_t i = 0; i < options.stdio.size(); ++i) {
+            options.stdio[i] = stdioOf(env, array.getValueAtIndex(env, i));
+        }
+    } else if (!stdio.isUndefined()) {
+        options.stdio.fill(stdioOf(env, stdio));
+    }
+
+    auto highWaterMark = object.getProperty(env, "highWaterMark");
+    if (!highWaterMark.isUndefined()) {
+        auto size = integerArgument(env, highWaterMark, "highWaterMark", 1, kMaxHighWaterMark);
+        options.highWaterMark = static_cast<size_t>(size);
+    }
+
+    return options;
+}
+
+}
+
+auto createChildProcessModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+
+    defineFunction(env, exports, "spawn", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto file = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        auto arguments = argumentsOf(env, argumentAt(args, count, 1));
+        auto options = optionsOf(env, argumentAt(args, count, 2));
+
+        std::shared_ptr<ChildProcess> process;
+        try {
+            process = ChildProcess::spawn(env.eventBase(), file, arguments, options);
+        }
+        catch (const std::system_error& error) {
+            throw jsi::JSError(env, fmt::format("Cannot spawn '{}': {}", file, error.code().message()));
+        }
+        return toJS(std::move(process), env);
+    });
+
+    return exports;
+}
+
+}
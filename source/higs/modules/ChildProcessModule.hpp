@@ -0,0 +1,27 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `child_process` module, processes with stdio piped to the environment's own
+ * event base, so that many of them run in parallel without blocking JS.
+ *
+ * - `spawn(file, args?, options?)`: spawns `file` (looked up in `PATH`) with array of string `args`, and returns
+ *   the process; options are `cwd`, `env` (object replacing the parent's environment), `stdio` (`'pipe'`,
+ *   `'inherit'` or `'ignore'`, or an array of these for stdin, stdout and stderr) and `highWaterMark`
+ *
+ * Processes have `pid`, `stdout` and `stderr` with `read()`, a promise of following output ArrayBuffer (`null`
+ * at end of stream), `write(data)` and `end()` for stdin, `kill(signal?)` sending a signal number or name
+ * (`'SIGTERM'` by default), and `exited`, a promise of `{ code, signal }`. See `ChildProcess` for buffering.
+ */
+auto createChildProcessModule(Environment& env) -> jsi::Object;
+
+}
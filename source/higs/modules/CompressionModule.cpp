@@ -0,0 +1,202 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "CompressionModule.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <zstd.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/Compression.hpp>
+#include <higs/ext/NativeClass.hpp>
+#include "BuiltinModules.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+using ext::CompressionFormat;
+using ext::CompressionStream;
+
+/**
+ * Size of input from which async functions process it off the JS thread.
+ */
+constexpr size_t kBackgroundThreshold = 64 << 10;
+
+constexpr size_t kDefaultBlockSize = 4 << 20;
+constexpr int64_t kMaxBlockSize = int64_t(1) << 30;
+
+struct CompressOptions {
+    std::optional<int> level;
+    bool parallel = false;
+    size_t blockSize = kDefaultBlockSize;
+};
+
+auto formatArgument(Environment& env, const jsi::Value& value) -> CompressionFormat
+{
+    auto name = jsrt::fromJS<std::string>(value, env);
+    auto format = ext::findCompressionFormat(name);
+    if (!format) {
+        throw jsi::JSError(env, fmt::format("Unknown compression format '{}'", name));
+    }
+    return *format;
+}
+
+auto parseCompressOptions(Environment& env, const jsi::Value& value) -> CompressOptions
+{
+    CompressOptions options;
+    if (value.isUndefined()) {
+        return options;
+    }
+
+    auto object = value.asObject(env);
+    auto level = object.getProperty(env, "level");
+    if (!level.isUndefined()) {
+        if (!level.isNumber()) {
+            throw jsi::JSError(env, "Option 'level' must be a number");
+        }
+        if (!std::isfinite(level.asNumber())) {
+            throwError(env, "RangeError", "Option 'level' must be finite");
+        }
+        // Widest range of supported formats, formats with a narrower one reject levels outside of it
+        options.level = static_cast<int>(std::clamp<double>(level.asNumber(), ZSTD_minCLevel(), ZSTD_maxCLevel()));
+    }
+
+    auto parallel = object.getProperty(env, "parallel");
+    options.parallel = parallel.isBool() && parallel.getBool();
+
+    auto blockSize = object.getProperty(env, "blockSize");
+    if (!blockSize.isUndefined()) {
+        auto size = integerArgument(env, blockSize, "blockSize", ext::kMinBlockSize, kMaxBlockSize);
+        options.blockSize = static_cast<size_t>(size);
+    }
+    return options;
+}
+
+/**
+ * Copies data for processing off the JS thread, shared by tasks of parallel blocks.
+ */
+auto copyOf(std::span<const uint8_t> data) -> std::shared_ptr<const std::vector<uint8_t>>
+{
+    return std::make_shared<const std::vector<uint8_t>>(ext::copyBytes(data));
+}
+
+auto backgroundExecutor(Environment& env) -> folly::Executor::KeepAlive<>
+{
+    return folly::getKeepAliveToken(env.host().platform().getBackgroundExecutor());
+}
+
+auto compressionStreamClass() -> const ext::NativeClass<CompressionStream>&
+{
+    static const auto binding
+        = ext::NativeClass<CompressionStream>("CompressionStream")
+              .method(
+                  "write",
+                  [](CompressionStream& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      if (self.finished()) {
+                          throw jsi::JSError(env, "Stream is already ended");
+                      }
+                      std::string storage;
+                      return ext::toArrayBuffer(env, self.write(ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage)));
+                  },
+                  1
+              )
+              .method(
+                  "end",
+                  [](CompressionStream& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      if (self.finished()) {
+                          throw jsi::JSError(env, "Stream is already ended");
+                      }
+                      const auto& data = argumentAt(args, count, 0);
+                      if (data.isUndefined()) {
+                          return ext::toArrayBuffer(env, self.finish());
+                      }
+                      std::string storage;
+                      return ext::toArrayBuffer(env, self.finish(ext::bytesOrUtf8Of(env, data, storage)));
+                  },
+                  1
+              );
+    return binding;
+}
+
+}
+
+auto createCompressionModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+
+    defineFunction(env, exports, "compress", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        auto options = parseCompressOptions(env, argumentAt(args, count, 2));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+        return ext::toArrayBuffer(env, ext::compress(format, data, options.level));
+    });
+
+    defineFunction(env, exports, "decompress", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+        return ext::toArrayBuffer(env, ext::decompress(format, data));
+    });
+
+    defineFunction(env, exports, "compressAsync", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        auto options = parseCompressOptions(env, argumentAt(args, count, 2));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+
+        if (options.parallel) {
+            if (format != CompressionFormat::Zstd) {
+                throw jsi::JSError(env, "Parallel compression is only supported for zstd");
+            }
+            return jsrt::conv::toJS(ext::compressBlocks(copyOf(data), options.blockSize, options.level, backgroundExecutor(env)), env);
+        }
+
+        if (data.size() < kBackgroundThreshold) {
+            return jsrt::conv::toJS(folly::makeSemiFuture(ext::compress(format, data, options.level)), env);
+        }
+        return runInBackground(env, [format, level = options.level, input = copyOf(data)] {
+            return ext::compress(format, *input, level);
+        });
+    });
+
+    defineFunction(env, exports, "decompressAsync", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+
+        if (data.size() < kBackgroundThreshold) {
+            return jsrt::conv::toJS(folly::makeSemiFuture(ext::decompress(format, data)), env);
+        }
+        if (format == CompressionFormat::Zstd) {
+            return jsrt::conv::toJS(ext::decompressBlocks(copyOf(data), backgroundExecutor(env)), env);
+        }
+        return runInBackground(env, [format, input = copyOf(data)] { return ext::decompress(format, *input); });
+    });
+
+    defineFunction(env, exports, "createCompressor", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        auto options = parseCompressOptions(env, argumentAt(args, count, 1));
+        auto stream = std::make_shared<CompressionStream>(format, CompressionStream::Mode::Compress, options.level);
+        return compressionStreamClass().wrap(env, std::move(stream));
+    });
+
+    defineFunction(env, exports, "createDecompressor", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto format = formatArgument(env, argumentAt(args, count, 0));
+        auto stream = std::make_shared<CompressionStream>(format, CompressionStream::Mode::Decompress);
+        return compressionStreamClass().wrap(env, std::move(stream));
+    });
+
+    return exports;
+}
+
+}
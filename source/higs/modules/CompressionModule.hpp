@@ -0,0 +1,33 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `compression` module.
+ *
+ * Formats are `'gzip'`, `'deflate'` (zlib) and `'zstd'`. Data is binary, or a string compressed as UTF-8, output is
+ * an ArrayBuffer.
+ *
+ * - `compress(format, data, { level? }?)`, `decompress(format, data)`: synchronous, on the JS thread
+ * - `compressAsync(format, data, { level?, parallel?, blockSize? }?)`, `decompressAsync(format, data)`: promises,
+ *   inputs of at least 64 KiB are copied and processed on the runtime's background executor
+ * - `createCompressor(format, { level? }?)`, `createDecompressor(format)`: streams with `write(data)` and
+ *   `end(data?)`, each returning output produced so far
+ *
+ * With `parallel: true`, zstd input is compressed as independent frames of `blockSize` bytes (4 MiB by default)
+ * on all background threads. `decompressAsync` decompresses such multi-frame zstd data in parallel too, see
+ * `ext::compressBlocks`.
+ *
+ * Levels are clamped to those zstd supports, `blockSize` is an integer from 4 KiB to 1 GiB.
+ */
+auto createCompressionModule(Environment& env) -> jsi::Object;
+
+}
@@ -0,0 +1,153 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "DigestModule.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/ByteKernels.hpp>
+#include <higs/ext/Digest.hpp>
+#include <higs/ext/NativeClass.hpp>
+#include "BuiltinModules.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+using ext::Digest;
+using ext::DigestAlgorithm;
+using ext::NativeBuffer;
+
+/**
+ * Size of input from which `hashAsync` hashes off the JS thread.
+ *
+ * Smaller inputs hash faster than it takes to copy them and hop between threads.
+ */
+constexpr size_t kBackgroundThreshold = 64 << 10;
+
+auto algorithmArgument(Environment& env, const jsi::Value& value) -> DigestAlgorithm
+{
+    auto name = jsrt::fromJS<std::string>(value, env);
+    auto algorithm = ext::findDigestAlgorithm(name);
+    if (!algorithm) {
+        throw jsi::JSError(env, fmt::format("Unknown digest algorithm '{}'", name));
+    }
+    return *algorithm;
+}
+
+/**
+ * Whether digest is requested as hex string, instead of ArrayBuffer.
+ */
+auto hexArgument(Environment& env, const jsi::Value& value) -> bool
+{
+    if (value.isUndefined()) {
+        return false;
+    }
+
+    auto encoding = jsrt::fromJS<std::string>(value, env);
+    if (encoding != "hex") {
+        throw jsi::JSError(env, fmt::format("Unknown digest encoding '{}'", encoding));
+    }
+    return true;
+}
+
+auto toHex(const std::shared_ptr<NativeBuffer>& digest) -> std::string
+{
+    std::string digits(digest->size() * 2, '\0');
+    ext::byteKernels().hexEncode(digest->data(), digest->size(), digits.data());
+    return digits;
+}
+
+auto toDigestValue(Environment& env, std::shared_ptr<NativeBuffer> digest, bool hex) -> jsi::Value
+{
+    if (hex) {
+        auto digits = toHex(digest);
+        return jsi::String::createFromAscii(env, digits.data(), digits.size());
+    }
+    return ext::toArrayBuffer(env, std::move(digest));
+}
+
+auto digestClass() -> const ext::NativeClass<Digest>&
+{
+    static const auto binding
+        = ext::NativeClass<Digest>("Digest")
+              .method(
+                  "update",
+                  [](Digest& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      if (self.finished()) {
+                          throw jsi::JSError(env, "Digest is already finished");
+                      }
+                      std::string storage;
+                      self.update(ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage));
+                      return jsi::Value::undefined();
+                  },
+                  1
+              )
+              .method(
+                  "digest",
+                  [](Digest& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      if (self.finished()) {
+                          throw jsi::JSError(env, "Digest is already finished");
+                      }
+                      return toDigestValue(env, self.finish(), hexArgument(env, argumentAt(args, count, 0)));
+                  },
+                  1
+              )
+              .getter("algorithm", [](Digest& self, Environment& env) {
+                  auto name = ext::nameOf(self.algorithm());
+                  return jsi::Value(jsi::String::createFromAscii(env, name.data(), name.size()));
+              });
+    return binding;
+}
+
+}
+
+auto createDigestModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+
+    defineFunction(env, exports, "hash", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto algorithm = algorithmArgument(env, argumentAt(args, count, 0));
+        auto hex = hexArgument(env, argumentAt(args, count, 2));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+        return toDigestValue(env, Digest::compute(algorithm, data), hex);
+    });
+
+    defineFunction(env, exports, "hashAsync", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto algorithm = algorithmArgument(env, argumentAt(args, count, 0));
+        auto hex = hexArgument(env, argumentAt(args, count, 2));
+        std::string storage;
+        auto data = ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage);
+
+        if (data.size() < kBackgroundThreshold) {
+            auto digest = Digest::compute(algorithm, data);
+            if (hex) {
+                return jsrt::conv::toJS(folly::makeSemiFuture(toHex(digest)), env);
+            }
+            return jsrt::conv::toJS(folly::makeSemiFuture(std::move(digest)), env);
+        }
+
+        auto copy = ext::copyBytes(data);
+        if (hex) {
+            return runInBackground(env, [algorithm, copy = std::move(copy)] { return toHex(Digest::compute(algorithm, copy)); });
+        }
+        return runInBackground(env, [algorithm, copy = std::move(copy)] { return Digest::compute(algorithm, copy); });
+    });
+
+    defineFunction(env, exports, "createHash", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto algorithm = algorithmArgument(env, argumentAt(args, count, 0));
+        return digestClass().wrap(env, std::make_shared<Digest>(algorithm));
+    });
+
+    return exports;
+}
+
+}
@@ -0,0 +1,26 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `digest` module.
+ *
+ * Algorithms are `'sha1'`, `'sha256'`, `'sha512'`, `'xxh64'`, `'xxh3'` and `'crc32c'`, see `ext::Digest`. Data is
+ * binary, or a string hashed as UTF-8. Digests are ArrayBuffers, or lowercase hex strings when `encoding` is `'hex'`.
+ *
+ * - `hash(algorithm, data, encoding?)`: digest computed synchronously, on the JS thread
+ * - `hashAsync(algorithm, data, encoding?)`: promise of digest, inputs of at least 64 KiB are copied and hashed
+ *   on the runtime's background executor, smaller ones are hashed synchronously
+ * - `createHash(algorithm)`: object computing digest incrementally, with `update(data)` and `digest(encoding?)`
+ */
+auto createDigestModule(Environment& env) -> jsi::Object;
+
+}
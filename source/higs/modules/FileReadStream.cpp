@@ -0,0 +1,273 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "FileReadStream.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <higs/jsrt/FileEngine.hpp>
+#include <higs/jsrt/Runtime.hpp>
+#include "BuiltinModules.hpp"
+
+namespace higs::modules {
+
+auto toJS(const FileChunk& chunk, jsrt::Environment& env) -> jsi::Value
+{
+    jsi::Object result { env };
+    result.setProperty(env, "value", chunk.buffer ? jsi::Value(ext::toArrayBuffer(env, chunk.buffer)) : jsi::Value::undefined());
+    result.setProperty(env, "done", chunk.done);
+    return result;
+}
+
+auto FileReadStream::open(Environment& env, std::string path, Options options) -> std::shared_ptr<FileReadStream>
+{
+    auto stream = std::make_shared<FileReadStream>(env, options);
+
+    auto& executor = env.host().platform().getIOExecutor();
+    auto opened = folly::via(folly::getKeepAliveToken(executor), [path = std::move(path)] {
+        auto fd = folly::openNoInt(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            folly::throwSystemError("open '", path, "'");
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            folly::closeNoInt(fd);
+            throw std::runtime_error(fmt::format("Cannot stream '{}', it is not a regular file", path));
+        }
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        return OpenedFile { .fd = fd, .size = static_cast<uint64_t>(info.st_size) };
+    });
+    continueOnEnvironment(env, std::move(opened).semi(), [stream](folly::Try<OpenedFile>&& result) {
+        stream->onOpened(std::move(result));
+    });
+
+    return stream;
+}
+
+FileReadStream::FileReadStream(Environment& env, Options options) noexcept
+    : _env(env), _options(options)
+{
+}
+
+FileReadStream::~FileReadStream() noexcept
+{
+    if (_fd >= 0) {
+        folly::closeNoInt(_fd);
+    }
+}
+
+auto FileReadStream::next() -> folly::SemiFuture<FileChunk>
+{
+    if (_pending) {
+        return folly::makeSemiFuture<FileChunk>(std::runtime_error("Previous chunk of the stream is still awaited"));
+    }
+
+    auto [promise, future] = folly::makePromiseContract<FileChunk>();
+    _pending = std::move(promise);
+    deliver();
+    return std::move(future);
+}
+
+void FileReadStream::close()
+{
+    if (_closed) {
+        return;
+    }
+
+    _closed = true;
+    deliver();
+    closeFileWhenIdle();
+}
+
+void FileReadStream::onOpened(folly::Try<OpenedFile>&& result)
+{
+    if (result.hasException()) {
+        _error = std::move(result.exception());
+        deliver();
+        return;
+    }
+
+    if (_closed) {
+        folly::closeNoInt(result->fd);
+        return;
+    }
+
+    _fd = result->fd;
+    _size = result->size;
+    _opened = true;
+    _chunkCount = static_cast<size_t>((_size + _options.chunkSize - 1) / _options.chunkSize);
+
+    // Files smaller than the pool get a buffer per chunk, and no more
+    auto bufferSize = static_cast<size_t>(std::min<uint64_t>(_options.chunkSize, _size));
+    _slots.resize(std::min(_options.readahead + 1, _chunkCount));
+    for (auto& slot : _slots) {
+        slot.buffer = ext::NativeBuffer::allocate(bufferSize);
+    }
+
+    fill();
+    deliver();
+    closeFileWhenIdle();
+}
+
+void FileReadStream::onRead(size_t chunk, folly::Try<size_t>&& result)
+{
+    --_readsInFlight;
+
+    if (result.hasException()) {
+        if (!_error) {
+            _error = std::move(result.exception());
+        }
+    }
+    else if (!_closed) {
+        slotOf(chunk).bytesRead = *result;
+        // File was truncated meanwhile, it now ends within this chunk
+        if (*result < chunkLength(chunk)) {
+            _chunkCount = std::min(_chunkCount, *result == 0 ? chunk : chunk + 1);
+        }
+    }
+
+    deliver();
+    closeFileWhenIdle();
+}
+
+void FileReadStream::fill()
+{
+    if (!_opened || _closed || _error) {
+        return;
+    }
+
+    // Chunk before `_nextYield` is still used by the consumer, with a pool of `readahead + 1` buffers
+    // no chunk in this window shares its buffer
+    auto first = _nextRead;
+    auto end = std::min(_nextYield + _options.readahead, _chunkCount);
+    std::vector<FileReadRequest> requests;
+    for (; _nextRead < end; ++_nextRead) {
+        auto& slot = slotOf(_nextRead);
+        slot.bytesRead.reset();
+        requests.push_back({
+            .fd = _fd,
+            .buffer = slot.buffer->bytes().first(chunkLength(_nextRead)),
+            .offset = static_cast<uint64_t>(_nextRead) * _options.chunkSize,
+        });
+    }
+    if (requests.empty()) {
+        return;
+    }
+
+    auto results = _env.host().platform().getFileEngine().read(requests);
+    _readsInFlight += results.size();
+    for (size_t i = 0; i < results.size(); ++i) {
+        continueOnEnvironment(_env, std::move(results[i]), [self = shared_from_this(), chunk = first + i](folly::Try<size_t>&& result) {
+            self->onRead(chunk, std::move(result));
+        });
+    }
+}
+
+void FileReadStream::deliver()
+{
+    if (!_pending) {
+        return;
+    }
+
+    auto complete = [this](folly::Try<FileChunk>&& chunk) {
+        auto pending = std::move(*_pending);
+        _pending.reset();
+        pending.setTry(std::move(chunk));
+    };
+
+    if (_closed) {
+        complete(folly::Try<FileChunk>(FileChunk { .done = true }));
+        return;
+    }
+    if (_error) {
+        complete(folly::Try<FileChunk>(_error));
+        return;
+    }
+    if (!_opened) {
+        return;
+    }
+    if (_nextYield >= _chunkCount) {
+        complete(folly::Try<FileChunk>(FileChunk { .done = true }));
+        return;
+    }
+
+    auto& slot = slotOf(_nextYield);
+    if (_nextYield >= _nextRead || !slot.bytesRead) {
+        return;
+    }
+
+    // Short chunk is copied, as JS cannot see only part of a pooled buffer
+    auto buffer = slot.buffer;
+    if (*slot.bytesRead < buffer->size()) {
+        buffer = ext::NativeBuffer::allocate(*slot.bytesRead);
+        std::memcpy(buffer->data(), slot.buffer->data(), buffer->size());
+    }
+
+    ++_nextYield;
+    complete(folly::Try<FileChunk>(FileChunk { .buffer = std::move(buffer) }));
+    fill();
+    closeFileWhenIdle();
+}
+
+void FileReadStream::closeFileWhenIdle() noexcept
+{
+    auto ended = _closed || _error || (_opened && _nextYield >= _chunkCount);
+    if (!ended || _readsInFlight > 0) {
+        return;
+    }
+
+    if (_fd >= 0) {
+        folly::closeNoInt(_fd);
+        _fd = -1;
+    }
+    _slots.clear();
+}
+
+auto FileReadStream::chunkLength(size_t chunk) const noexcept -> size_t
+{
+    auto offset = static_cast<uint64_t>(chunk) * _options.chunkSize;
+    return static_cast<size_t>(std::min<uint64_t>(_options.chunkSize, _size - offset));
+}
+
+auto toAsyncIterator(Environment& env, std::shared_ptr<FileReadStream> stream) -> jsi::Object
+{
+    jsi::Object iterator { env };
+
+    defineFunction(env, iterator, "next", 0, [stream](Environment& env, const jsi::Value*, size_t) {
+        return jsrt::conv::toJS(stream->next(), env);
+    });
+
+    // Called when `for await` loop is left early
+    defineFunction(env, iterator, "return", 0, [stream](Environment& env, const jsi::Value*, size_t) {
+        stream->close();
+        return jsrt::conv::toJS(folly::makeSemiFuture(FileChunk { .done = true }), env);
+    });
+
+    auto asyncIterator = env.globalObject().getPropertyAsObject(env, "Symbol").getProperty(env, "asyncIterator");
+    iterator.setProperty(
+        env,
+        jsi::PropNameID::forSymbol(env, asyncIterator.getSymbol(env)),
+        jsi::Function::createFromHostFunction(
+            env,
+            jsi::PropNameID::forAscii(env, "[Symbol.asyncIterator]"),
+            0,
+            [](jsi::Runtime& rt, const jsi::Value& thisValue, const jsi::Value*, size_t) { return jsi::Value(rt, thisValue); }
+        )
+    );
+
+    return iterator;
+}
+
+}
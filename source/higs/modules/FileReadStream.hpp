@@ -0,0 +1,151 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <folly/ExceptionWrapper.h>
+#include <folly/futures/Future.h>
+#include <higs/common.hpp>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Chunk yielded by `FileReadStream`, converted to an iterator result `{ value, done }`.
+ */
+struct FileChunk {
+    std::shared_ptr<ext::NativeBuffer> buffer;
+    bool done = false;
+};
+
+auto toJS(const FileChunk& chunk, jsrt::Environment& env) -> jsi::Value;
+
+/**
+ * Reads a file sequentially in fixed-size chunks, ahead of its consumer.
+ *
+ * Chunks are read by the runtime's file engine into a pool of `readahead + 1` buffers, allocated once. A buffer
+ * is reused when the chunk in it has been consumed, so reading any size of file allocates no more chunks.
+ * At most `readahead` chunks are read before being asked for, so a slow consumer pauses reading.
+ *
+ * Yielded chunk stays valid until the `next` call after the one yielding it, consumer keeping its data longer
+ * must copy it (e.g. `chunk.slice(0)`). Only the last chunk of a file is shorter than `chunkSize`, and is
+ * always a copy.
+ *
+ * State is confined to the environment's thread, reads complete there using `Environment::runLater`.
+ */
+class FileReadStream final : public std::enable_shared_from_this<FileReadStream> {
+public:
+    struct Options {
+        size_t chunkSize = 256 << 10;
+        size_t readahead = 4;
+    };
+
+    /**
+     * Creates stream of file at `path`, and starts opening it on the I/O executor.
+     */
+    static auto open(Environment& env, std::string path, Options options) -> std::shared_ptr<FileReadStream>;
+
+    FileReadStream(Environment& env, Options options) noexcept;
+    HIGS_MAKE_NON_COPYABLE(FileReadStream);
+    ~FileReadStream() noexcept;
+
+    /**
+     * Gets following chunk, or `done` chunk at end of file.
+     *
+     * Only one call may be pending at a time.
+     */
+    auto next() -> folly::SemiFuture<FileChunk>;
+
+    /**
+     * Stops reading, and closes the file once no read is in flight.
+     *
+     * Pending `next` completes with `done` chunk.
+     */
+    void close();
+
+    /**
+     * Whether the file is open, which it stays until the stream ends or is closed, and no read is in flight.
+     */
+    [[nodiscard]]
+    auto isFileOpen() const noexcept -> bool
+    {
+        return _fd >= 0;
+    }
+
+    /**
+     * Number of chunk buffers allocated, released along with the file.
+     */
+    [[nodiscard]]
+    auto bufferCount() const noexcept -> size_t
+    {
+        return _slots.size();
+    }
+
+private:
+    struct OpenedFile {
+        int fd;
+        uint64_t size;
+    };
+
+    struct Slot {
+        std::shared_ptr<ext::NativeBuffer> buffer;
+        std::optional<size_t> bytesRead;
+    };
+
+    void onOpened(folly::Try<OpenedFile>&& result);
+    void onRead(size_t chunk, folly::Try<size_t>&& result);
+
+    /**
+     * Submits reads of chunks within readahead window, whose buffers are not in use, as one batch.
+     */
+    void fill();
+
+    /**
+     * Completes pending `next` call, when its chunk is ready or reading stopped.
+     */
+    void deliver();
+
+    /**
+     * Closes the file once no more chunks are read from it (as the stream ended, failed or was closed), and no
+     * read is in flight.
+     */
+    void closeFileWhenIdle() noexcept;
+
+    auto slotOf(size_t chunk) noexcept -> Slot&
+    {
+        return _slots[chunk % _slots.size()];
+    }
+
+    auto chunkLength(size_t chunk) const noexcept -> size_t;
+
+    Environment& _env;
+    Options _options;
+
+    int _fd = -1;
+    uint64_t _size = 0;
+    bool _opened = false;
+    bool _closed = false;
+    folly::exception_wrapper _error;
+
+    std::vector<Slot> _slots;
+    size_t _chunkCount = 0;
+    size_t _nextRead = 0;
+    size_t _nextYield = 0;
+    size_t _readsInFlight = 0;
+    std::optional<folly::Promise<FileChunk>> _pending;
+};
+
+/**
+ * Creates JS async iterator over chunks of `stream`, usable in `for await`.
+ */
+auto toAsyncIterator(Environment& env, std::shared_ptr<FileReadStream> stream) -> jsi::Object;
+
+}
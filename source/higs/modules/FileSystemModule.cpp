@@ -0,0 +1,283 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "FileSystemModule.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <climits>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/jsrt/FileEngine.hpp>
+#include "BuiltinModules.hpp"
+#include "FileReadStream.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+struct FileStat {
+    uint64_t size;
+    uint32_t mode;
+    double mtimeMs;
+    bool isFile;
+    bool isDirectory;
+};
+
+auto toJS(const FileStat& stat, jsrt::Environment& env) -> jsi::Value
+{
+    jsi::Object result { env };
+    result.setProperty(env, "size", static_cast<double>(stat.size));
+    result.setProperty(env, "mode", static_cast<double>(stat.mode));
+    result.setProperty(env, "mtimeMs", stat.mtimeMs);
+    result.setProperty(env, "isFile", stat.isFile);
+    result.setProperty(env, "isDirectory", stat.isDirectory);
+    return result;
+}
+
+struct DirectoryEntries {
+    std::vector<std::string> names;
+};
+
+auto toJS(const DirectoryEntries& entries, jsrt::Environment& env) -> jsi::Value
+{
+    jsi::Array result { env, entries.names.size() };
+    for (size_t i = 0; i < entries.names.size(); ++i) {
+        result.setValueAtIndex(env, i, jsi::String::createFromUtf8(env, entries.names[i]));
+    }
+    return result;
+}
+
+auto openFile(const std::string& path, int flags, mode_t mode = 0) -> int
+{
+    auto fd = folly::openNoInt(path.c_str(), flags | O_CLOEXEC, mode);
+    if (fd < 0) {
+        folly::throwSystemError("open '", path, "'");
+    }
+    return fd;
+}
+
+auto readWholeFileAsString(const std::string& path) -> std::string
+{
+    std::string contents;
+    if (!folly::readFile(path.c_str(), contents)) {
+        folly::throwSystemError("read '", path, "'");
+    }
+    return contents;
+}
+
+auto statFile(const std::string& path) -> FileStat
+{
+    struct stat info {};
+    if (::stat(path.c_str(), &info) != 0) {
+        folly::throwSystemError("stat '", path, "'");
+    }
+
+    return {
+        .size = static_cast<uint64_t>(info.st_size),
+        .mode = static_cast<uint32_t>(info.st_mode),
+        .mtimeMs = static_cast<double>(info.st_mtim.tv_sec) * 1e3 + static_cast<double>(info.st_mtim.tv_nsec) / 1e6,
+        .isFile = S_ISREG(info.st_mode),
+        .isDirectory = S_ISDIR(info.st_mode),
+    };
+}
+
+auto listDirectory(const std::string& path) -> DirectoryEntries
+{
+    DirectoryEntries entries;
+    for (const auto& entry : std::filesystem::directory_iterator(path)) {
+        entries.names.push_back(entry.path().filename().string());
+    }
+    return entries;
+}
+
+auto parseOpenFlags(Environment& env, const jsi::Value& value) -> int
+{
+    if (value.isUndefined()) {
+        return O_RDONLY;
+    }
+
+    auto flags = jsrt::fromJS<std::string>(value, env);
+    if (flags == "r") {
+        return O_RDONLY;
+    }
+    if (flags == "r+") {
+        return O_RDWR;
+    }
+    if (flags == "w") {
+        return O_WRONLY | O_CREAT | O_TRUNC;
+    }
+    if (flags == "w+") {
+        return O_RDWR | O_CREAT | O_TRUNC;
+    }
+    if (flags == "a") {
+        return O_WRONLY | O_CREAT | O_APPEND;
+    }
+    if (flags == "a+") {
+        return O_RDWR | O_CREAT | O_APPEND;
+    }
+
+    throw jsi::JSError(env, fmt::format("Unknown file open flags '{}'", flags));
+}
+
+/**
+ * Position of positional reads and writes, or -1 to use the file offset.
+ */
+auto positionArgument(Environment& env, const jsi::Value& value) -> int64_t
+{
+    if (value.isUndefined() || value.isNull()) {
+        return -1;
+    }
+    return integerArgument(env, value, "position");
+}
+
+auto parseStreamOptions(Environment& env, const jsi::Value& value) -> FileReadStream::Options
+{
+    FileReadStream::Options options;
+    if (value.isUndefined()) {
+        return options;
+    }
+
+    auto object = value.asObject(env);
+    auto positive = [&env, &object](const char* name, size_t fallback) -> size_t {
+        auto property = object.getProperty(env, name);
+        if (property.isUndefined()) {
+            return fallback;
+        }
+        auto number = integerArgument(env, property, name);
+        if (number < 1) {
+            throw jsi::JSError(env, fmt::format("Option '{}' must be positive", name));
+        }
+        return static_cast<size_t>(number);
+    };
+    options.chunkSize = positive("chunkSize", options.chunkSize);
+    options.readahead = positive("readahead", options.readahead);
+    return options;
+}
+
+}
+
+auto createFileSystemModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+
+    defineFunction(env, exports, "readFile", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        const auto& encoding = argumentAt(args, count, 1);
+        if (encoding.isString() && encoding.getString(env).utf8(env) == "utf8") {
+            return runOnIOThread(env, [path = std::move(path)] { return readWholeFileAsString(path); });
+        }
+        // Opened on the I/O executor, chunks are then read by the file engine
+        auto& engine = env.host().platform().getFileEngine();
+        return runOnIOThread(env, [&engine, path = std::move(path)] { return engine.readFile(path); });
+    });
+
+    defineFunction(env, exports, "writeFile", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        std::string storage;
+        auto data = ext::copyBytes(ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage));
+
+        return runOnIOThread(env, [path = std::move(path), data = std::move(data)] {
+            if (!folly::writeFile(data, path.c_str())) {
+                folly::throwSystemError("write '", path, "'");
+            }
+            return folly::unit;
+        });
+    });
+
+    defineFunction(env, exports, "stat", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        return runOnIOThread(env, [path = std::move(path)] { return statFile(path); });
+    });
+
+    defineFunction(env, exports, "readdir", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        return runOnIOThread(env, [path = std::move(path)] { return listDirectory(path); });
+    });
+
+    defineFunction(env, exports, "open", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        auto flags = parseOpenFlags(env, argumentAt(args, count, 1));
+        const auto& modeArg = argumentAt(args, count, 2);
+        auto mode = static_cast<mode_t>(modeArg.isUndefined() ? 0666 : integerArgument(env, modeArg, "mode", 07777));
+
+        return runOnIOThread(env, [path = std::move(path), flags, mode] { return openFile(path, flags, mode); });
+    });
+
+    defineFunction(env, exports, "read", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto fd = static_cast<int>(integerArgument(env, argumentAt(args, count, 0), "fd", INT_MAX));
+        auto length = static_cast<size_t>(integerArgument(env, argumentAt(args, count, 1), "length"));
+        auto position = positionArgument(env, argumentAt(args, count, 2));
+
+        if (position >= 0) {
+            auto buffer = ext::NativeBuffer::allocate(length);
+            auto read = env.host().platform().getFileEngine().read(fd, buffer->bytes(), static_cast<uint64_t>(position));
+            // Continuation owns the buffer until the read completes
+            return jsrt::conv::toJS(
+                std::move(read).deferValue([buffer](size_t bytesRead) {
+                    buffer->truncate(bytesRead);
+                    return buffer;
+                }),
+                env
+            );
+        }
+
+        // Reads at the file offset are not positional, so they stay on the I/O executor
+        return runOnIOThread(env, [fd, length] {
+            auto buffer = ext::NativeBuffer::allocate(length);
+            auto bytesRead = folly::readNoInt(fd, buffer->data(), length);
+            if (bytesRead < 0) {
+                folly::throwSystemError("read");
+            }
+            buffer->truncate(static_cast<size_t>(bytesRead));
+            return buffer;
+        });
+    });
+
+    defineFunction(env, exports, "write", 3, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto fd = static_cast<int>(integerArgument(env, argumentAt(args, count, 0), "fd", INT_MAX));
+        std::string storage;
+        auto data = ext::copyBytes(ext::bytesOrUtf8Of(env, argumentAt(args, count, 1), storage));
+        auto position = positionArgument(env, argumentAt(args, count, 2));
+
+        return runOnIOThread(env, [fd, data = std::move(data), position] {
+            auto bytesWritten = position >= 0
+                ? folly::pwriteFull(fd, data.data(), data.size(), static_cast<off_t>(position))
+                : folly::writeFull(fd, data.data(), data.size());
+            if (bytesWritten < 0) {
+                folly::throwSystemError("write");
+            }
+            return static_cast<double>(bytesWritten);
+        });
+    });
+
+    defineFunction(env, exports, "createReadStream", 2, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto path = jsrt::fromJS<std::string>(argumentAt(args, count, 0), env);
+        auto options = parseStreamOptions(env, argumentAt(args, count, 1));
+        return jsi::Value(toAsyncIterator(env, FileReadStream::open(env, std::move(path), options)));
+    });
+
+    defineFunction(env, exports, "close", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto fd = static_cast<int>(integerArgument(env, argumentAt(args, count, 0), "fd", INT_MAX));
+        return runOnIOThread(env, [fd] {
+            if (folly::closeNoInt(fd) != 0) {
+                folly::throwSystemError("close");
+            }
+            return folly::unit;
+        });
+    });
+
+    return exports;
+}
+
+}
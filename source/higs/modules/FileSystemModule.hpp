@@ -0,0 +1,33 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `fs` module.
+ *
+ * All operations run on the runtime's I/O executor, and return promises settled on the environment's thread:
+ *
+ * - `readFile(path, encoding?)`: contents as ArrayBuffer, or as string when encoding is `'utf8'`
+ * - `writeFile(path, data)`: writes string or binary data, replacing the file
+ * - `stat(path)`: `{ size, mode, mtimeMs, isFile, isDirectory }`
+ * - `readdir(path)`: names of directory entries
+ * - `open(path, flags?, mode?)`: file descriptor, flags are `'r'`, `'r+'`, `'w'`, `'w+'`, `'a'` or `'a+'`
+ * - `read(fd, length, position?)`: up to `length` bytes as ArrayBuffer, empty at end of file
+ * - `write(fd, data, position?)`: number of bytes written
+ * - `close(fd)`
+ * - `createReadStream(path, { chunkSize?, readahead? }?)`: async iterator of ArrayBuffer chunks, see `FileReadStream`
+ *
+ * Read data is delivered in ArrayBuffers created over the buffer it was read into, without copying.
+ * Without `position`, `read` and `write` use and advance the file offset.
+ */
+auto createFileSystemModule(Environment& env) -> jsi::Object;
+
+}
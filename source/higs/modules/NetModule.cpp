@@ -0,0 +1,141 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "NetModule.hpp"
+
+#include <sys/socket.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+#include <fmt/format.h>
+#include "BuiltinModules.hpp"
+#include "Socket.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+constexpr int64_t kMaxHighWaterMark = int64_t(1) << 30;
+
+struct Endpoint {
+    folly::SocketAddress address;
+    Socket::Options options;
+};
+
+/**
+ * Parses `{ host, port }` or `{ path }` address, with socket options.
+ */
+auto endpointArgument(Environment& env, const jsi::Value& value) -> Endpoint
+{
+    if (!value.isObject()) {
+        throw jsi::JSError(env, "Argument 'address' must be an object");
+    }
+
+    Endpoint endpoint;
+    auto object = value.getObject(env);
+
+    auto highWaterMark = object.getProperty(env, "highWaterMark");
+    if (!highWaterMark.isUndefined()) {
+        auto size = integerArgument(env, highWaterMark, "highWaterMark", 1, kMaxHighWaterMark);
+        endpoint.options.highWaterMark = static_cast<size_t>(size);
+    }
+
+    auto path = object.getProperty(env, "path");
+    if (!path.isUndefined()) {
+        endpoint.address.setFromPath(jsrt::fromJS<std::string>(path, env));
+        return endpoint;
+    }
+
+    auto port = static_cast<uint16_t>(integerArgument(env, object.getProperty(env, "port"), "port", UINT16_MAX));
+
+    // Names are not resolved, as that would block the environment's thread
+    auto hostValue = object.getProperty(env, "host");
+    auto host = hostValue.isUndefined() ? std::string("localhost") : jsrt::fromJS<std::string>(hostValue, env);
+    try {
+        endpoint.address.setFromIpPort(host == "localhost" ? "127.0.0.1" : host, port);
+    }
+    catch (const std::invalid_argument&) {
+        throw jsi::JSError(env, fmt::format("Host '{}' is not an IP address", host));
+    }
+    return endpoint;
+}
+
+/**
+ * Servers listening in an environment, kept alive until closed.
+ */
+using ServerSet = std::unordered_set<std::shared_ptr<SocketServer>>;
+
+auto startServer(Environment& env, const std::shared_ptr<ServerSet>& servers, const Endpoint& endpoint, jsi::Function onConnection)
+    -> jsi::Value
+{
+    auto callback = std::make_shared<jsi::Function>(std::move(onConnection));
+    auto server = std::make_shared<SocketServer>(env.eventBase(), endpoint.options, [&env, callback](std::shared_ptr<Socket> socket) {
+        // Connections are accepted outside of tasks, so JS is called from one
+        env.runLater([callback, socket = std::move(socket)](jsrt::Environment& env) {
+            try {
+                callback->call(env, toJS(socket, env));
+            }
+            catch (...) {
+                // Connection is refused, and as the caller of `listen` has returned, the error is reported as uncaught
+                socket->close();
+                static_cast<Environment&>(env).reportError(folly::exception_wrapper(std::current_exception()));
+            }
+        });
+    });
+
+    try {
+        server->listen(endpoint.address);
+    }
+    catch (const std::exception& error) {
+        throw jsi::JSError(env, fmt::format("Cannot listen on {}: {}", endpoint.address.describe(), error.what()));
+    }
+    servers->insert(server);
+
+    auto address = server->address();
+    jsi::Object result { env };
+    if (address.getFamily() == AF_UNIX) {
+        result.setProperty(env, "path", jsi::String::createFromUtf8(env, address.getPath()));
+    } else {
+        result.setProperty(env, "host", jsi::String::createFromUtf8(env, address.getAddressStr()));
+        result.setProperty(env, "port", static_cast<double>(address.getPort()));
+    }
+
+    defineFunction(env, result, "close", 0, [servers, server](Environment&, const jsi::Value*, size_t) {
+        server->close();
+        servers->erase(server);
+        return jsi::Value::undefined();
+    });
+    return result;
+}
+
+}
+
+auto createNetModule(Environment& env) -> jsi::Object
+{
+    jsi::Object exports { env };
+    auto servers = std::make_shared<ServerSet>();
+
+    defineFunction(env, exports, "connect", 1, [](Environment& env, const jsi::Value* args, size_t count) {
+        auto endpoint = endpointArgument(env, argumentAt(args, count, 0));
+        return jsrt::conv::toJS(Socket::connect(env.eventBase(), endpoint.address, endpoint.options), env);
+    });
+
+    defineFunction(env, exports, "listen", 2, [servers](Environment& env, const jsi::Value* args, size_t count) {
+        auto endpoint = endpointArgument(env, argumentAt(args, count, 0));
+        const auto& onConnection = argumentAt(args, count, 1);
+        if (!onConnection.isObject() || !onConnection.getObject(env).isFunction(env)) {
+            throw jsi::JSError(env, "Argument 'onConnection' must be a function");
+        }
+        return startServer(env, servers, endpoint, onConnection.getObject(env).getFunction(env));
+    });
+
+    return exports;
+}
+
+}
@@ -0,0 +1,29 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Creates exports of built-in `net` module, stream sockets on the environment's own event base.
+ *
+ * Addresses are `{ host, port }`, where host is an IP address or `'localhost'` (names are not resolved), or
+ * `{ path }` of a Unix domain socket.
+ *
+ * - `connect(address)`: promise of a socket
+ * - `listen(address, onConnection)`: starts accepting connections, calling `onConnection(socket)` with each,
+ *   and returns server with its bound address and `close()`; server is kept alive until closed
+ *
+ * Sockets have `read()`, a promise of following received ArrayBuffer (`null` at end of stream), `write(data)`,
+ * a promise of data (binary, or a string sent as UTF-8) being sent, `end()` closing the sending side, `close()`
+ * and `remoteAddress`. See `Socket` for buffering and backpressure.
+ */
+auto createNetModule(Environment& env) -> jsi::Object;
+
+}
@@ -0,0 +1,222 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Socket.hpp"
+
+#include <sys/socket.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/NativeClass.hpp>
+#include "BuiltinModules.hpp"
+
+namespace higs::modules {
+
+namespace {
+
+/**
+ * Completes connection of a socket, deleting itself once done.
+ */
+class ConnectRequest final : public folly::AsyncSocket::ConnectCallback {
+public:
+    ConnectRequest(folly::AsyncSocket::UniquePtr socket, Socket::Options options) noexcept
+        : _socket(std::move(socket)), _options(options)
+    {
+    }
+
+    auto start(const folly::SocketAddress& address) -> folly::SemiFuture<std::shared_ptr<Socket>>
+    {
+        auto future = _promise.getSemiFuture();
+        _noDelay = address.getFamily() != AF_UNIX;
+        // Callback may be called from within `connect` already, which deletes this
+        _socket->connect(this, address);
+        return future;
+    }
+
+private:
+    void connectSuccess() noexcept override
+    {
+        if (_noDelay) {
+            _socket->setNoDelay(true);
+        }
+        _promise.setWith([&] { return std::make_shared<Socket>(std::move(_socket), _options); });
+        delete this;
+    }
+
+    void connectErr(const folly::AsyncSocketException& error) noexcept override
+    {
+        _promise.setException(error);
+        delete this;
+    }
+
+    folly::AsyncSocket::UniquePtr _socket;
+    Socket::Options _options;
+    bool _noDelay = false;
+    folly::Promise<std::shared_ptr<Socket>> _promise;
+};
+
+auto socketClass() -> const ext::NativeClass<Socket>&
+{
+    static const auto binding
+        = ext::NativeClass<Socket>("Socket")
+              .method(
+                  "read",
+                  [](Socket& self, Environment& env, const jsi::Value*, size_t) -> jsi::Value {
+                      return jsrt::conv::toJS(self.read(), env);
+                  }
+              )
+              .method(
+                  "write",
+                  [](Socket& self, Environment& env, const jsi::Value* args, size_t count) -> jsi::Value {
+                      std::string storage;
+                      auto data = ext::copyBytes(ext::bytesOrUtf8Of(env, argumentAt(args, count, 0), storage));
+                      return jsrt::conv::toJS(self.write(ext::toIOBuf(std::move(data))), env);
+                  },
+                  1
+              )
+              .method(
+                  "end",
+                  [](Socket& self, Environment&, const jsi::Value*, size_t) -> jsi::Value {
+                      self.end();
+                      return jsi::Value::undefined();
+                  }
+              )
+              .method(
+                  "close",
+                  [](Socket& self, Environment&, const jsi::Value*, size_t) -> jsi::Value {
+                      self.close();
+                      return jsi::Value::undefined();
+                  }
+              )
+              .getter("remoteAddress", [](Socket& self, Environment& env) -> jsi::Value {
+                  auto address = self.peerAddress();
+                  if (address.getFamily() == AF_UNIX) {
+                      return jsi::String::createFromUtf8(env, address.getPath());
+                  }
+                  return jsi::String::createFromUtf8(env, address.describe());
+              });
+    return binding;
+}
+
+}
+
+auto toJS(std::shared_ptr<Socket> socket, jsrt::Environment& env) -> jsi::Value
+{
+    return socketClass().wrap(static_cast<Environment&>(env), std::move(socket));
+}
+
+//
+// ------------------------------------------------------------------------------------------------- Socket
+//
+auto Socket::connect(folly::EventBase& eventBase, const folly::SocketAddress& address, Options options)
+    -> folly::SemiFuture<std::shared_ptr<Socket>>
+{
+    auto* request = new ConnectRequest(folly::AsyncSocket::newSocket(&eventBase), options);
+    return request->start(address);
+}
+
+Socket::Socket(folly::AsyncSocket::UniquePtr socket, Options options)
+    : _socket(std::move(socket)), _reader(std::make_unique<StreamReader>(*_socket, options.highWaterMark))
+{
+}
+
+Socket::~Socket() noexcept
+{
+    // Reader is detached first, closing would otherwise report end of stream to it
+    _reader.reset();
+    _socket->closeNow();
+}
+
+auto Socket::read() -> folly::SemiFuture<StreamChunk>
+{
+    return _reader->read();
+}
+
+auto Socket::write(std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>
+{
+    return writeAsync(*_socket, std::move(data));
+}
+
+void Socket::end()
+{
+    _socket->shutdownWrite();
+}
+
+void Socket::close()
+{
+    _reader->cancel();
+    _socket->closeNow();
+}
+
+auto Socket::peerAddress() const -> folly::SocketAddress
+{
+    folly::SocketAddress address;
+    _socket->getPeerAddress(&address);
+    return address;
+}
+
+//
+// ------------------------------------------------------------------------------------------------- SocketServer
+//
+SocketServer::SocketServer(folly::EventBase& eventBase, Socket::Options options, ConnectionCallback onConnection) noexcept
+    : _eventBase(eventBase), _options(options), _onConnection(std::move(onConnection))
+{
+}
+
+SocketServer::~SocketServer() noexcept
+{
+    close();
+}
+
+void SocketServer::listen(const folly::SocketAddress& address, int backlog)
+{
+    if (_socket) {
+        throw std::logic_error("Server is already listening");
+    }
+
+    folly::AsyncServerSocket::UniquePtr socket { new folly::AsyncServerSocket(&_eventBase) };
+    socket->bind(address);
+    socket->listen(backlog);
+    // Without an executor, connections are accepted on the event base thread itself
+    socket->addAcceptCallback(this, nullptr);
+    socket->startAccepting();
+    _socket = std::move(socket);
+}
+
+auto SocketServer::address() const -> folly::SocketAddress
+{
+    folly::SocketAddress address;
+    if (_socket) {
+        _socket->getAddress(&address);
+    }
+    return address;
+}
+
+void SocketServer::close() noexcept
+{
+    if (_socket) {
+        _socket->stopAccepting();
+        _socket.reset();
+    }
+}
+
+void SocketServer::connectionAccepted(folly::NetworkSocket fd, const folly::SocketAddress& clientAddress, AcceptInfo) noexcept
+{
+    auto socket = folly::AsyncSocket::newSocket(&_eventBase, fd);
+    if (clientAddress.getFamily() != AF_UNIX) {
+        socket->setNoDelay(true);
+    }
+    _onConnection(std::make_shared<Socket>(std::move(socket), _options));
+}
+
+void SocketServer::acceptError(folly::exception_wrapper) noexcept
+{
+    // Failing to accept one connection (e.g. when out of file descriptors) leaves the server listening,
+    // and the peer sees its connection reset
+}
+
+}
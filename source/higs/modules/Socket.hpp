@@ -0,0 +1,128 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <folly/SocketAddress.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncServerSocket.h>
+#include <folly/io/async/AsyncSocket.h>
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+#include "StreamReader.hpp"
+
+namespace higs::modules {
+
+/**
+ * Stream socket (TCP or Unix domain) on an environment's event base, read by JS one chunk at a time.
+ *
+ * Received data is buffered by a `StreamReader`, up to `highWaterMark` bytes.
+ *
+ * Like its event base, a socket is confined to the environment's thread.
+ */
+class Socket final {
+public:
+    struct Options {
+        size_t highWaterMark = 1 << 20;
+    };
+
+    /**
+     * Connects to `address` on `eventBase`.
+     */
+    static auto connect(folly::EventBase& eventBase, const folly::SocketAddress& address, Options options)
+        -> folly::SemiFuture<std::shared_ptr<Socket>>;
+
+    Socket(folly::AsyncSocket::UniquePtr socket, Options options);
+    HIGS_MAKE_NON_COPYABLE(Socket);
+    ~Socket() noexcept;
+
+    /**
+     * Gets following chunk of received data, or chunk without data at end of stream.
+     *
+     * Only one call may be pending at a time.
+     */
+    auto read() -> folly::SemiFuture<StreamChunk>;
+
+    /**
+     * Sends `data`, and completes once it is handed to the kernel.
+     *
+     * Writes are sent in order, without waiting for previous ones to complete.
+     */
+    auto write(std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>;
+
+    /**
+     * Closes sending side of the connection once pending writes complete, receiving side stays open.
+     */
+    void end();
+
+    /**
+     * Closes the connection immediately, failing pending writes.
+     *
+     * Pending `read` completes with end of stream.
+     */
+    void close();
+
+    [[nodiscard]]
+    auto peerAddress() const -> folly::SocketAddress;
+
+private:
+    folly::AsyncSocket::UniquePtr _socket;
+    std::unique_ptr<StreamReader> _reader;
+};
+
+/**
+ * Converts socket to JS object, e.g. when a `folly::SemiFuture` of a connection completes.
+ *
+ * Object has methods `read()`, `write(data)`, `end()` and `close()`, and property `remoteAddress`.
+ */
+auto toJS(std::shared_ptr<Socket> socket, jsrt::Environment& env) -> jsi::Value;
+
+/**
+ * Listening socket, accepting connections on an environment's event base.
+ */
+class SocketServer final : private folly::AsyncServerSocket::AcceptCallback {
+public:
+    /**
+     * Called on the event base thread with each accepted connection.
+     */
+    using ConnectionCallback = std::function<void(std::shared_ptr<Socket> socket)>;
+
+    SocketServer(folly::EventBase& eventBase, Socket::Options options, ConnectionCallback onConnection) noexcept;
+    HIGS_MAKE_NON_COPYABLE(SocketServer);
+    ~SocketServer() noexcept override;
+
+    /**
+     * Binds `address`, and starts accepting connections.
+     *
+     * @throws std::system_error When the address cannot be bound
+     */
+    void listen(const folly::SocketAddress& address, int backlog = 1024);
+
+    /**
+     * Gets bound address, e.g. to find port chosen by the system for port 0.
+     */
+    [[nodiscard]]
+    auto address() const -> folly::SocketAddress;
+
+    /**
+     * Stops accepting connections, accepted ones stay open.
+     */
+    void close() noexcept;
+
+private:
+    void connectionAccepted(folly::NetworkSocket fd, const folly::SocketAddress& clientAddress, AcceptInfo info) noexcept
+        override;
+    void acceptError(folly::exception_wrapper error) noexcept override;
+
+    folly::EventBase& _eventBase;
+    Socket::Options _options;
+    ConnectionCallback _onConnection;
+    folly::AsyncServerSocket::UniquePtr _socket;
+};
+
+}
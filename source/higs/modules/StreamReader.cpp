@@ -0,0 +1,196 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "StreamReader.hpp"
+
+#include <stdexcept>
+
+#include <higs/ext/ArrayBuffer.hpp>
+#include <higs/ext/NativeClass.hpp>
+
+namespace higs::modules {
+
+namespace {
+
+/**
+ * Completes one write, deleting itself once done.
+ */
+class WriteRequest final : public folly::AsyncWriter::WriteCallback {
+public:
+    auto future() -> folly::SemiFuture<folly::Unit>
+    {
+        return _promise.getSemiFuture();
+    }
+
+private:
+    void writeSuccess() noexcept override
+    {
+        _promise.setValue();
+        delete this;
+    }
+
+    void writeErr(size_t, const folly::AsyncSocketException& error) noexcept override
+    {
+        _promise.setException(error);
+        delete this;
+    }
+
+    folly::Promise<folly::Unit> _promise;
+};
+
+auto streamReaderClass() -> const ext::NativeClass<StreamReader>&
+{
+    static const auto binding = ext::NativeClass<StreamReader>("StreamReader")
+                                    .method(
+                                        "read",
+                                        [](StreamReader& self, Environment& env, const jsi::Value*, size_t) -> jsi::Value {
+                                            return jsrt::conv::toJS(self.read(), env);
+                                        }
+                                    );
+    return binding;
+}
+
+}
+
+auto toJS(StreamChunk chunk, jsrt::Environment& env) -> jsi::Value
+{
+    if (!chunk.data) {
+        return jsi::Value::null();
+    }
+    return ext::toArrayBuffer(env, std::move(chunk.data));
+}
+
+auto toJS(std::shared_ptr<StreamReader> reader, jsrt::Environment& env) -> jsi::Value
+{
+    return streamReaderClass().wrap(static_cast<Environment&>(env), std::move(reader));
+}
+
+auto writeAsync(folly::AsyncWriter& destination, std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>
+{
+    auto* request = new WriteRequest();
+    auto future = request->future();
+    // Callback may be called from within `writeChain` already, which deletes the request
+    destination.writeChain(request, std::move(data));
+    return future;
+}
+
+StreamReader::StreamReader(folly::AsyncReader& source, size_t highWaterMark)
+    : _source(source), _highWaterMark(highWaterMark)
+{
+    _source.setReadCB(this);
+}
+
+StreamReader::~StreamReader() noexcept
+{
+    if (_source.getReadCallback() == this) {
+        _source.setReadCB(nullptr);
+    }
+}
+
+auto StreamReader::read() -> folly::SemiFuture<StreamChunk>
+{
+    if (_pending) {
+        return folly::makeSemiFuture<StreamChunk>(std::logic_error("Previous read of the stream is still awaited"));
+    }
+
+    auto [promise, future] = folly::makePromiseContract<StreamChunk>();
+    _pending = std::move(promise);
+    deliver();
+    return std::move(future);
+}
+
+void StreamReader::cancel()
+{
+    if (_source.getReadCallback() == this) {
+        _source.setReadCB(nullptr);
+    }
+    _received.reset();
+    _ended = true;
+    deliver();
+}
+
+void StreamReader::getReadBuffer(void** buffer, size_t* length)
+{
+    auto [data, size] = _received.preallocate(4 << 10, 64 << 10);
+    *buffer = data;
+    *length = size;
+}
+
+void StreamReader::readDataAvailable(size_t length) noexcept
+{
+    _received.postallocate(length);
+    deliver();
+    updateReading();
+}
+
+auto StreamReader::isBufferMovable() noexcept -> bool
+{
+    return true;
+}
+
+void StreamReader::readBufferAvailable(std::unique_ptr<folly::IOBuf> buffer) noexcept
+{
+    // Packing copies small reads into the tailroom of the previous buffer, instead of keeping a mostly
+    // empty buffer for each
+    _received.append(std::move(buffer), true);
+    deliver();
+    updateReading();
+}
+
+void StreamReader::readEOF() noexcept
+{
+    _ended = true;
+    deliver();
+}
+
+void StreamReader::readErr(const folly::AsyncSocketException& error) noexcept
+{
+    _error = folly::make_exception_wrapper<folly::AsyncSocketException>(error);
+    deliver();
+}
+
+void StreamReader::deliver()
+{
+    if (!_pending) {
+        return;
+    }
+
+    auto complete = [this](folly::Try<StreamChunk>&& chunk) {
+        auto pending = std::move(*_pending);
+        _pending.reset();
+        pending.setTry(std::move(chunk));
+    };
+
+    // Data received before the stream ended is read first
+    if (!_received.empty()) {
+        // Buffer of the source may be larger than the high water mark, only then part of it is handed over
+        auto data = _received.front()->length() <= _highWaterMark ? _received.pop_front()
+                                                                   : _received.splitAtMost(_highWaterMark);
+        complete(folly::Try<StreamChunk>(StreamChunk { .data = std::move(data) }));
+        updateReading();
+        return;
+    }
+    if (_error) {
+        complete(folly::Try<StreamChunk>(_error));
+        return;
+    }
+    if (_ended) {
+        complete(folly::Try<StreamChunk>(StreamChunk {}));
+    }
+}
+
+void StreamReader::updateReading()
+{
+    if (_ended || _error) {
+        return;
+    }
+
+    auto* callback = _received.chainLength() < _highWaterMark ? this : nullptr;
+    if (_source.getReadCallback() != callback) {
+        _source.setReadCB(callback);
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <folly/ExceptionWrapper.h>
+#include <folly/futures/Future.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/AsyncTransport.h>
+#include <higs/common.hpp>
+#include <higs/jsrt/Environment.hpp>
+
+namespace higs::modules {
+
+/**
+ * Data received from a `StreamReader`, converted to ArrayBuffer over the receive buffer, or to `null` at end of
+ * stream.
+ */
+struct StreamChunk {
+    std::unique_ptr<folly::IOBuf> data;
+};
+
+auto toJS(StreamChunk chunk, jsrt::Environment& env) -> jsi::Value;
+
+/**
+ * Reads a socket or a pipe on its event base, for JS to read one chunk at a time.
+ *
+ * Data is received into buffers allocated by the source, which are handed to JS as they are. Received data
+ * waits for `read` calls, and once `highWaterMark` bytes are waiting, the reader stops reading until JS catches
+ * up, so that a slow consumer pushes back on the writer (through TCP flow control, or a full pipe). No chunk is
+ * larger than `highWaterMark`.
+ *
+ * Like its source, a reader is confined to the event base thread.
+ */
+class StreamReader final : private folly::AsyncReader::ReadCallback {
+public:
+    /**
+     * Starts reading `source`, which must outlive the reader.
+     */
+    StreamReader(folly::AsyncReader& source, size_t highWaterMark);
+    HIGS_MAKE_NON_COPYABLE(StreamReader);
+    ~StreamReader() noexcept override;
+
+    /**
+     * Gets following chunk of received data, or chunk without data at end of stream.
+     *
+     * Only one call may be pending at a time.
+     */
+    auto read() -> folly::SemiFuture<StreamChunk>;
+
+    /**
+     * Stops reading and discards received data, e.g. when the source is closed.
+     *
+     * Pending `read` completes with end of stream.
+     */
+    void cancel();
+
+private:
+    void getReadBuffer(void** buffer, size_t* length) override;
+    void readDataAvailable(size_t length) noexcept override;
+    auto isBufferMovable() noexcept -> bool override;
+    void readBufferAvailable(std::unique_ptr<folly::IOBuf> buffer) noexcept override;
+    void readEOF() noexcept override;
+    void readErr(const folly::AsyncSocketException& error) noexcept override;
+
+    /**
+     * Completes pending `read` call, when there is data or the stream ended.
+     */
+    void deliver();
+
+    /**
+     * Pauses or resumes reading, depending on how much received data waits for JS.
+     */
+    void updateReading();
+
+    folly::AsyncReader& _source;
+    size_t _highWaterMark;
+
+    folly::IOBufQueue _received { folly::IOBufQueue::cacheChainLength() };
+    bool _ended = false;
+    folly::exception_wrapper _error;
+    std::optional<folly::Promise<StreamChunk>> _pending;
+};
+
+/**
+ * Converts reader to JS object with method `read()`, keeping alive its owner.
+ */
+auto toJS(std::shared_ptr<StreamReader> reader, jsrt::Environment& env) -> jsi::Value;
+
+/**
+ * Writes `data` to a socket or a pipe, and completes once it is handed to the kernel.
+ *
+ * Writes are sent in order, without waiting for previous ones to complete.
+ */
+auto writeAsync(folly::AsyncWriter& destination, std::unique_ptr<folly::IOBuf> data) -> folly::SemiFuture<folly::Unit>;
+
+}
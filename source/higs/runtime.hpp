@@ -1,5 +1,14 @@
 #include <higs/jsrt/Agent.hpp>
+#include <higs/jsrt/AsyncSourceProvider.hpp>
 #include <higs/jsrt/Environment.hpp>
+#include <higs/jsrt/EnvironmentPool.hpp>
+#include <higs/jsrt/EnvironmentSnapshot.hpp>
 #include <higs/jsrt/FileSystemSourceProvider.hpp>
 #include <higs/jsrt/FollyExecutionPlatform.hpp>
+#include <higs/jsrt/HeapMetrics.hpp>
+#include <higs/jsrt/MappedFileBuffer.hpp>
 #include <higs/jsrt/Runtime.hpp>
+#include <higs/jsrt/RuntimeOptions.hpp>
+#include <higs/jsrt/TaskTracer.hpp>
+#include <higs/jsrt/WeakRef.hpp>
+#include <higs/jsrt/WeakRefTable.hpp>
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 namespace higs {
 
 /**
@@ -49,10 +51,10 @@ namespace higs {
  * template <typename T, ThreadSafetyOption ThreadSafety = false>
  * class SharedPtr {
  * public:
- *   constexpr IsThreadSafe = ThreadSafety.enabled;
+ *   static constexpr bool IsThreadSafe = ThreadSafety.isEnabled;
  *
  * private:
- *   using CounterType = std::conditional_t<ThreadSafety.enabled, std::atomic<unsigned>, unsigned>;
+ *   using CounterType = std::conditional_t<ThreadSafety.isEnabled, std::atomic<unsigned>, unsigned>;
  * }
  * @endcode
  *
@@ -66,8 +68,8 @@ struct TypesafeTemplateOption {
     constexpr TypesafeTemplateOption(std::true_type) noexcept : isEnabled(true) {}
     constexpr TypesafeTemplateOption(std::false_type) noexcept : isEnabled(false) {}
 
-    constexpr static std::true_type enable;
-    constexpr static std::false_type disable;
+    constexpr static std::true_type enable {};
+    constexpr static std::false_type disable {};
 };
 
 }
@@ -6,9 +6,11 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 
 #include <boost/type_index.hpp>
 #include <folly/Expected.h>
+#include <folly/futures/Future.h>
 #include <fmt/format.h>
 #include <jsrt/jsrt.hpp>
 
@@ -151,6 +153,29 @@ bool convertFromJS(std::function<void(Args&&...)>& into, const js::Value& from,
 template<typename R, typename... Args>
 bool convertFromJS(std::function<R(Args&&...)>& into, const js::Value& from, Environment& env);
 
+// ----- FUTURES
+/**
+ * Converts a JS promise (or any thenable) into a future.
+ *
+ * Future completes once the promise settles, which happens on the environment's thread. Fulfillment value is
+ * converted to `T` there, a failed conversion fails the future with `ConversionError`. Rejection reason is
+ * delivered as `js::JSError`. Values that are not thenable resolve the future right away, as with JS `await`.
+ *
+ * `folly::SemiFuture<folly::Unit>` ignores the fulfillment value. `folly::SemiFuture<js::Value>` must be
+ * consumed on the environment's thread.
+ */
+template<typename T>
+auto convertFromJS(std::type_identity<folly::SemiFuture<T>>, const js::Value& from, Environment& env)
+    -> ConversionResult<folly::SemiFuture<T>>;
+
+/**
+ * Types that are not default constructible are converted by returning, rather than filling the result.
+ */
+template<typename T>
+concept HasReturningJSFromConversion = requires(const js::Value& from, Environment& env) {
+    { convertFromJS(std::type_identity<T> {}, from, env) } -> std::same_as<ConversionResult<T>>;
+};
+
 #pragma endregion
 
 //
@@ -223,6 +248,22 @@ auto toJS(std::function<void (Args&&...)> func, Environment& environment, const
 template<typename R, typename... Args>
 auto toJS(std::function<R (Args&&...)> func, Environment& environment, const std::string& name = "function") -> js::Value;
 
+/**
+ * Converts specified future to a JS promise.
+ *
+ * Future may complete on any executor, the promise is settled by a task scheduled on the environment,
+ * with the result converted using `toJS`. Exceptions reject the promise, `js::JSError`s with their value,
+ * others with an `Error` carrying their message. `folly::Unit` resolves to `undefined`.
+ *
+ * Environment must outlive the future.
+ *
+ * @param future Future to convert
+ * @param environment Environment to perform conversion in
+ * @return JS Promise
+ */
+template<typename T>
+auto toJS(folly::SemiFuture<T> future, Environment& environment) -> js::Value;
+
 #pragma endregion
 
 }
@@ -237,3 +278,4 @@ using conv::toJS;
 
 #include <jsrt/conv/to-inl.hpp>
 #include <jsrt/conv/from-inl.hpp>
+#include <jsrt/conv/future-inl.hpp>
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
 #include <fmt/format.h>
@@ -26,68 +30,91 @@ inline bool convertFromJS(bool& into, const js::Value& from, Environment& enviro
     return false;
 }
 
-#define FROM_NUMBER_AS(type)                       \
-    if (from.isNumber()) {                         \
-        into = static_cast<type>(from.asNumber()); \
-        return true;                               \
-    }                                              \
-    return false;
+/**
+ * Converts JS number to arithmetic type `T`.
+ *
+ * Integers must hold the number exactly, so fractional, non-finite and out of range numbers are refused instead of
+ * being truncated or wrapped around.
+ */
+template<typename T>
+inline bool convertNumberFromJS(T& into, const js::Value& from)
+{
+    if (!from.isNumber()) {
+        return false;
+    }
+
+    auto number = from.asNumber();
+    if constexpr (std::is_integral_v<T>) {
+        // Bounds are powers of 2, which doubles hold exactly, unlike the largest values of 64-bit integers
+        constexpr auto bound = static_cast<double>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1)) * 2;
+        constexpr auto lowest = std::is_signed_v<T> ? -bound : 0.0;
+        if (!(number >= lowest && number < bound) || std::trunc(number) != number) {
+            return false;
+        }
+    }
+    into = static_cast<T>(number);
+    return true;
+}
 
 inline bool convertFromJS(std::byte& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(std::byte);
+    uint8_t value = 0;
+    if (!convertNumberFromJS(value, from)) {
+        return false;
+    }
+    into = std::byte { value };
+    return true;
 }
 
 inline bool convertFromJS(uint8_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(int8_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(uint16_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(int16_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(uint32_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(int32_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(uint64_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(int64_t& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(float& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
 
 inline bool convertFromJS(double& into, const js::Value& from, Environment& environment)
 {
-    FROM_NUMBER_AS(uint8_t);
+    return convertNumberFromJS(into, from);
 }
-#undef FROM_NUMBER_AS
 
 
 inline bool convertFromJS(std::string& into, const js::Value& from, Environment& environment)
@@ -172,10 +199,15 @@ inline bool convertFromJS(std::function<R(Args&&...)>& into, const js::Value& fr
 template<typename T>
 auto tryFromJS(const js::Value& from, Environment& environment) -> ConversionResult<T>
 {
-    T result;
-    auto success = convertFromJS(result, from, environment);
+    if constexpr (HasReturningJSFromConversion<T>) {
+        return convertFromJS(std::type_identity<T> {}, from, environment);
+    }
+    else {
+        T result;
+        auto success = convertFromJS(result, from, environment);
 
-    return success ? makeExpected<ConversionError>(result) : makeUnexpected(ConversionError::forInvalidType<T>(from));
+        return success ? makeExpected<ConversionError>(std::move(result)) : makeUnexpected(ConversionError::forInvalidType<T>(from));
+    }
 }
 
 template<typename T>
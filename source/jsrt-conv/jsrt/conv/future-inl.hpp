@@ -0,0 +1,143 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+#include <folly/executors/InlineExecutor.h>
+#include <folly/futures/Future.h>
+#include <jsrt/jsrt.hpp>
+#include <jsrt/conv.hpp>
+
+namespace jsrt::conv {
+
+namespace detail {
+
+/**
+ * Converts exception into a value, that a JS promise is rejected with.
+ */
+inline auto rejectionReason(const folly::exception_wrapper& error, Environment& environment) -> js::Value
+{
+    if (const auto* jsError = error.get_exception<js::JSError>()) {
+        return { environment, jsError->value() };
+    }
+
+    return { environment, js::JSError(environment, error.what().toStdString()).value() };
+}
+
+template<typename T>
+auto fulfillmentValue(const js::Value& value, Environment& environment) -> T
+{
+    if constexpr (std::is_same_v<T, folly::Unit>) {
+        return folly::unit;
+    }
+    else {
+        return fromJS<T>(value, environment);
+    }
+}
+
+}
+
+//
+// ------------------------------------------------------------------------------------------------- From JS
+//
+template<typename T>
+auto convertFromJS(std::type_identity<folly::SemiFuture<T>>, const js::Value& from, Environment& environment)
+    -> ConversionResult<folly::SemiFuture<T>>
+{
+    auto then = from.isObject() ? from.getObject(environment).getProperty(environment, "then") : js::Value::undefined();
+    if (!then.isObject() || !then.getObject(environment).isFunction(environment)) {
+        return folly::makeSemiFuture(folly::makeTryWith([&] { return detail::fulfillmentValue<T>(from, environment); }));
+    }
+
+    auto [promise, future] = folly::makePromiseContract<T>();
+    auto settled = std::make_shared<folly::Promise<T>>(std::move(promise));
+
+    // Promise that is never settled drops its handlers once collected, which breaks the future
+    auto onFulfilled = js::Function::createFromHostFunction(
+        environment,
+        js::PropNameID::forAscii(environment, "onFulfilled"),
+        1,
+        [settled, &environment](js::Runtime& runtime, const js::Value&, const js::Value* args, size_t count) {
+            auto value = count > 0 ? js::Value(runtime, args[0]) : js::Value::undefined();
+            settled->setTry(folly::makeTryWith([&] { return detail::fulfillmentValue<T>(value, environment); }));
+            return js::Value::undefined();
+        }
+    );
+    auto onRejected = js::Function::createFromHostFunction(
+        environment,
+        js::PropNameID::forAscii(environment, "onRejected"),
+        1,
+        [settled](js::Runtime& runtime, const js::Value&, const js::Value* args, size_t count) {
+            auto reason = count > 0 ? js::Value(runtime, args[0]) : js::Value::undefined();
+            settled->setException(js::JSError(runtime, std::move(reason)));
+            return js::Value::undefined();
+        }
+    );
+    then.getObject(environment).getFunction(environment).callWithThis(
+        environment,
+        from.getObject(environment),
+        onFulfilled,
+        onRejected
+    );
+
+    return std::move(future);
+}
+
+//
+// ------------------------------------------------------------------------------------------------- To JS
+//
+template<typename T>
+auto toJS(folly::SemiFuture<T> future, Environment& environment) -> js::Value
+{
+    // JS functions, only ever touched and released on environment's thread
+    struct Resolvers {
+        js::Function resolve;
+        js::Function reject;
+    };
+    std::shared_ptr<Resolvers> resolvers;
+
+    // Promise executor is called synchronously, so it can capture by reference
+    auto promise = environment.globalObject().getPropertyAsFunction(environment, "Promise").callAsConstructor(
+        environment,
+        js::Function::createFromHostFunction(
+            environment,
+            js::PropNameID::forAscii(environment, "executor"),
+            2,
+            [&resolvers](js::Runtime& runtime, const js::Value&, const js::Value* args, size_t count) {
+                resolvers = std::make_shared<Resolvers>(Resolvers {
+                    .resolve = args[0].getObject(runtime).getFunction(runtime),
+                    .reject = args[1].getObject(runtime).getFunction(runtime),
+                });
+                return js::Value::undefined();
+            }
+        )
+    );
+
+    // Future may complete after the environment was dropped by its owner, holding it keeps the resolvers valid
+    std::move(future)
+        .via(&folly::InlineExecutor::instance())
+        .thenTry([work = PendingWork(environment), resolvers = std::move(resolvers)](folly::Try<T>&& result) mutable {
+            work.environment().runLater([resolvers = std::move(resolvers), result = std::move(result)](Environment& env) mutable {
+                if (result.hasException()) {
+                    resolvers->reject.call(env, detail::rejectionReason(result.exception(), env));
+                    return;
+                }
+
+                if constexpr (std::is_same_v<T, folly::Unit>) {
+                    resolvers->resolve.call(env);
+                }
+                else {
+                    resolvers->resolve.call(env, toJS(std::move(result).value(), env));
+                }
+            });
+        });
+
+    return promise;
+}
+
+}
@@ -0,0 +1,170 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace jsrt {
+
+template<typename Signature, std::size_t InlineCapacity = 48>
+class UniqueFunction;
+
+/**
+ * Move-only, type-erased callable with an inline buffer.
+ *
+ * Unlike `std::function`, callables do not have to be copyable, so they can own promises, `unique_ptr`s
+ * or JS values. Callables up to `InlineCapacity` bytes (and nothrow movable) are stored inline, so that
+ * scheduling a typical task does not allocate; larger ones are moved to the heap.
+ *
+ * Like `std::function`, the callable is invoked through a const call operator.
+ *
+ * @tparam R Return type
+ * @tparam Args Argument types
+ * @tparam InlineCapacity Size of the inline buffer in bytes
+ */
+template<typename R, typename... Args, std::size_t InlineCapacity>
+class UniqueFunction<R(Args...), InlineCapacity> {
+  public:
+    /**
+     * Whether callable of type `F` is stored without a heap allocation.
+     */
+    template<typename F>
+    static constexpr bool isStoredInline = sizeof(F) <= InlineCapacity
+        && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+    UniqueFunction() noexcept = default;
+
+    UniqueFunction(std::nullptr_t) noexcept {}
+
+    template<typename F>
+        requires(!std::is_same_v<std::decay_t<F>, UniqueFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    UniqueFunction(F&& func)
+    {
+        using Stored = std::decay_t<F>;
+        // Empty function pointers and `std::function`s produce an empty function
+        if constexpr (requires { static_cast<bool>(func == nullptr); }) {
+            if (func == nullptr) {
+                return;
+            }
+        }
+
+        if constexpr (isStoredInline<Stored>) {
+            ::new (static_cast<void*>(_storage)) Stored(std::forward<F>(func));
+        }
+        else {
+            ::new (static_cast<void*>(_storage)) Stored*(new Stored(std::forward<F>(func)));
+        }
+        _ops = &opsFor<Stored>;
+    }
+
+    UniqueFunction(UniqueFunction&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    auto operator=(UniqueFunction&& other) noexcept -> UniqueFunction&
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    auto operator=(std::nullptr_t) noexcept -> UniqueFunction&
+    {
+        reset();
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    auto operator=(const UniqueFunction&) -> UniqueFunction& = delete;
+
+    ~UniqueFunction() noexcept
+    {
+        reset();
+    }
+
+    /**
+     * Invokes the callable.
+     *
+     * @throws std::bad_function_call When the function is empty
+     */
+    auto operator()(Args... args) const -> R
+    {
+        if (_ops == nullptr) [[unlikely]] {
+            throw std::bad_function_call();
+        }
+        return _ops->invoke(_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return _ops != nullptr;
+    }
+
+  private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+
+        /**
+         * Move constructs callable into `to`, and destroys it in `from`.
+         */
+        void (*relocate)(void* from, void* to) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<typename F>
+    static constexpr Ops opsFor = [] {
+        if constexpr (isStoredInline<F>) {
+            return Ops {
+                .invoke = [](void* storage, Args&&... args) -> R {
+                    return std::invoke(*std::launder(static_cast<F*>(storage)), std::forward<Args>(args)...);
+                },
+                .relocate = [](void* from, void* to) noexcept {
+                    auto* source = std::launder(static_cast<F*>(from));
+                    ::new (to) F(std::move(*source));
+                    source->~F();
+                },
+                .destroy = [](void* storage) noexcept { std::launder(static_cast<F*>(storage))->~F(); },
+            };
+        }
+        else {
+            return Ops {
+                .invoke = [](void* storage, Args&&... args) -> R {
+                    return std::invoke(**static_cast<F**>(storage), std::forward<Args>(args)...);
+                },
+                .relocate = [](void* from, void* to) noexcept { ::new (to) F*(*static_cast<F**>(from)); },
+                .destroy = [](void* storage) noexcept { delete *static_cast<F**>(storage); },
+            };
+        }
+    }();
+
+    void moveFrom(UniqueFunction& other) noexcept
+    {
+        if (other._ops != nullptr) {
+            other._ops->relocate(other._storage, _storage);
+            _ops = std::exchange(other._ops, nullptr);
+        }
+    }
+
+    void reset() noexcept
+    {
+        if (_ops != nullptr) {
+            std::exchange(_ops, nullptr)->destroy(_storage);
+        }
+    }
+
+    alignas(std::max_align_t) mutable std::byte _storage[InlineCapacity];
+    const Ops* _ops = nullptr;
+};
+
+}
@@ -7,7 +7,9 @@
 
 #include <future>
 #include <memory>
+#include <utility>
 #include <jsi/jsi.h>
+#include <jsrt/function.hpp>
 
 //
 // TODO:
@@ -204,14 +206,22 @@ class RunnableTarget {
     virtual void runAfter(TFunc function, std::chrono::milliseconds delay) = 0;
 };
 
+/**
+ * Task scheduled on an agent.
+ *
+ * Inline buffer fits a `ScheduledJSFunction` together with a reference to its environment, which is
+ * what environments schedule on their agents.
+ */
+using AgentTask = UniqueFunction<void(), 96>;
+
 /**
  * Progresses environments.
  */
 class Agent
-    : public RunnableTarget<std::function<void()>>
+    : public RunnableTarget<AgentTask>
     , public RefCounted {
   public:
-    using Func = std::function<void()>;
+    using Func = AgentTask;
 
     virtual bool isRunning() const noexcept = 0;
     virtual void stop() = 0;
@@ -219,8 +229,10 @@ class Agent
 
 /**
  * Alias for a function that can be scheduled in a context.
+ *
+ * Move-only, captures of up to 64 bytes do not allocate.
  */
-using ScheduledJSFunction = std::function<void(Environment&)>;
+using ScheduledJSFunction = UniqueFunction<void(Environment&), 64>;
 
 /**
  * Represents a single JavaScript execution environment.
@@ -228,7 +240,7 @@ using ScheduledJSFunction = std::function<void(Environment&)>;
  * Each Environment has its own JavaScript runtime and EventLoop.
  */
 class Environment
-    : public RunnableTarget<std::function<void(Environment&)>>
+    : public RunnableTarget<ScheduledJSFunction>
     , public RefCounted {
   public:
     /**
@@ -252,6 +264,21 @@ class Environment
     // TODO: revise return type (e.g. Synchronized<>)
     virtual auto agent() noexcept -> Agent& = 0;
 
+    // --- Lifetime
+    /**
+     * Marks start of asynchronous work that schedules a task on this environment once it completes, e.g. a
+     * native future awaited by a JS promise.
+     *
+     * Environment stays alive until the matching `endPendingWork`, which may be called from any thread.
+     * Use `PendingWork`, which pairs the calls.
+     */
+    virtual void beginPendingWork() noexcept = 0;
+
+    /**
+     * Marks end of asynchronous work started by `beginPendingWork`.
+     */
+    virtual void endPendingWork() noexcept = 0;
+
     // --- JSI interop
     /**
      * Gets JSI Runtime associated with this context.
@@ -306,4 +333,44 @@ class Environment
     }
 };
 
+/**
+ * Keeps asynchronous work of an environment pending, and the environment alive, while held.
+ *
+ * Captured by continuations that schedule a task on the environment once a native operation completes:
+ *
+ * @code{.cpp}
+ * std::move(future).thenValue([work = jsrt::PendingWork(env)](auto&& result) {
+ *     work.environment().runLater(...);
+ * });
+ * @endcode
+ */
+class PendingWork {
+  public:
+    explicit PendingWork(Environment& environment) noexcept : _environment(&environment)
+    {
+        environment.beginPendingWork();
+    }
+
+    PendingWork(PendingWork&& other) noexcept : _environment(std::exchange(other._environment, nullptr)) {}
+    PendingWork(const PendingWork&) = delete;
+    auto operator=(const PendingWork&) -> PendingWork& = delete;
+    auto operator=(PendingWork&&) -> PendingWork& = delete;
+
+    ~PendingWork() noexcept
+    {
+        if (_environment != nullptr) {
+            _environment->endPendingWork();
+        }
+    }
+
+    [[nodiscard]]
+    auto environment() const noexcept -> Environment&
+    {
+        return *_environment;
+    }
+
+  private:
+    Environment* _environment;
+};
+
 };
@@ -0,0 +1,94 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Batch.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+#include <fmt/format.h>
+#include <folly/executors/InlineExecutor.h>
+
+namespace higs::cli {
+
+auto runBatch(Runtime& runtime, const BatchOptions& options) -> int
+{
+    auto pool = EnvironmentPool::create(runtime, options.jobs, runtime.options().defaultEnvironmentOptions());
+
+    std::mutex outputMutex;
+    std::atomic<size_t> passed = 0;
+    std::atomic<size_t> failed = 0;
+
+    auto report = [&](const std::string& path, const Environment& env, const std::string& error) {
+        if (error.empty()) {
+            passed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        failed.fetch_add(1, std::memory_order_relaxed);
+        std::scoped_lock lock { outputMutex };
+        std::cerr << fmt::format("FAIL {} ({}): {}\n", path, env.name(), error);
+    };
+
+    auto dispatch = [&](std::string path) {
+        // Script finishes once its completion value settles, which lets async scripts fail by rejecting
+        pool->runAsync([&, path = std::move(path)](jsrt::Environment& jsEnv) {
+            auto& env = static_cast<Environment&>(jsEnv);
+            folly::SemiFuture<folly::Unit> completed = folly::makeSemiFuture();
+            try {
+                completed = jsrt::conv::fromJS<folly::SemiFuture<folly::Unit>>(env.evaluateFile(path), env);
+            }
+            catch (jsi::JSError& e) {
+                report(path, env, e.getStack());
+                return completed;
+            }
+            catch (std::exception& e) {
+                report(path, env, e.what());
+                return completed;
+            }
+
+            // Promise handlers run on the environment's thread, so does this continuation
+            return std::move(completed)
+                .via(&folly::InlineExecutor::instance())
+                .thenTry([&report, path, &env](folly::Try<folly::Unit>&& result) {
+                    if (!result.hasException()) {
+                        report(path, env, {});
+                    }
+                    else if (const auto* jsError = result.exception().get_exception<jsi::JSError>()) {
+                        report(path, env, jsError->getStack());
+                    }
+                    else {
+                        report(path, env, result.exception().what().toStdString());
+                    }
+                })
+                .semi();
+        });
+    };
+
+    for (const auto& path : options.inputFiles) {
+        dispatch(path);
+    }
+
+    if (options.pathStream != nullptr) {
+        std::string line;
+        while (std::getline(*options.pathStream, line)) {
+            if (!line.empty()) {
+                dispatch(std::move(line));
+            }
+        }
+    }
+
+    pool->wait();
+    // Work scripts started without awaiting it, e.g. timers, finishes before the pool is destroyed
+    for (size_t i = 0; i < pool->size(); ++i) {
+        pool->environment(i).waitUntilIdle();
+    }
+    std::cerr << fmt::format("{} passed, {} failed\n", passed.load(), failed.load());
+
+    return failed.load() == 0 ? 0 : 1;
+}
+
+}
@@ -0,0 +1,44 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <higs/runtime.hpp>
+
+namespace higs::cli {
+
+struct BatchOptions {
+    /**
+     * Scripts to run.
+     */
+    std::vector<std::string> inputFiles;
+
+    /**
+     * When set, additional script paths are read from this stream, one per line.
+     *
+     * Scripts are dispatched as soon as their path is read, so producer and the batch run concurrently.
+     */
+    std::istream* pathStream = nullptr;
+
+    /**
+     * Number of pooled environments.
+     */
+    size_t jobs = 1;
+};
+
+/**
+ * Runs many scripts in one process, dispatching them to a pool of environments.
+ *
+ * Failures are reported to stderr as they happen, followed by a summary.
+ *
+ * @return Process exit status, non-zero if any script failed
+ */
+auto runBatch(Runtime& runtime, const BatchOptions& options) -> int;
+
+}
@@ -0,0 +1,366 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <regex>
+
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+#include <folly/ScopeGuard.h>
+#include <folly/json/json.h>
+
+namespace po = boost::program_options;
+
+namespace higs::cli {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Runs benchmark function `n` times in a JS loop, so that measured time does not include a JSI
+ * round trip per iteration.
+ */
+constexpr auto kHarnessSource = "(function (fn, n) { for (let i = 0; i < n; ++i) fn(); })";
+
+/**
+ * Upper bound of calibrated iterations, keeps the loop counter within small integer range.
+ */
+constexpr uint64_t kMaxIterations = 1ULL << 30;
+
+struct Benchmark {
+    std::string name;
+    jsi::Function fn;
+};
+
+/**
+ * Benchmarks registered by `bench(name, fn)` while the file is evaluated.
+ *
+ * Shared with the host function, which JS may keep and call after collection ends.
+ */
+struct Registry {
+    std::vector<Benchmark> benchmarks;
+    bool open = true;
+};
+
+auto collectBenchmarks(Environment& env, const BenchOptions& options) -> std::vector<Benchmark>
+{
+    auto& rt = env.jsVirtualMachine();
+    auto registry = std::make_shared<Registry>();
+
+    auto registerFn = jsi::Function::createFromHostFunction(
+        rt,
+        jsi::PropNameID::forAscii(rt, "bench"),
+        2,
+        [registry](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) -> jsi::Value {
+            if (!registry->open) {
+                throw jsi::JSError(rt, "bench() can only be called while the benchmark file is evaluated");
+            }
+            if (count < 2 || !args[0].isString() || !args[1].isObject() || !args[1].getObject(rt).isFunction(rt)) {
+                throw jsi::JSError(rt, "bench(name, fn) expects a name and a function");
+            }
+            registry->benchmarks.push_back({ args[0].getString(rt).utf8(rt), args[1].getObject(rt).getFunction(rt) });
+            return jsi::Value::undefined();
+        }
+    );
+
+    std::vector<Benchmark> benchmarks;
+    jsi::Value exported;
+    rt.global().setProperty(rt, "bench", registerFn);
+    {
+        // Registered functions are taken even when evaluation throws, rather than held until `bench` is collected
+        SCOPE_EXIT
+        {
+            registry->open = false;
+            benchmarks = std::move(registry->benchmarks);
+            registry->benchmarks.clear();
+        };
+        exported = env.evaluateFile(options.file);
+    }
+    rt.global().setProperty(rt, "bench", jsi::Value::undefined());
+
+    if (exported.isObject() && !exported.getObject(rt).isFunction(rt)) {
+        auto exports = exported.getObject(rt);
+        auto names = exports.getPropertyNames(rt);
+        for (size_t i = 0, size = names.size(rt); i < size; ++i) {
+            auto name = names.getValueAtIndex(rt, i).getString(rt);
+            auto value = exports.getProperty(rt, name);
+            if (value.isObject() && value.getObject(rt).isFunction(rt)) {
+                benchmarks.push_back({ name.utf8(rt), value.getObject(rt).getFunction(rt) });
+            }
+        }
+    }
+
+    if (!options.filter.empty()) {
+        std::regex filter { options.filter };
+        std::erase_if(benchmarks, [&filter](const Benchmark& b) { return !std::regex_search(b.name, filter); });
+    }
+
+    return benchmarks;
+}
+
+/**
+ * Computes summary statistics of `result.samples`.
+ */
+void summarize(BenchResult& result)
+{
+    auto sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto count = sorted.size();
+    result.min = sorted.front();
+    result.max = sorted.back();
+    result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(count);
+    result.median = count % 2 == 1 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+
+    // Nearest-rank percentile
+    auto p99Rank = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(count)));
+    result.p99 = sorted[std::max<size_t>(p99Rank, 1) - 1];
+
+    double variance = 0;
+    for (auto sample : sorted) {
+        variance += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = count > 1 ? std::sqrt(variance / static_cast<double>(count - 1)) : 0;
+}
+
+auto runBenchmark(Environment& env, const jsi::Function& harness, const Benchmark& benchmark, const BenchOptions& options)
+    -> BenchResult
+{
+    auto& rt = env.jsVirtualMachine();
+    auto timeLoop = [&](uint64_t iterations) {
+        auto startedAt = Clock::now();
+        harness.call(rt, benchmark.fn, static_cast<double>(iterations));
+        return Clock::now() - startedAt;
+    };
+
+    // Warmup, long enough for the function to reach steady state
+    uint64_t iterations = 1;
+    auto warmupEnd = Clock::now() + options.warmupTime;
+    while (Clock::now() < warmupEnd) {
+        timeLoop(iterations);
+        iterations = std::min(iterations * 2, kMaxIterations);
+    }
+
+    // Calibration, grows iteration count until a sample lasts at least `sampleTime`
+    iterations = 1;
+    while (iterations < kMaxIterations) {
+        auto elapsed = timeLoop(iterations);
+        if (elapsed >= options.sampleTime) {
+            break;
+        }
+        if (elapsed * 10 < options.sampleTime) {
+            iterations *= 10;
+        }
+        else {
+            auto scale = static_cast<double>(options.sampleTime.count() * 1'000'000) / std::chrono::nanoseconds(elapsed).count();
+            iterations = static_cast<uint64_t>(std::ceil(static_cast<double>(iterations) * scale));
+            break;
+        }
+    }
+    iterations = std::min(iterations, kMaxIterations);
+
+    BenchResult result;
+    result.name = benchmark.name;
+    result.iterationsPerSample = iterations;
+    result.samples.reserve(options.samples);
+
+    uint64_t allocatedBytes = 0;
+    for (size_t i = 0; i < options.samples; ++i) {
+        env.collectGarbage("bench");
+        auto before = env.heapMetrics();
+        auto elapsed = timeLoop(iterations);
+        auto after = env.heapMetrics();
+
+        result.samples.push_back(
+            static_cast<double>(std::chrono::nanoseconds(elapsed).count()) / static_cast<double>(iterations)
+        );
+        allocatedBytes += after.totalAllocatedBytes - before.totalAllocatedBytes;
+        result.collections += after.numCollections - before.numCollections;
+    }
+
+    result.allocatedBytesPerIteration
+        = static_cast<double>(allocatedBytes) / static_cast<double>(iterations * options.samples);
+    summarize(result);
+
+    return result;
+}
+
+auto formatDuration(double nanoseconds) -> std::string
+{
+    if (nanoseconds >= 1e9) {
+        return fmt::format("{:.2f} s", nanoseconds / 1e9);
+    }
+    if (nanoseconds >= 1e6) {
+        return fmt::format("{:.2f} ms", nanoseconds / 1e6);
+    }
+    if (nanoseconds >= 1e3) {
+        return fmt::format("{:.2f} us", nanoseconds / 1e3);
+    }
+    return fmt::format("{:.1f} ns", nanoseconds);
+}
+
+}
+
+auto runBenchmarks(Environment& env, const BenchOptions& options) -> std::vector<BenchResult>
+{
+    auto& rt = env.jsVirtualMachine();
+    auto benchmarks = collectBenchmarks(env, options);
+    auto harness = env.evaluateScript(kHarnessSource, "bench-harness.js").getObject(rt).getFunction(rt);
+
+    std::vector<BenchResult> results;
+    results.reserve(benchmarks.size());
+    for (const auto& benchmark : benchmarks) {
+        results.push_back(runBenchmark(env, harness, benchmark, options));
+    }
+
+    return results;
+}
+
+void writeBenchTable(std::ostream& out, const std::vector<BenchResult>& results)
+{
+    size_t nameWidth = 9;
+    for (const auto& result : results) {
+        nameWidth = std::max(nameWidth, result.name.size());
+    }
+
+    out << fmt::format(
+        "{:<{}}  {:>12}  {:>12}  {:>12}  {:>12}  {:>8}  {:>14}  {:>5}\n",
+        "benchmark", nameWidth, "iterations", "mean", "median", "p99", "stddev", "alloc/iter", "GCs"
+    );
+    for (const auto& result : results) {
+        out << fmt::format(
+            "{:<{}}  {:>12}  {:>12}  {:>12}  {:>12}  {:>7.1f}%  {:>12.1f} B  {:>5}\n",
+            result.name,
+            nameWidth,
+            result.iterationsPerSample,
+            formatDuration(result.mean),
+            formatDuration(result.median),
+            formatDuration(result.p99),
+            result.mean > 0 ? result.stddev / result.mean * 100 : 0,
+            result.allocatedBytesPerIteration,
+            result.collections
+        );
+    }
+}
+
+void writeBenchJson(std::ostream& out, const BenchOptions& options, const std::vector<BenchResult>& results)
+{
+    auto benchmarks = folly::dynamic::array();
+    for (const auto& result : results) {
+        auto samples = folly::dynamic::array();
+        for (auto sample : result.samples) {
+            samples.push_back(sample);
+        }
+
+        benchmarks.push_back(folly::dynamic::object
+            ("name", result.name)
+            ("iterations_per_sample", result.iterationsPerSample)
+            ("mean_ns", result.mean)
+            ("median_ns", result.median)
+            ("p99_ns", result.p99)
+            ("min_ns", result.min)
+            ("max_ns", result.max)
+            ("stddev_ns", result.stddev)
+            ("allocated_bytes_per_iteration", result.allocatedBytesPerIteration)
+            ("collections", result.collections)
+            ("samples_ns", std::move(samples)));
+    }
+
+    auto report = folly::dynamic::object
+        ("file", options.file)
+        ("warmup_ms", options.warmupTime.count())
+        ("sample_time_ms", options.sampleTime.count())
+        ("benchmarks", std::move(benchmarks));
+
+    out << folly::toPrettyJson(report) << "\n";
+}
+
+auto benchMain(int argc, char** argv) -> int
+{
+    BenchOptions options;
+    uint32_t warmupMs = 0;
+    uint32_t sampleTimeMs = 0;
+    std::string format;
+    std::string outputPath;
+
+    po::options_description opts { "Usage: higs-cli bench [options] <file>" };
+    opts.add_options()
+        ("help", "Print help message")
+        ("filter", po::value<std::string>(&options.filter), "Run only benchmarks whose name matches <regex>")
+        ("samples", po::value<size_t>(&options.samples)->default_value(30), "Number of samples per benchmark")
+        ("sample-time", po::value<uint32_t>(&sampleTimeMs)->default_value(10), "Target duration of a sample in ms")
+        ("warmup", po::value<uint32_t>(&warmupMs)->default_value(200), "Warmup duration in ms")
+        ("format", po::value<std::string>(&format)->default_value("table"), "Report format, table or json")
+        ("output,o", po::value<std::string>(&outputPath), "Write report to <file> instead of standard output");
+
+    po::options_description hidden;
+    hidden.add_options()("file", po::value<std::string>(&options.file), "Benchmark script");
+
+    po::options_description all;
+    all.add(opts).add(hidden);
+
+    po::positional_options_description args;
+    args.add("file", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(all).positional(args).run(), vm);
+    po::notify(vm);
+
+    if (vm.count("help") || options.file.empty() || (format != "table" && format != "json")) {
+        std::cout << opts << "\n";
+        return 1;
+    }
+
+    options.warmupTime = std::chrono::milliseconds { warmupMs };
+    options.sampleTime = std::chrono::milliseconds { std::max<uint32_t>(sampleTimeMs, 1) };
+    options.samples = std::max<size_t>(options.samples, 1);
+
+    auto rt = Runtime::create();
+    auto& env = rt->mainEnvironment();
+
+    std::vector<BenchResult> results;
+    std::string error;
+    env.runNowBlocking([&](jsrt::Environment&) {
+        try {
+            results = runBenchmarks(env, options);
+        }
+        catch (jsi::JSError& e) {
+            error = e.getStack();
+        }
+        catch (std::exception& e) {
+            error = e.what();
+        }
+    });
+
+    if (!error.empty()) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+    }
+    auto& out = outputPath.empty() ? std::cout : file;
+
+    if (format == "json") {
+        writeBenchJson(out, options, results);
+    }
+    else {
+        writeBenchTable(out, results);
+    }
+
+    return 0;
+}
+
+}
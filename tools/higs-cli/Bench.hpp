@@ -0,0 +1,94 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <higs/runtime.hpp>
+
+namespace higs::cli {
+
+struct BenchOptions {
+    /**
+     * Script defining benchmarks.
+     *
+     * Benchmarks are registered by calling `bench(name, fn)`, or by completing the script with an object
+     * whose function-valued properties are benchmarks.
+     */
+    std::string file;
+
+    /**
+     * Only benchmarks whose name matches this regular expression are run.
+     */
+    std::string filter;
+
+    /**
+     * How long every benchmark runs before it is measured.
+     */
+    std::chrono::milliseconds warmupTime { 200 };
+
+    /**
+     * Target duration of a single sample, iterations per sample are calibrated to reach it.
+     */
+    std::chrono::milliseconds sampleTime { 10 };
+
+    /**
+     * Number of samples taken per benchmark.
+     */
+    size_t samples = 30;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterationsPerSample = 0;
+
+    /**
+     * Time per iteration of every sample, in nanoseconds.
+     */
+    std::vector<double> samples;
+
+    double mean = 0;
+    double median = 0;
+    double p99 = 0;
+    double min = 0;
+    double max = 0;
+    double stddev = 0;
+
+    /**
+     * JS heap bytes allocated per iteration, as reported by Hermes instrumentation.
+     */
+    double allocatedBytesPerIteration = 0;
+
+    /**
+     * Garbage collections that happened while samples were taken.
+     */
+    uint64_t collections = 0;
+};
+
+/**
+ * Evaluates benchmark script in `env`, and runs benchmarks it defines.
+ *
+ * Every benchmark is warmed up, then its iteration count is calibrated to `sampleTime`. Full GC is
+ * forced before every sample, so that garbage of one sample is not collected during another.
+ *
+ * Must be called on `env`'s thread.
+ */
+auto runBenchmarks(Environment& env, const BenchOptions& options) -> std::vector<BenchResult>;
+
+void writeBenchTable(std::ostream& out, const std::vector<BenchResult>& results);
+void writeBenchJson(std::ostream& out, const BenchOptions& options, const std::vector<BenchResult>& results);
+
+/**
+ * Entry point of `higs-cli bench` command.
+ *
+ * @return Process exit status
+ */
+auto benchMain(int argc, char** argv) -> int;
+
+}
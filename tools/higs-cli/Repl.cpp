@@ -0,0 +1,403 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#include "Repl.hpp"
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/coro/BlockingWait.h>
+#include <folly/coro/Task.h>
+#include <linenoise.h>
+
+namespace higs::cli {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Formats value the way it is echoed back to the user.
+ */
+auto inspect(jsi::Runtime& rt, const jsi::Value& value) -> std::string
+{
+    if (value.isUndefined()) {
+        return "undefined";
+    }
+
+    if (value.isString()) {
+        auto json = rt.global().getPropertyAsObject(rt, "JSON").getPropertyAsFunction(rt, "stringify");
+        return json.call(rt, value).getString(rt).utf8(rt);
+    }
+
+    if (value.isBigInt()) {
+        return value.toString(rt).utf8(rt) + "n";
+    }
+
+    if (!value.isObject()) {
+        return value.toString(rt).utf8(rt);
+    }
+
+    auto object = value.getObject(rt);
+    if (object.isFunction(rt)) {
+        auto name = object.getProperty(rt, "name");
+        auto nameStr = name.isString() ? name.getString(rt).utf8(rt) : "";
+        return nameStr.empty() ? "[Function (anonymous)]" : fmt::format("[Function {}]", nameStr);
+    }
+
+    auto errorCtor = rt.global().getPropertyAsFunction(rt, "Error");
+    if (object.instanceOf(rt, errorCtor)) {
+        auto stack = object.getProperty(rt, "stack");
+        if (stack.isString()) {
+            return stack.getString(rt).utf8(rt);
+        }
+    }
+
+    try {
+        auto json = rt.global().getPropertyAsObject(rt, "JSON").getPropertyAsFunction(rt, "stringify");
+        auto result = json.call(rt, value, jsi::Value::null(), 2);
+        if (result.isString()) {
+            return result.getString(rt).utf8(rt);
+        }
+    }
+    catch (jsi::JSError&) {
+        // Cyclic or otherwise not serializable, fall back to the string conversion below
+    }
+
+    return value.toString(rt).utf8(rt);
+}
+
+/**
+ * Walks `source` lexically, calling `onCode` with index of every character of code, outside of strings,
+ * template text and comments.
+ *
+ * Regular expression literals are not recognized, as telling them from division needs a parser.
+ *
+ * @return Whether input is complete, see `isInputComplete`
+ */
+template<typename F>
+auto scanSource(const std::string& source, F&& onCode) -> bool
+{
+    enum class Mode { Code, SingleQuote, DoubleQuote, Template, LineComment, BlockComment };
+
+    // Closing brackets expected, `$` marks end of a template substitution
+    std::vector<char> expected;
+    auto mode = Mode::Code;
+    auto unbalanced = false;
+
+    for (size_t i = 0; i < source.size(); ++i) {
+        auto c = source[i];
+        auto next = i + 1 < source.size() ? source[i + 1] : '\0';
+
+        switch (mode) {
+        case Mode::Code:
+            switch (c) {
+            case '\'': mode = Mode::SingleQuote; break;
+            case '"': mode = Mode::DoubleQuote; break;
+            case '`': mode = Mode::Template; break;
+            case '(': expected.push_back(')'); onCode(i); break;
+            case '[': expected.push_back(']'); onCode(i); break;
+            case '{': expected.push_back('}'); onCode(i); break;
+            case '/':
+                if (next == '/') {
+                    mode = Mode::LineComment;
+                    ++i;
+                }
+                else if (next == '*') {
+                    mode = Mode::BlockComment;
+                    ++i;
+                }
+                else {
+                    onCode(i);
+                }
+                break;
+            case ')':
+            case ']':
+            case '}':
+                if (expected.empty() || (expected.back() != c && expected.back() != '$')) {
+                    // Unbalanced, let the compiler report it
+                    unbalanced = true;
+                    onCode(i);
+                    break;
+                }
+                if (expected.back() == '$') {
+                    if (c != '}') {
+                        unbalanced = true;
+                        onCode(i);
+                        break;
+                    }
+                    mode = Mode::Template;
+                }
+                else {
+                    onCode(i);
+                }
+                expected.pop_back();
+                break;
+            default: onCode(i); break;
+            }
+            break;
+
+        case Mode::SingleQuote:
+        case Mode::DoubleQuote:
+            if (c == '\\') {
+                ++i;
+            }
+            else if (c == '\n' || c == (mode == Mode::SingleQuote ? '\'' : '"')) {
+                mode = Mode::Code;
+            }
+            break;
+
+        case Mode::Template:
+            if (c == '\\') {
+                ++i;
+            }
+            else if (c == '`') {
+                mode = Mode::Code;
+            }
+            else if (c == '$' && next == '{') {
+                expected.push_back('$');
+                mode = Mode::Code;
+                ++i;
+            }
+            break;
+
+        case Mode::LineComment:
+            if (c == '\n') {
+                mode = Mode::Code;
+                onCode(i);
+            }
+            break;
+
+        case Mode::BlockComment:
+            if (c == '*' && next == '/') {
+                mode = Mode::Code;
+                ++i;
+            }
+            break;
+        }
+    }
+
+    return unbalanced || (expected.empty() && mode != Mode::Template && mode != Mode::BlockComment);
+}
+
+/**
+ * Compiles entry using top-level `await` as an async function.
+ *
+ * Expression form keeps the value of the expression, statement form supports any code at the cost of
+ * declarations becoming local to the entry.
+ */
+auto prepareAsync(jsi::Runtime& rt, const std::string& source, const std::string& name)
+    -> std::shared_ptr<const jsi::PreparedJavaScript>
+{
+    auto expression = source;
+    while (!expression.empty() && (std::isspace(static_cast<unsigned char>(expression.back())) || expression.back() == ';')) {
+        expression.pop_back();
+    }
+
+    try {
+        auto wrapped = fmt::format("(async () => (\n{}\n))()", expression);
+        return rt.prepareJavaScript(std::make_shared<jsi::StringBuffer>(std::move(wrapped)), name);
+    }
+    catch (jsi::JSIException&) {
+        // Not an expression
+    }
+
+    auto wrapped = fmt::format("(async () => {{\n{}\n}})()", source);
+    return rt.prepareJavaScript(std::make_shared<jsi::StringBuffer>(std::move(wrapped)), name);
+}
+
+auto formatBytes(int64_t bytes) -> std::string
+{
+    auto magnitude = static_cast<double>(std::abs(bytes));
+    auto sign = bytes < 0 ? "-" : "";
+    if (magnitude >= 1 << 20) {
+        return fmt::format("{}{:.1f} MiB", sign, magnitude / (1 << 20));
+    }
+    if (magnitude >= 1 << 10) {
+        return fmt::format("{}{:.1f} KiB", sign, magnitude / (1 << 10));
+    }
+    return fmt::format("{}{} B", sign, bytes < 0 ? -bytes : bytes);
+}
+
+}
+
+auto isInputComplete(const std::string& source) -> bool
+{
+    return scanSource(source, [](size_t) {});
+}
+
+auto usesAwait(const std::string& source) -> bool
+{
+    // Strings and comments are blanked out, so that only `await` in code counts
+    std::string code(source.size(), ' ');
+    scanSource(source, [&](size_t i) { code[i] = source[i]; });
+
+    static const std::regex awaitToken { R"((^|[^\w$.])await\b)" };
+    return std::regex_search(code, awaitToken);
+}
+
+struct Repl::Evaluation {
+    std::string output;
+    bool failed = false;
+    Clock::duration duration {};
+    HeapMetrics heapBefore;
+    HeapMetrics heapAfter;
+};
+
+Repl::Repl(Environment& env) : _env(env)
+{
+    if (const char* home = std::getenv("HOME")) {
+        _historyPath = fmt::format("{}/.higs_history", home);
+    }
+}
+
+auto Repl::run() -> int
+{
+    linenoiseHistorySetMaxLen(1000);
+    if (!_historyPath.empty()) {
+        linenoiseHistoryLoad(_historyPath.c_str());
+    }
+
+    std::string pending;
+    while (true) {
+        errno = 0;
+        char* rawLine = linenoise(pending.empty() ? "> " : "... ");
+        if (rawLine == nullptr) {
+            if (errno == EAGAIN) {
+                // Ctrl-C abandons current entry
+                pending.clear();
+                continue;
+            }
+            break;
+        }
+
+        std::string line { rawLine };
+        std::free(rawLine);
+
+        if (pending.empty()) {
+            if (line.starts_with(':')) {
+                linenoiseHistoryAdd(line.c_str());
+                if (!handleCommand(line)) {
+                    break;
+                }
+                continue;
+            }
+            if (line.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+        }
+
+        linenoiseHistoryAdd(line.c_str());
+        pending += line;
+        pending += '\n';
+
+        // Empty line forces evaluation, so that misjudged input can not trap the user in continuation
+        if (!line.empty() && !isInputComplete(pending)) {
+            continue;
+        }
+
+        evaluate(pending);
+        pending.clear();
+    }
+
+    if (!_historyPath.empty()) {
+        linenoiseHistorySave(_historyPath.c_str());
+    }
+
+    return 0;
+}
+
+auto Repl::handleCommand(const std::string& command) -> bool
+{
+    if (command == ":quit" || command == ":q") {
+        return false;
+    }
+
+    if (command == ":time") {
+        _showTime = !_showTime;
+        std::cout << "Timing " << (_showTime ? "enabled" : "disabled") << "\n";
+    }
+    else if (command == ":heap") {
+        _showHeap = !_showHeap;
+        std::cout << "Heap delta " << (_showHeap ? "enabled" : "disabled") << "\n";
+    }
+    else if (command == ":help") {
+        std::cout << ":time  Toggle printing evaluation time\n"
+                     ":heap  Toggle printing JS heap delta of every evaluation\n"
+                     ":quit  Exit\n";
+    }
+    else {
+        std::cout << "Unknown command " << command << ", see :help\n";
+    }
+
+    return true;
+}
+
+void Repl::evaluate(const std::string& source)
+{
+    // Entry using `await` is awaited on the environment's thread, while tasks completing its promise run there
+    auto onAgent = [](Environment& env, std::string source, std::string name) -> folly::coro::Task<Evaluation> {
+        auto& rt = env.jsVirtualMachine();
+        Evaluation result;
+        result.heapBefore = env.heapMetrics();
+        auto startedAt = Clock::now();
+
+        try {
+            if (usesAwait(source)) {
+                auto promise = rt.evaluatePreparedJavaScript(prepareAsync(rt, source, name));
+                result.output = inspect(rt, co_await env.awaitPromise(promise));
+            }
+            else {
+                auto value = env.evaluateScript(source, name);
+                rt.drainMicrotasks();
+                result.output = inspect(rt, value);
+            }
+        }
+        catch (jsi::JSError& e) {
+            // Rejection reason is shown like any other value, errors by their stack
+            result.output = inspect(rt, e.value());
+            result.failed = true;
+        }
+        catch (std::exception& e) {
+            result.output = e.what();
+            result.failed = true;
+        }
+
+        result.duration = Clock::now() - startedAt;
+        result.heapAfter = env.heapMetrics();
+        co_return result;
+    };
+
+    auto name = fmt::format("repl:{}", ++_entryCount);
+    auto result = folly::coro::blockingWait(onAgent(_env, source, std::move(name)).scheduleOn(_env.executor()));
+
+    (result.failed ? std::cerr : std::cout) << result.output << "\n";
+
+    if (_showTime) {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(result.duration).count();
+        std::cerr << fmt::format("time: {:.3f} ms\n", static_cast<double>(micros) / 1000);
+    }
+
+    if (_showHeap) {
+        const auto& before = result.heapBefore;
+        const auto& after = result.heapAfter;
+        std::cerr << fmt::format(
+            "heap: {} live, {} allocated, {} collections ({} us paused)\n",
+            formatBytes(static_cast<int64_t>(after.allocatedBytes) - static_cast<int64_t>(before.allocatedBytes)),
+            formatBytes(static_cast<int64_t>(after.totalAllocatedBytes - before.totalAllocatedBytes)),
+            after.numCollections - before.numCollections,
+            (after.totalGCPauseTime - before.totalGCPauseTime).count()
+        );
+    }
+}
+
+}
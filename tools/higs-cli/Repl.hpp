@@ -0,0 +1,72 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <string>
+
+#include <higs/runtime.hpp>
+
+namespace higs::cli {
+
+/**
+ * Checks whether `source` is a complete piece of JS input, or more lines should be read.
+ *
+ * Input is incomplete while brackets are unbalanced, or a template literal or block comment is left open.
+ * This is a lexical approximation and does not validate the syntax.
+ */
+[[nodiscard]]
+auto isInputComplete(const std::string& source) -> bool;
+
+/**
+ * Checks whether `source` uses `await` in code, rather than within a string or comment.
+ */
+[[nodiscard]]
+auto usesAwait(const std::string& source) -> bool;
+
+/**
+ * Interactive read-eval-print loop running on `env`.
+ *
+ * Every entry is compiled and evaluated as a separate script within the same environment, so global
+ * state is kept between entries. Entries using `await` are wrapped into an async function whose result
+ * is awaited before printing.
+ *
+ * Commands:
+ *  - `:time` toggles printing evaluation time
+ *  - `:heap` toggles printing JS heap delta of every evaluation
+ *  - `:help` lists commands
+ *  - `:quit` exits, as does end of input
+ */
+class Repl {
+public:
+    explicit Repl(Environment& env);
+
+    /**
+     * Reads and evaluates input until the user exits.
+     *
+     * @return Process exit status
+     */
+    auto run() -> int;
+
+    /**
+     * Evaluates one entry, and prints its result.
+     *
+     * Blocks until the promise of an entry using `await` settles.
+     */
+    void evaluate(const std::string& source);
+
+private:
+    struct Evaluation;
+
+    auto handleCommand(const std::string& command) -> bool;
+
+    Environment& _env;
+    std::string _historyPath;
+    size_t _entryCount = 0;
+    bool _showTime = false;
+    bool _showHeap = false;
+};
+
+}
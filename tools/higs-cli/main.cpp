@@ -1,28 +1,89 @@
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <string_view>
 #include <vector>
 
+#include <unistd.h>
+
 #include <fmt/format.h>
 #include <hermes/hermes.h>
 #include <higs/common.hpp>
 #include <higs/runtime.hpp>
 #include <boost/program_options.hpp>
+#include "Batch.hpp"
+#include "Bench.hpp"
+#include "Repl.hpp"
 
 namespace po = boost::program_options;
 
 int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string_view { argv[1] } == "bench") {
+        return higs::cli::benchMain(argc - 1, argv + 1);
+    }
+
     std::vector<std::string> evalStrings;
+    std::vector<std::string> inputFiles;
+    std::string cpuProfilePath;
+    std::string heapSnapshotPath;
     po::options_description general_opts { "General options" };
     general_opts.add_options()
         ("help", "Print help message")
-        ("eval,e", po::value<std::vector<std::string>>(&evalStrings), "Evaluate a string of JS code");
+        ("eval,e", po::value<std::vector<std::string>>(&evalStrings), "Evaluate a string of JS code")
+        ("interactive,i", "Start interactive REPL after executing inputs. Default when no input is given on a terminal")
+        ("stdin", "Evaluate script read from standard input. In batch mode, read script paths instead, one per line");
+
+    size_t jobs = 0;
+    po::options_description batch_opts { "Batch options" };
+    batch_opts.add_options()
+        ("batch", "Run input files in parallel on a pool of environments, and report those that throw "
+            "or complete with a rejected promise. Files run by the same environment share its global state")
+        ("jobs,j", po::value<size_t>(&jobs), "Number of pooled environments (defaults to number of background threads)");
+    general_opts.add(batch_opts);
+
+    uint64_t initHeapMB = 0;
+    uint64_t maxHeapMB = 0;
+    double occupancyTarget = 0;
+    size_t backgroundThreads = 0;
+    po::options_description runtime_opts { "Runtime options" };
+    runtime_opts.add_options()
+        ("init-heap", po::value<uint64_t>(&initHeapMB), "Initial JS heap size in MiB")
+        ("max-heap", po::value<uint64_t>(&maxHeapMB), "Maximum JS heap size in MiB")
+        ("occupancy-target", po::value<double>(&occupancyTarget),
+            "Fraction of the heap live data should occupy after GC (lower means fewer collections)")
+        ("no-alloc-in-young", "Allocate directly in old generation")
+        ("prefer-source", "Load JS sources even when precompiled bytecode is available")
+        ("intl", "Enable Intl")
+        ("no-proxy", "Disable Proxy")
+        ("no-js-eval", "Disable JS eval()")
+        ("threads", po::value<size_t>(&backgroundThreads), "Number of background threads");
+    general_opts.add(runtime_opts);
+
+    po::options_description profiling_opts { "Profiling options" };
+    profiling_opts.add_options()
+        ("cpu-profile", po::value<std::string>(&cpuProfilePath),
+            "Sample JS execution and write profile to <file>. "
+            "Files with .cpuprofile extension use DevTools format, other use Chrome trace format "
+            "including agent task spans")
+        ("heap-snapshot", po::value<std::string>(&heapSnapshotPath),
+            "Write heap snapshot to <file> after execution finishes")
+        ("heap-stats", "Print heap and GC statistics after execution finishes");
+    general_opts.add(profiling_opts);
+
+    po::options_description hidden_opts;
+    hidden_opts.add_options()
+        ("input-file", po::value<std::vector<std::string>>(&inputFiles), "Script to execute");
+
+    po::options_description all_opts;
+    all_opts.add(general_opts).add(hidden_opts);
 
     po::positional_options_description args;
-    // TODO: support
     args.add("input-file", -1);
 
     po::variables_map vm;
-    auto parser = po::command_line_parser(argc, argv).options(general_opts).positional(args);
+    auto parser = po::command_line_parser(argc, argv).options(all_opts).positional(args);
     po::store(parser.run(), vm);
     po::notify(vm);
 
@@ -31,28 +92,139 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    auto rt = higs::Runtime::create();
+    // Hermes takes heap sizes in bytes as `gcheapsize_t`, sizes in MiB are shifted only once known to fit
+    using HeapSize = higs::EnvironmentOptions::HeapSize;
+    constexpr uint64_t maxHeapSizeMB = std::numeric_limits<HeapSize>::max() >> 20;
+    if (initHeapMB > maxHeapSizeMB || maxHeapMB > maxHeapSizeMB) {
+        std::cerr << fmt::format("Heap sizes must not exceed {} MiB", maxHeapSizeMB) << std::endl;
+        return 1;
+    }
+
+    auto envOptions = higs::EnvironmentOptions()
+                          .withAllocInYoung(!vm.count("no-alloc-in-young"))
+                          .withSourcePreference(
+                              vm.count("prefer-source") ? higs::SourcePreference::PreferSource
+                                                        : higs::SourcePreference::PreferBytecode
+                          )
+                          .withIntl(vm.count("intl") > 0)
+                          .withProxy(!vm.count("no-proxy"))
+                          .withEval(!vm.count("no-js-eval"));
+    if (initHeapMB > 0) {
+        envOptions.withInitHeapSize(static_cast<HeapSize>(initHeapMB << 20));
+    }
+    if (maxHeapMB > 0) {
+        envOptions.withMaxHeapSize(static_cast<HeapSize>(maxHeapMB << 20));
+    }
+    if (occupancyTarget > 0) {
+        envOptions.withOccupancyTarget(occupancyTarget);
+    }
+
+    auto rtOptions = higs::RuntimeOptions().withDefaultEnvironmentOptions(envOptions);
+    if (backgroundThreads > 0) {
+        rtOptions.withBackgroundThreads(backgroundThreads);
+    }
+
+    auto rt = higs::Runtime::create(rtOptions);
+
+    if (vm.count("batch")) {
+        higs::cli::BatchOptions batch;
+        batch.inputFiles = inputFiles;
+        batch.pathStream = vm.count("stdin") ? &std::cin : nullptr;
+        batch.jobs = jobs > 0 ? jobs : rt->options().backgroundThreads();
+        return higs::cli::runBatch(*rt, batch);
+    }
+
     auto& env = rt->mainEnvironment();
 
-    // Execute some JS.
-    int status = 0;
-    try {
-        if (!evalStrings.empty()) {
+    if (!cpuProfilePath.empty()) {
+        rt->taskTracer().start();
+        env.call([](higs::Environment& env) { env.startSamplingProfiler(); });
+    }
+
+    // Reads until the writing end of a pipe is closed
+    std::string stdinScript;
+    if (vm.count("stdin")) {
+        stdinScript.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+
+    // Execute some JS on the environment's thread, errors are formatted there as they hold JS values
+    auto error = env.call([&](higs::Environment& env) -> std::string {
+        try {
             for (auto& evalStr: evalStrings) {
                 auto script = fmt::format("print({});", evalStr);
                 env.evaluateScript(script);
             }
+
+            for (auto& inputFile: inputFiles) {
+                env.evaluateFile(inputFile);
+            }
+
+            if (vm.count("stdin")) {
+                env.evaluateScript(stdinScript, "<stdin>");
+            }
+
+            env.jsVirtualMachine().drainMicrotasks();
         }
-    }
-    catch (jsi::JSError& e) {
-        // Handle JS exceptions here.
-        std::cerr << "JS Exception: " << e.getStack() << std::endl;
+        catch (jsi::JSError& e) {
+            return fmt::format("JS Exception: {}", e.getStack());
+        }
+        catch (jsi::JSIException& e) {
+            return fmt::format("JSI Exception: {}", e.what());
+        }
+        catch (std::exception& e) {
+            return fmt::format("Error: {}", e.what());
+        }
+        return {};
+    });
+
+    int status = 0;
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
         status = 1;
     }
-    catch (jsi::JSIException& e) {
-        // Handle JSI exceptions here.
-        std::cerr << "JSI Exception: " << e.what() << std::endl;
-        status = 1;
+
+    // Timers, reads and promises started by the scripts finish before anything is reported
+    env.waitUntilIdle();
+
+    auto hasInput = !evalStrings.empty() || !inputFiles.empty() || vm.count("stdin");
+    if (status == 0 && (vm.count("interactive") || (!hasInput && ::isatty(STDIN_FILENO)))) {
+        status = higs::cli::Repl(env).run();
+        env.waitUntilIdle();
+    }
+
+    if (!heapSnapshotPath.empty()) {
+        env.call([&heapSnapshotPath](higs::Environment& env) { env.writeHeapSnapshot(heapSnapshotPath); });
+    }
+
+    if (vm.count("heap-stats")) {
+        auto metrics = env.call([](higs::Environment& env) { return env.heapMetrics(); });
+        std::cerr << fmt::format(
+            "heap size: {} B, allocated: {} B, total allocated: {} B, external: {} B\n"
+            "collections: {}, GC pauses: {} us (max {} us), old generation GC time: {} us\n",
+            metrics.heapSize,
+            metrics.allocatedBytes,
+            metrics.totalAllocatedBytes,
+            metrics.externalBytes,
+            metrics.numCollections,
+            metrics.totalGCPauseTime.count(),
+            metrics.maxGCPauseTime.count(),
+            metrics.totalOldGenGCTime.count()
+        );
+    }
+
+    if (!cpuProfilePath.empty()) {
+        env.call([](higs::Environment& env) { env.stopSamplingProfiler(); });
+        rt->taskTracer().stop();
+
+        std::ofstream profileOut { cpuProfilePath };
+        env.call([&](higs::Environment& env) {
+            if (cpuProfilePath.ends_with(".cpuprofile")) {
+                env.writeCpuProfile(profileOut);
+            }
+            else {
+                env.writeChromeTrace(profileOut);
+            }
+        });
     }
 
     return status;
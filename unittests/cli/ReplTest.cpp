@@ -0,0 +1,64 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "Repl.hpp"
+
+using namespace higs;
+using cli::Repl;
+
+namespace {
+
+/**
+ * Evaluates `source` in `repl`, and returns what it printed to standard output.
+ */
+auto evaluate(Repl& repl, const std::string& source) -> std::string
+{
+    testing::internal::CaptureStdout();
+    repl.evaluate(source);
+    return testing::internal::GetCapturedStdout();
+}
+
+}
+
+TEST(TestRepl, DetectsAwaitOnlyInCode)
+{
+    EXPECT_TRUE(cli::usesAwait("await f()"));
+    EXPECT_TRUE(cli::usesAwait("const x = `${await f()}`"));
+    EXPECT_FALSE(cli::usesAwait("'await'"));
+    EXPECT_FALSE(cli::usesAwait("\"do not await\""));
+    EXPECT_FALSE(cli::usesAwait("`await`"));
+    EXPECT_FALSE(cli::usesAwait("1 // await"));
+    EXPECT_FALSE(cli::usesAwait("/* await */ 1"));
+    EXPECT_FALSE(cli::usesAwait("awaited + object.await"));
+}
+
+TEST(TestRepl, KeepsDeclarationsMentioningAwaitInStrings)
+{
+    auto host = Runtime::create();
+    Repl repl { host->mainEnvironment() };
+
+    evaluate(repl, "var greeting = 'await me' // await\n");
+
+    EXPECT_EQ(evaluate(repl, "greeting\n"), "\"await me\"\n");
+}
+
+TEST(TestRepl, AwaitsAsynchronousWork)
+{
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-repl-%%%%%%");
+    ASSERT_TRUE(folly::writeFile(std::string("hello"), path.c_str()));
+    auto host = Runtime::create();
+    Repl repl { host->mainEnvironment() };
+
+    // Read completes on the I/O executor, after the entry's first task is over
+    auto output = evaluate(repl, "await require('fs').readFile('" + path.string() + "', 'utf8')\n");
+
+    EXPECT_EQ(output, "\"hello\"\n");
+    boost::filesystem::remove(path);
+}
@@ -2,6 +2,10 @@
 // This source code is licensed under the MIT license found in the
 // LICENSE file in the root directory of this source tree.
 //
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
 #include <gtest/gtest.h>
 #include <higs/runtime.hpp>
 #include <jsrt/conv.hpp>
@@ -42,6 +46,37 @@ TEST(TestConvFromJS, FromUInt32)
     EXPECT_EQ(val, 150);
 }
 
+TEST(TestConvFromJS, FromNumberAtIntegerBounds)
+{
+    auto host = Runtime::create();
+    auto&& ctx = host->mainEnvironment();
+
+    EXPECT_EQ(conv::fromJS<uint8_t>(jsi::Value(255), ctx), 255);
+    EXPECT_EQ(conv::fromJS<int8_t>(jsi::Value(-128), ctx), -128);
+    EXPECT_EQ(conv::fromJS<uint16_t>(jsi::Value(256), ctx), 256);
+    EXPECT_EQ(conv::fromJS<int32_t>(jsi::Value(-2147483648.0), ctx), INT32_MIN);
+    EXPECT_EQ(conv::fromJS<uint32_t>(jsi::Value(4294967295.0), ctx), UINT32_MAX);
+    EXPECT_EQ(conv::fromJS<int64_t>(jsi::Value(-9007199254740992.0), ctx), -9007199254740992);
+    EXPECT_EQ(conv::fromJS<double>(jsi::Value(0.5), ctx), 0.5);
+    EXPECT_EQ(conv::fromJS<float>(jsi::Value(-1.5), ctx), -1.5F);
+}
+
+TEST(TestConvFromJS, FromNumberRefusesValuesNotFitting)
+{
+    auto host = Runtime::create();
+    auto&& ctx = host->mainEnvironment();
+
+    EXPECT_THROW(conv::fromJS<uint8_t>(jsi::Value(256), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<uint8_t>(jsi::Value(-1), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<uint32_t>(jsi::Value(-1), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<int32_t>(jsi::Value(2147483648.0), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<int64_t>(jsi::Value(9223372036854775808.0), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<uint64_t>(jsi::Value(18446744073709551616.0), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<int32_t>(jsi::Value(1.5), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<int32_t>(jsi::Value(std::numeric_limits<double>::quiet_NaN()), ctx), jsrt::ConversionError);
+    EXPECT_THROW(conv::fromJS<std::byte>(jsi::Value(256), ctx), jsrt::ConversionError);
+}
+
 //
 // ------------------------------------------------------------------------------------------------- String
 //
@@ -0,0 +1,156 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <folly/coro/BlockingWait.h>
+#include <folly/futures/Future.h>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include <jsrt/conv.hpp>
+
+using namespace higs;
+namespace conv = jsrt::conv;
+
+namespace {
+
+/**
+ * Converts `future` to a JS promise, stored as global `pending`.
+ */
+void exposeAsPending(Environment& env, folly::SemiFuture<std::string> future)
+{
+    env.call([&future](Environment& env) {
+        env.globalObject().setProperty(env, "pending", conv::toJS(std::move(future), env));
+    });
+}
+
+/**
+ * Converts completion value of `script` to a future, and lets the environment run promise handlers.
+ */
+template<typename T>
+auto awaitScript(Environment& env, const std::string& script) -> folly::SemiFuture<T>
+{
+    auto future = env.call([&script](Environment& env) {
+        return conv::fromJS<folly::SemiFuture<T>>(env.evaluateScript(script), env);
+    });
+    // Tasks are followed by a microtask checkpoint
+    env.runLater([](jsrt::Environment&) {});
+    return future;
+}
+
+}
+
+TEST(TestConvFuture, FutureToJSResolves)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+    auto contract = folly::makePromiseContract<std::string>();
+
+    exposeAsPending(env, std::move(contract.second));
+    contract.first.setValue("done");
+
+    EXPECT_EQ(folly::coro::blockingWait(env.evaluateAsync<std::string>("pending")), "done");
+}
+
+TEST(TestConvFuture, FutureToJSRejects)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+    auto contract = folly::makePromiseContract<std::string>();
+
+    exposeAsPending(env, std::move(contract.second));
+    contract.first.setException(std::runtime_error("failed"));
+
+    auto message = folly::coro::blockingWait(env.evaluateAsync<std::string>("pending.catch(e => e.message)"));
+    EXPECT_EQ(message, "failed");
+}
+
+TEST(TestConvFuture, PromiseFromJSResolves)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+
+    auto future = awaitScript<std::string>(env, "Promise.resolve('done')");
+
+    EXPECT_EQ(std::move(future).get(), "done");
+}
+
+TEST(TestConvFuture, PromiseFromJSRejects)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+
+    auto future = awaitScript<std::string>(env, "Promise.reject(new Error('failed'))");
+
+    EXPECT_THROW(std::move(future).get(), jsi::JSError);
+}
+
+TEST(TestConvFuture, PromiseFromJSFailsOnInvalidType)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+
+    auto future = awaitScript<std::string>(env, "Promise.resolve(42)");
+
+    EXPECT_THROW(std::move(future).get(), jsrt::ConversionError);
+}
+
+TEST(TestConvFuture, PlainValueFromJSResolvesImmediately)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+
+    auto future = env.call([](Environment& env) {
+        return conv::fromJS<folly::SemiFuture<std::string>>(env.evaluateScript("'plain'"), env);
+    });
+
+    ASSERT_TRUE(future.isReady());
+    EXPECT_EQ(std::move(future).get(), "plain");
+}
+
+TEST(TestConvFuture, FutureToJSCompletingAfterEnvironmentIsDestroyed)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+    auto contract = folly::makePromiseContract<std::string>();
+
+    exposeAsPending(env, std::move(contract.second));
+    host->destroyEnvironment(env);
+
+    // Pending future keeps the environment alive, its promise is no longer settled
+    contract.first.setValue("late");
+}
+
+TEST(TestConvFuture, FutureToJSCompletingAfterRuntimeIsDestroyed)
+{
+    auto contract = folly::makePromiseContract<std::string>();
+    {
+        auto host = Runtime::create();
+        exposeAsPending(host->createEnvironment("future"), std::move(contract.second));
+    }
+
+    contract.first.setValue("late");
+}
+
+TEST(TestConvFuture, EnvironmentWaitsForAwaitedFuture)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("future");
+    auto contract = folly::makePromiseContract<std::string>();
+
+    exposeAsPending(env, std::move(contract.second));
+    env.call([](Environment& env) { env.evaluateScript("pending.then(value => { globalThis.result = value; })"); });
+    std::thread completer([promise = std::move(contract.first)]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        promise.setValue("done");
+    });
+    env.waitUntilIdle();
+
+    auto result = env.call([](Environment& env) { return env.evaluateScript("globalThis.result").asString(env).utf8(env); });
+    EXPECT_EQ(result, "done");
+    completer.join();
+}
@@ -0,0 +1,106 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <higs/ext/ByteKernels.hpp>
+
+using namespace higs;
+using ext::InstructionSet;
+
+namespace {
+
+/**
+ * Compares kernels of each instruction set with scalar ones, skipping sets the CPU does not support.
+ */
+class TestByteKernels : public ::testing::TestWithParam<InstructionSet> {
+protected:
+    void SetUp() override
+    {
+        _kernels = ext::byteKernelsFor(GetParam());
+        if (_kernels == nullptr) {
+            GTEST_SKIP() << ext::nameOf(GetParam()) << " is not supported";
+        }
+    }
+
+    const ext::ByteKernels* _kernels = nullptr;
+};
+
+auto sampleBytes(size_t size) -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    return bytes;
+}
+
+}
+
+TEST_P(TestByteKernels, EncodesAndDecodesHex)
+{
+    const auto& scalar = *ext::byteKernelsFor(InstructionSet::Scalar);
+
+    // Sizes around vector widths exercise both vector loops and scalar tails
+    for (size_t size : { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 1000 }) {
+        auto bytes = sampleBytes(size);
+        std::string expected(size * 2, '\0');
+        std::string digits(size * 2, '\0');
+        scalar.hexEncode(bytes.data(), size, expected.data());
+        _kernels->hexEncode(bytes.data(), size, digits.data());
+        EXPECT_EQ(digits, expected) << size;
+
+        for (auto& c : digits) {
+            c = static_cast<char>(std::toupper(c));
+        }
+        std::vector<uint8_t> decoded(size);
+        EXPECT_TRUE(_kernels->hexDecode(digits.data(), digits.size(), decoded.data())) << size;
+        EXPECT_EQ(decoded, bytes) << size;
+    }
+}
+
+TEST_P(TestByteKernels, RejectsInvalidHex)
+{
+    std::vector<uint8_t> output(64);
+    for (size_t position : { 0, 17, 40, 127 }) {
+        for (char invalid : { 'g', 'G', '/', ':', '@', '`', '\x80' }) {
+            std::string digits(128, 'a');
+            digits[position] = invalid;
+            EXPECT_FALSE(_kernels->hexDecode(digits.data(), digits.size(), output.data())) << position << invalid;
+        }
+    }
+    EXPECT_FALSE(_kernels->hexDecode("abc", 3, output.data()));
+}
+
+TEST_P(TestByteKernels, FindsFirstOccurrence)
+{
+    std::string haystack(300, 'a');
+    haystack.replace(70, 4, "abcd");
+    haystack.replace(250, 4, "abcd");
+    const auto* data = reinterpret_cast<const uint8_t*>(haystack.data());
+
+    auto find = [&](std::string_view needle, size_t from = 0) -> ptrdiff_t {
+        const auto* found = _kernels->find(data + from, haystack.size() - from, reinterpret_cast<const uint8_t*>(needle.data()), needle.size());
+        return found == nullptr ? -1 : found - data;
+    };
+
+    EXPECT_EQ(find("abcd"), 70);
+    EXPECT_EQ(find("abcd", 71), 250);
+    EXPECT_EQ(find("bc"), 71);
+    EXPECT_EQ(find("d"), 73);
+    EXPECT_EQ(find("abce"), -1);
+    EXPECT_EQ(find(""), 0);
+    EXPECT_EQ(find("abcd", 297), -1);
+    EXPECT_EQ(find(std::string(301, 'a')), -1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    InstructionSets,
+    TestByteKernels,
+    ::testing::Values(InstructionSet::Scalar, InstructionSet::Sse42, InstructionSet::Avx2)
+);
@@ -0,0 +1,134 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+#include <higs/ext/Compression.hpp>
+
+using namespace higs;
+using ext::CompressionFormat;
+using ext::CompressionStream;
+
+namespace {
+
+auto sampleData(size_t lines) -> std::vector<uint8_t>
+{
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += fmt::format("line {} of compressible sample data\n", i % 1000);
+    }
+    return { text.begin(), text.end() };
+}
+
+auto vectorOf(const std::shared_ptr<ext::NativeBuffer>& buffer) -> std::vector<uint8_t>
+{
+    auto bytes = buffer->bytes();
+    return { bytes.begin(), bytes.end() };
+}
+
+class TestCompression : public ::testing::TestWithParam<CompressionFormat> {};
+
+}
+
+TEST_P(TestCompression, RoundTripsAtOnce)
+{
+    auto data = sampleData(10000);
+    auto compressed = ext::compress(GetParam(), data);
+    EXPECT_LT(compressed->size(), data.size() / 4);
+    EXPECT_EQ(vectorOf(ext::decompress(GetParam(), compressed->bytes())), data);
+
+    auto empty = ext::compress(GetParam(), {});
+    EXPECT_EQ(ext::decompress(GetParam(), empty->bytes())->size(), 0);
+}
+
+TEST_P(TestCompression, RoundTripsStreamsInChunks)
+{
+    auto data = sampleData(10000);
+    std::span<const uint8_t> input { data };
+
+    CompressionStream compressor { GetParam(), CompressionStream::Mode::Compress };
+    std::vector<uint8_t> compressed;
+    for (size_t offset = 0; offset < input.size(); offset += 10000) {
+        auto output = vectorOf(compressor.write(input.subspan(offset, std::min<size_t>(10000, input.size() - offset))));
+        compressed.insert(compressed.end(), output.begin(), output.end());
+    }
+    auto tail = vectorOf(compressor.finish());
+    compressed.insert(compressed.end(), tail.begin(), tail.end());
+    EXPECT_TRUE(compressor.finished());
+
+    CompressionStream decompressor { GetParam(), CompressionStream::Mode::Decompress };
+    std::vector<uint8_t> decompressed;
+    for (size_t offset = 0; offset < compressed.size(); offset += 1000) {
+        auto chunk = std::span<const uint8_t>(compressed).subspan(offset, std::min<size_t>(1000, compressed.size() - offset));
+        auto output = vectorOf(decompressor.write(chunk));
+        decompressed.insert(decompressed.end(), output.begin(), output.end());
+    }
+    EXPECT_EQ(decompressor.finish()->size(), 0);
+    EXPECT_EQ(decompressed, data);
+}
+
+TEST_P(TestCompression, RejectsTruncatedData)
+{
+    auto compressed = ext::compress(GetParam(), sampleData(1000));
+    EXPECT_THROW(ext::decompress(GetParam(), compressed->bytes().first(compressed->size() / 2)), std::runtime_error);
+
+    CompressionStream decompressor { GetParam(), CompressionStream::Mode::Decompress };
+    decompressor.write(compressed->bytes().first(compressed->size() / 2));
+    EXPECT_THROW(decompressor.finish(), std::runtime_error);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Formats,
+    TestCompression,
+    ::testing::Values(CompressionFormat::Gzip, CompressionFormat::Deflate, CompressionFormat::Zstd)
+);
+
+TEST(TestCompressionBlocks, CompressesAndDecompressesBlocksInParallel)
+{
+    folly::CPUThreadPoolExecutor executor { 4 };
+    auto data = std::make_shared<const std::vector<uint8_t>>(sampleData(100000));
+
+    auto compressed = ext::compressBlocks(data, 256 << 10, std::nullopt, folly::getKeepAliveToken(executor)).get();
+
+    // Blocks are regular zstd frames, so that any decoder decompresses them
+    EXPECT_EQ(vectorOf(ext::decompress(CompressionFormat::Zstd, compressed->bytes())), *data);
+
+    auto input = std::make_shared<const std::vector<uint8_t>>(vectorOf(compressed));
+    EXPECT_EQ(vectorOf(ext::decompressBlocks(input, folly::getKeepAliveToken(executor)).get()), *data);
+
+    auto truncated = std::make_shared<const std::vector<uint8_t>>(input->begin(), input->end() - 1);
+    EXPECT_THROW(ext::decompressBlocks(truncated, folly::getKeepAliveToken(executor)).get(), std::runtime_error);
+}
+
+TEST(TestCompressionBlocks, RejectsBlocksSmallerThanMinimum)
+{
+    folly::CPUThreadPoolExecutor executor { 1 };
+    auto data = std::make_shared<const std::vector<uint8_t>>(sampleData(100000));
+
+    EXPECT_THROW(
+        ext::compressBlocks(data, ext::kMinBlockSize - 1, std::nullopt, folly::getKeepAliveToken(executor)),
+        std::invalid_argument
+    );
+}
+
+TEST(TestCompressionBlocks, RejectsFramesRecordingHugeSizes)
+{
+    folly::CPUThreadPoolExecutor executor { 4 };
+
+    // Empty frames recording 2^63 bytes of content each, which would total 0 when added without checking
+    const std::vector<uint8_t> frame {
+        0x28, 0xB5, 0x2F, 0xFD, 0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00,
+    };
+    auto input = std::make_shared<std::vector<uint8_t>>();
+    for (int i = 0; i < 4; ++i) {
+        input->insert(input->end(), frame.begin(), frame.end());
+    }
+
+    EXPECT_THROW(ext::decompressBlocks(input, folly::getKeepAliveToken(executor)).get(), std::runtime_error);
+}
@@ -0,0 +1,77 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <higs/ext/Digest.hpp>
+
+using namespace higs;
+using ext::DigestAlgorithm;
+
+namespace {
+
+auto bytesOf(std::string_view text) -> std::span<const uint8_t>
+{
+    return { reinterpret_cast<const uint8_t*>(text.data()), text.size() };
+}
+
+auto hexOf(const std::shared_ptr<ext::NativeBuffer>& digest) -> std::string
+{
+    std::string hex;
+    for (auto byte : digest->bytes()) {
+        hex += fmt::format("{:02x}", byte);
+    }
+    return hex;
+}
+
+auto digestOf(DigestAlgorithm algorithm, std::string_view text) -> std::string
+{
+    return hexOf(ext::Digest::compute(algorithm, bytesOf(text)));
+}
+
+}
+
+TEST(TestDigest, ComputesKnownDigests)
+{
+    EXPECT_EQ(digestOf(DigestAlgorithm::Sha1, "abc"), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    EXPECT_EQ(digestOf(DigestAlgorithm::Sha256, "abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(
+        digestOf(DigestAlgorithm::Sha512, "abc"),
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+        "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"
+    );
+    EXPECT_EQ(digestOf(DigestAlgorithm::Xxh64, ""), "ef46db3751d8e999");
+    EXPECT_EQ(digestOf(DigestAlgorithm::Xxh3, ""), "2d06800538d394c2");
+    EXPECT_EQ(digestOf(DigestAlgorithm::Crc32c, "123456789"), "e3069283");
+}
+
+TEST(TestDigest, IncrementalDigestMatchesOneShot)
+{
+    std::string text;
+    for (int i = 0; i < 1000; ++i) {
+        text += fmt::format("chunk {} ", i);
+    }
+
+    for (auto algorithm : { DigestAlgorithm::Sha256, DigestAlgorithm::Xxh64, DigestAlgorithm::Xxh3, DigestAlgorithm::Crc32c }) {
+        ext::Digest digest { algorithm };
+        for (size_t offset = 0; offset < text.size(); offset += 777) {
+            digest.update(bytesOf(std::string_view(text).substr(offset, 777)));
+        }
+        EXPECT_EQ(hexOf(digest.finish()), digestOf(algorithm, text)) << ext::nameOf(algorithm);
+        EXPECT_TRUE(digest.finished());
+        EXPECT_THROW(digest.update(bytesOf("more")), std::logic_error);
+    }
+}
+
+TEST(TestDigest, FindsAlgorithmByName)
+{
+    EXPECT_EQ(ext::findDigestAlgorithm("SHA-256"), DigestAlgorithm::Sha256);
+    EXPECT_EQ(ext::findDigestAlgorithm("crc32c"), DigestAlgorithm::Crc32c);
+    EXPECT_EQ(ext::findDigestAlgorithm("XXH3"), DigestAlgorithm::Xxh3);
+    EXPECT_EQ(ext::findDigestAlgorithm("md5"), std::nullopt);
+    EXPECT_EQ(ext::findDigestAlgorithm("sha2566"), std::nullopt);
+}
@@ -0,0 +1,110 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <gtest/gtest.h>
+#include <higs/ext/NativeClass.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+struct Counter {
+    auto increment(int32_t by) -> int32_t
+    {
+        value += by;
+        return value;
+    }
+
+    auto current() const -> int32_t
+    {
+        return value;
+    }
+
+    int32_t value = 0;
+};
+
+auto counterClass() -> const ext::NativeClass<Counter>&
+{
+    static const auto binding = ext::NativeClass<Counter>("Counter")
+                                    .method<&Counter::increment>("increment")
+                                    .method<&Counter::current>("current")
+                                    .getter("value", [](Counter& self, Environment&) { return jsi::Value(self.value); })
+                                    .constructor([](Environment&, const jsi::Value*, size_t) {
+                                        return std::make_shared<Counter>();
+                                    });
+    return binding;
+}
+
+}
+
+TEST(TestNativeClass, WrapAndCallMethod)
+{
+    auto host = Runtime::create();
+    auto&& env = host->mainEnvironment();
+
+    auto counter = std::make_shared<Counter>();
+    env.globalObject().setProperty(env, "counter", counterClass().wrap(env, counter));
+
+    auto result = env.evaluateScript("counter.increment(2); counter.increment(3)");
+
+    EXPECT_EQ(result.asNumber(), 5);
+    EXPECT_EQ(counter->value, 5);
+    EXPECT_EQ(env.evaluateScript("counter.value").asNumber(), 5);
+}
+
+TEST(TestNativeClass, RefusesArgumentsNotFittingParameterType)
+{
+    auto host = Runtime::create();
+    auto&& env = host->mainEnvironment();
+
+    auto counter = std::make_shared<Counter>();
+    env.globalObject().setProperty(env, "counter", counterClass().wrap(env, counter));
+
+    EXPECT_EQ(env.evaluateScript("counter.increment(256)").asNumber(), 256);
+    EXPECT_EQ(env.evaluateScript("counter.increment(-1)").asNumber(), 255);
+    EXPECT_THROW(env.evaluateScript("counter.increment(2 ** 31)"), jsi::JSError);
+    EXPECT_THROW(env.evaluateScript("counter.increment(0.5)"), jsi::JSError);
+    EXPECT_EQ(counter->value, 255);
+}
+
+TEST(TestNativeClass, SharesPrototypeBetweenInstances)
+{
+    auto host = Runtime::create();
+    auto&& env = host->mainEnvironment();
+
+    auto global = env.globalObject();
+    global.setProperty(env, "a", counterClass().wrap(env, std::make_shared<Counter>()));
+    global.setProperty(env, "b", counterClass().wrap(env, std::make_shared<Counter>()));
+
+    auto result = env.evaluateScript("Object.getPrototypeOf(a) === Object.getPrototypeOf(b) && a.increment === b.increment");
+
+    EXPECT_EQ(result.asBool(), true);
+}
+
+TEST(TestNativeClass, ConstructFromJS)
+{
+    auto host = Runtime::create();
+    auto&& env = host->mainEnvironment();
+    env.globalObject().setProperty(env, "Counter", counterClass().constructorFunction(env));
+
+    auto result = env.evaluateScript("const c = new Counter(); c.increment(7); c instanceof Counter && c.current() === 7");
+
+    EXPECT_EQ(result.asBool(), true);
+}
+
+TEST(TestNativeClass, UnwrapRejectsForeignObjects)
+{
+    auto host = Runtime::create();
+    auto&& env = host->mainEnvironment();
+
+    auto wrapped = counterClass().wrap(env, std::make_shared<Counter>());
+    jsi::Object plain { env };
+
+    EXPECT_NE(ext::NativeClass<Counter>::tryUnwrap(env, wrapped), nullptr);
+    EXPECT_EQ(ext::NativeClass<Counter>::tryUnwrap(env, plain), nullptr);
+
+    env.globalObject().setProperty(env, "counter", std::move(wrapped));
+    EXPECT_THROW(env.evaluateScript("counter.increment.call({}, 1)"), jsi::JSError);
+}
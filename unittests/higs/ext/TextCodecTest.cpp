@@ -0,0 +1,141 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/ext/TextCodec.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+auto evaluateString(Environment& env, const std::string& script) -> std::string
+{
+    return env.call([&script](Environment& env) { return env.evaluateScript(script).getString(env).utf8(env); });
+}
+
+}
+
+TEST(TestTextCodec, EncodesUtf8)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const bytes = new TextEncoder().encode('aą🚀\uD800');
+        (bytes instanceof Uint8Array) + ':' + Array.from(bytes).join(',')
+    )");
+
+    EXPECT_EQ(result, "true:97,196,133,240,159,154,128,239,191,189");
+}
+
+TEST(TestTextCodec, EncodesIntoWithoutSplittingCharacters)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const target = new Uint8Array(6);
+        const { read, written } = new TextEncoder().encodeInto('ab🚀c', target);
+        read + ':' + written + ':' + Array.from(target.subarray(0, written)).join(',')
+    )");
+
+    EXPECT_EQ(result, "4:6:97,98,240,159,154,128");
+
+    result = evaluateString(env, R"(
+        const small = new Uint8Array(4);
+        const r = new TextEncoder().encodeInto('ab🚀c', small);
+        r.read + ':' + r.written
+    )");
+
+    EXPECT_EQ(result, "2:2");
+}
+
+TEST(TestTextCodec, DecodesUtf8WithReplacement)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const decoder = new TextDecoder();
+        [
+            decoder.decode(new Uint8Array([0x68, 0x69])),
+            decoder.decode(new Uint8Array([0xEF, 0xBB, 0xBF, 0xC4, 0x85])),
+            decoder.decode(new Uint8Array([0x61, 0xF0, 0x9F, 0x62, 0xFF])),
+            decoder.encoding,
+        ].join('|')
+    )");
+
+    EXPECT_EQ(result, "hi|ą|a�b�|utf-8");
+}
+
+TEST(TestTextCodec, DecodesStreamSplitWithinCharacter)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const bytes = new TextEncoder().encode('x🚀y');
+        const decoder = new TextDecoder();
+        let text = '';
+        for (let i = 0; i < bytes.length; ++i) {
+            text += decoder.decode(bytes.subarray(i, i + 1), { stream: true });
+        }
+        text += decoder.decode();
+        const incomplete = new TextDecoder().decode(bytes.subarray(0, 3));
+        text + '|' + incomplete
+    )");
+
+    EXPECT_EQ(result, "x🚀y|x�");
+}
+
+TEST(TestTextCodec, DecodesUtf16AndWindows1252)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const utf16 = new TextDecoder('utf-16le');
+        const latin1 = new TextDecoder('latin1');
+        [
+            utf16.decode(new Uint8Array([0xFF, 0xFE, 0x61, 0x00, 0x3D, 0xD8, 0x80, 0xDE])),
+            utf16.decode(new Uint8Array([0x00, 0xD8, 0x62])),
+            latin1.decode(new Uint8Array([0x41, 0x80, 0xE9])),
+            latin1.encoding,
+        ].join('|')
+    )");
+
+    EXPECT_EQ(result, "a🚀|��|A€é|windows-1252");
+}
+
+TEST(TestTextCodec, FatalDecoderThrowsTypeError)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const decoder = new TextDecoder('utf-8', { fatal: true });
+        let error;
+        try {
+            decoder.decode(new Uint8Array([0xC3]));
+        }
+        catch (e) {
+            error = e;
+        }
+        (error instanceof TypeError) + ':' + decoder.fatal + ':' + decoder.decode(new Uint8Array([0xC3, 0xA9]))
+    )");
+
+    EXPECT_EQ(result, "true:true:é");
+    EXPECT_THROW(env.call([](Environment& env) { return env.evaluateScript("new TextDecoder('klingon')"); }), jsi::JSError);
+}
+
+TEST(TestTextCodec, FindsEncodingByLabel)
+{
+    EXPECT_EQ(ext::findTextEncoding(" UTF8\n"), ext::TextEncoding::Utf8);
+    EXPECT_EQ(ext::findTextEncoding("Latin1"), ext::TextEncoding::Windows1252);
+    EXPECT_EQ(ext::findTextEncoding("utf-16"), ext::TextEncoding::Utf16le);
+    EXPECT_EQ(ext::findTextEncoding("utf-32"), std::nullopt);
+}
@@ -0,0 +1,268 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include <folly/coro/BlockingWait.h>
+#include <gtest/gtest.h>
+#include <higs/http/HttpServer.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+using http::HttpServer;
+
+namespace {
+
+/**
+ * Handler echoing requests, in every environment of the pool.
+ */
+constexpr auto kHandler = R"(
+    globalThis.handleRequest = (request) => {
+        if (request.url === '/echo') {
+            return request.body;
+        }
+        if (request.url === '/async') {
+            return Promise.resolve({ status: 201, headers: { 'X-Method': request.method }, body: 'later' });
+        }
+        if (request.url === '/empty') {
+            return { status: 204, body: 'dropped' };
+        }
+        if (request.url === '/split') {
+            return { headers: { 'X-Split': 'a\r\nSet-Cookie: b' }, body: 'split' };
+        }
+        if (request.url === '/invalid') {
+            return { headers: { 'Bad Name': 'a' }, body: 'invalid' };
+        }
+        if (request.url === '/fraction') {
+            return { status: 200.5, body: 'fraction' };
+        }
+        if (request.url === '/interim') {
+            return { status: 103, body: 'interim' };
+        }
+        if (request.url === '/hold') {
+            return new Promise((resolve) => { globalThis.release = resolve; });
+        }
+        if (request.url === '/throw') {
+            throw new Error('failed');
+        }
+        return request.method + ' ' + request.url + ' ' + (request.headers['x-test'] ?? '');
+    };
+)";
+
+class TestHttpServer : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        _host = Runtime::create();
+        _pool = EnvironmentPool::create(*_host, 2, EnvironmentOptions());
+        for (size_t i = 0; i < _pool->size(); ++i) {
+            folly::coro::blockingWait(_pool->environment(i).evaluateAsync(kHandler));
+        }
+    }
+
+    void TearDown() override
+    {
+        _pool.reset();
+        _host.reset();
+    }
+
+    auto startServer(HttpServer::Options options = {}) -> std::unique_ptr<HttpServer>
+    {
+        auto server = std::make_unique<HttpServer>(*_host, *_pool, std::move(options));
+        server->listen(folly::SocketAddress("127.0.0.1", 0));
+        return server;
+    }
+
+    static auto connectTo(const HttpServer& server) -> int
+    {
+        auto fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_storage address {};
+        auto length = server.address().getAddress(&address);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&address), length), 0);
+        return fd;
+    }
+
+    /**
+     * Reads everything until the server closes connection `fd`, and closes it.
+     */
+    static auto readAll(int fd) -> std::string
+    {
+        std::string output;
+        char buffer[4096];
+        for (ssize_t n; (n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0;) {
+            output.append(buffer, n);
+        }
+        ::close(fd);
+        return output;
+    }
+
+    /**
+     * Sends `input` over a new connection, and reads everything until the server closes it.
+     */
+    static auto exchange(const HttpServer& server, const std::string& input) -> std::string
+    {
+        auto fd = connectTo(server);
+        EXPECT_EQ(::send(fd, input.data(), input.size(), 0), static_cast<ssize_t>(input.size()));
+        return readAll(fd);
+    }
+
+    Runtime::Ptr _host;
+    EnvironmentPool::Ptr _pool;
+};
+
+}
+
+TEST_F(TestHttpServer, RespondsToPipelinedRequestsInOrder)
+{
+    auto server = startServer();
+
+    auto output = exchange(
+        *server,
+        "GET /first HTTP/1.1\r\nX-Test: a\r\n\r\n"
+        "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+        "GET /async HTTP/1.1\r\n\r\n"
+        "GET /last HTTP/1.1\r\nConnection: close\r\n\r\n"
+    );
+
+    EXPECT_EQ(
+        output,
+        "HTTP/1.1 200 OK\r\nContent-Length: 12\r\nConnection: keep-alive\r\n\r\nGET /first a"
+        "HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: keep-alive\r\n\r\nhello"
+        "HTTP/1.1 201 Created\r\nX-Method: GET\r\nContent-Length: 5\r\nConnection: keep-alive\r\n\r\nlater"
+        "HTTP/1.1 200 OK\r\nContent-Length: 10\r\nConnection: close\r\n\r\nGET /last "
+    );
+    EXPECT_EQ(server->requestCount(), 4);
+}
+
+TEST_F(TestHttpServer, SendsNoBodyInResponsesWithoutOne)
+{
+    auto server = startServer();
+
+    auto output = exchange(
+        *server,
+        "HEAD /head HTTP/1.1\r\n\r\n"
+        "GET /empty HTTP/1.1\r\n\r\n"
+        "GET /last HTTP/1.1\r\nConnection: close\r\n\r\n"
+    );
+
+    EXPECT_EQ(
+        output,
+        "HTTP/1.1 200 OK\r\nContent-Length: 11\r\nConnection: keep-alive\r\n\r\n"
+        "HTTP/1.1 204 No Content\r\nConnection: keep-alive\r\n\r\n"
+        "HTTP/1.1 200 OK\r\nContent-Length: 10\r\nConnection: close\r\n\r\nGET /last "
+    );
+}
+
+TEST_F(TestHttpServer, ReceivesLargeBodies)
+{
+    auto server = startServer();
+    std::string body(3 << 20, 'x');
+
+    auto output = exchange(
+        *server,
+        "POST /echo HTTP/1.0\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body
+    );
+
+    auto head = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    EXPECT_EQ(output, head + body);
+}
+
+TEST_F(TestHttpServer, RefusesInvalidRequests)
+{
+    auto server = startServer({ .maxBodySize = 16 });
+
+    EXPECT_TRUE(exchange(*server, "GARBAGE\r\n\r\n").starts_with("HTTP/1.1 400 Bad Request\r\n"));
+    EXPECT_TRUE(exchange(*server, "POST /echo HTTP/1.1\r\nContent-Length: 17\r\n\r\n").starts_with("HTTP/1.1 413"));
+    EXPECT_TRUE(exchange(*server, "GET /throw HTTP/1.1\r\nConnection: close\r\n\r\n").starts_with("HTTP/1.1 500"));
+    EXPECT_TRUE(exchange(*server, "GET /fraction HTTP/1.1\r\nConnection: close\r\n\r\n").starts_with("HTTP/1.1 500"));
+    EXPECT_TRUE(exchange(*server, "GET /interim HTTP/1.1\r\nConnection: close\r\n\r\n").starts_with("HTTP/1.1 500"));
+}
+
+TEST_F(TestHttpServer, RefusesBodiesThatCannotBeAllocated)
+{
+    auto server = startServer({ .maxBodySize = std::numeric_limits<size_t>::max() });
+
+    auto output = exchange(*server, "POST /echo HTTP/1.1\r\nContent-Length: 4611686018427387904\r\n\r\n");
+
+    EXPECT_TRUE(output.starts_with("HTTP/1.1 413"));
+}
+
+TEST_F(TestHttpServer, RefusesInvalidResponseHeaders)
+{
+    auto server = startServer();
+
+    auto output = exchange(
+        *server,
+        "GET /split HTTP/1.1\r\n\r\n"
+        "GET /invalid HTTP/1.1\r\nConnection: close\r\n\r\n"
+    );
+
+    EXPECT_EQ(
+        output,
+        "HTTP/1.1 500 Internal Server Error\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: 21\r\n"
+        "Connection: keep-alive\r\n\r\nInternal Server Error"
+        "HTTP/1.1 500 Internal Server Error\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: 21\r\n"
+        "Connection: close\r\n\r\nInternal Server Error"
+    );
+}
+
+TEST_F(TestHttpServer, ClosesSlowConnections)
+{
+    using namespace std::chrono_literals;
+    auto server = startServer({ .idleTimeout = 100ms, .headTimeout = 100ms, .bodyTimeout = 100ms });
+
+    EXPECT_EQ(exchange(*server, ""), "");
+    EXPECT_EQ(
+        exchange(*server, "GET /first HTTP/1.1\r\n\r\n"),
+        "HTTP/1.1 200 OK\r\nContent-Length: 11\r\nConnection: keep-alive\r\n\r\nGET /first "
+    );
+    EXPECT_TRUE(exchange(*server, "GET /first HTTP/1.1\r\nX-Te").starts_with("HTTP/1.1 408 Request Timeout\r\n"));
+    EXPECT_TRUE(
+        exchange(*server, "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nhe").starts_with("HTTP/1.1 408 Request Timeout\r\n")
+    );
+}
+
+TEST_F(TestHttpServer, KeepsEnvironmentBusyUntilResponseIsReady)
+{
+    using namespace std::chrono_literals;
+    auto server = startServer();
+    auto fd = connectTo(*server);
+    std::string input = "GET /hold HTTP/1.1\r\nConnection: close\r\n\r\n";
+    ASSERT_EQ(::send(fd, input.data(), input.size(), 0), static_cast<ssize_t>(input.size()));
+
+    // Handler has returned once it defined `release`, while its response is not ready yet
+    auto index = _pool->size();
+    for (int attempt = 0; attempt < 500 && index == _pool->size(); ++attempt) {
+        std::this_thread::sleep_for(10ms);
+        for (size_t i = 0; i < _pool->size(); ++i) {
+            if (folly::coro::blockingWait(_pool->environment(i).evaluateAsync<bool>("typeof release === 'function'"))) {
+                index = i;
+            }
+        }
+    }
+    ASSERT_LT(index, _pool->size());
+    EXPECT_EQ(_pool->load(index), 1);
+
+    folly::coro::blockingWait(_pool->environment(index).evaluateAsync("release('held')"));
+    EXPECT_EQ(readAll(fd), "HTTP/1.1 200 OK\r\nContent-Length: 4\r\nConnection: close\r\n\r\nheld");
+}
+
+TEST_F(TestHttpServer, StopsWithOpenConnections)
+{
+    auto server = startServer();
+    auto fd = connectTo(*server);
+
+    server->stop();
+
+    char byte;
+    EXPECT_LE(::recv(fd, &byte, 1, 0), 0);
+    ::close(fd);
+}
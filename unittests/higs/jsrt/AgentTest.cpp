@@ -0,0 +1,126 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+TEST(TestAgent, CallReturnsResult)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    auto result = env.call([](Environment& env) { return env.evaluateScript("6 * 7").asNumber(); });
+
+    EXPECT_EQ(result, 42);
+}
+
+TEST(TestAgent, CallRunsOnAgentThread)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    auto callerThread = std::this_thread::get_id();
+    auto agentThread = env.call([](Environment&) { return std::this_thread::get_id(); });
+
+    EXPECT_NE(agentThread, callerThread);
+}
+
+TEST(TestAgent, CallPropagatesExceptions)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    EXPECT_THROW(env.call([](Environment&) -> int { throw std::logic_error("failed"); }), std::logic_error);
+    EXPECT_THROW(env.call([](Environment& env) { return env.evaluateScript("throw new Error('x')"); }), jsi::JSError);
+    EXPECT_THROW(env.runNowBlocking([](jsrt::Environment&) { throw std::logic_error("failed"); }), std::logic_error);
+}
+
+TEST(TestAgent, ReentrantCallRunsInline)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    auto result = env.call([](Environment& env) {
+        int inner = 0;
+        env.runNowBlocking([&inner](jsrt::Environment&) { inner = 1; });
+        return inner + env.call([](Environment&) { return 1; });
+    });
+
+    EXPECT_EQ(result, 2);
+}
+
+TEST(TestAgent, CallRunsAfterPreviouslyScheduledTasks)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        env.runLater([&order, i](jsrt::Environment&) { order.push_back(i); });
+    }
+    auto size = env.call([&order](Environment&) { return order.size(); });
+
+    EXPECT_EQ(size, 100U);
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST(TestAgent, RunsTasksAfterOneThrows)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("throwing");
+
+    testing::internal::CaptureStderr();
+    env.runLater([](jsrt::Environment&) { throw std::runtime_error("task failure"); });
+    env.executor()->add(folly::Func());
+    folly::Baton<> ran;
+    env.runLater([&ran](jsrt::Environment&) { ran.post(); });
+    EXPECT_TRUE(ran.try_wait_for(std::chrono::seconds(5)));
+    auto output = testing::internal::GetCapturedStderr();
+
+    EXPECT_NE(output.find("Uncaught error in environment 'throwing': task failure"), std::string::npos);
+    EXPECT_NE(output.find("Uncaught error in agent task"), std::string::npos);
+}
+
+TEST(TestAgent, EnvironmentWaitsForTimers)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("timers");
+
+    std::atomic<bool> ran = false;
+    env.runAfter([&ran](jsrt::Environment& env) {
+        env.runLater([&ran](jsrt::Environment&) { ran.store(true); });
+    }, std::chrono::milliseconds(50));
+    env.waitUntilIdle();
+
+    EXPECT_TRUE(ran.load());
+}
+
+TEST(TestAgent, TasksRunningDuringShutdownUsePlatform)
+{
+    std::atomic<size_t> ran = 0;
+    {
+        auto host = Runtime::create();
+        auto& env = host->createEnvironment("shutdown");
+        for (int i = 0; i < 100; ++i) {
+            env.runLater([&ran](jsrt::Environment& env) {
+                // Agents drain their queues while the runtime is destroyed, its platform must still be alive
+                static_cast<Environment&>(env).host().platform().getBackgroundExecutor().add([] {});
+                ran.fetch_add(1);
+            });
+        }
+    }
+
+    EXPECT_EQ(ran.load(), 100U);
+}
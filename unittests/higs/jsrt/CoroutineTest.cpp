@@ -0,0 +1,91 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <folly/coro/BlockingWait.h>
+#include <folly/coro/Task.h>
+#include <folly/executors/GlobalExecutor.h>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+TEST(TestCoroutine, ScheduleMovesOntoEnvironmentThread)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("scheduled");
+    auto envThread = env.call([](Environment&) { return std::this_thread::get_id(); });
+
+    auto task = [&]() -> folly::coro::Task<std::thread::id> {
+        co_await env.schedule();
+        co_return std::this_thread::get_id();
+    };
+    auto resumedThread = folly::coro::blockingWait(task().scheduleOn(folly::getGlobalCPUExecutor()));
+
+    EXPECT_EQ(resumedThread, envThread);
+}
+
+TEST(TestCoroutine, CallAsyncReturnsResult)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("called");
+
+    auto result = folly::coro::blockingWait(env.callAsync([](Environment& env) {
+        return env.evaluateScript("6 * 7").asNumber();
+    }));
+
+    EXPECT_EQ(result, 42);
+}
+
+TEST(TestCoroutine, EvaluateAsyncAwaitsPromise)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("evaluated");
+
+    auto result = folly::coro::blockingWait(env.evaluateAsync<std::string>(
+        "(async () => { await null; return 'settled'; })()"
+    ));
+
+    EXPECT_EQ(result, "settled");
+}
+
+TEST(TestCoroutine, EvaluateAsyncResolvesPlainValues)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("evaluated");
+
+    auto result = folly::coro::blockingWait(env.evaluateAsync<std::string>("'plain'"));
+
+    EXPECT_EQ(result, "plain");
+}
+
+TEST(TestCoroutine, EvaluateAsyncThrowsOnRejection)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("evaluated");
+
+    EXPECT_THROW(
+        folly::coro::blockingWait(env.evaluateAsync("Promise.reject(new Error('rejected'))")),
+        jsi::JSError
+    );
+}
+
+TEST(TestCoroutine, LoadSourceReadsFile)
+{
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-%%%%%%.js");
+    std::ofstream { path.string() } << "export default 42;";
+
+    auto host = Runtime::create();
+    auto provider = FileSystemSourceProvider::create();
+    jsrt::ResolveRequest request { .path = path.string(), .requesterPath = "" };
+
+    auto source = folly::coro::blockingWait(loadSource(*provider, *host, path.string(), request));
+    boost::filesystem::remove(path);
+
+    EXPECT_EQ(source, "export default 42;");
+}
@@ -0,0 +1,32 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+TEST(TestEnvironmentPool, ReportsTaskErrors)
+{
+    auto host = Runtime::create();
+    auto pool = EnvironmentPool::create(*host, 1, EnvironmentOptions());
+
+    testing::internal::CaptureStderr();
+    pool->run([](jsrt::Environment&) { throw std::runtime_error("native failure"); });
+    pool->runAsync([](jsrt::Environment& env) {
+        return jsrt::conv::fromJS<folly::SemiFuture<folly::Unit>>(
+            env.evaluateScript("Promise.reject(new Error('js failure'))", "task.js"),
+            env
+        );
+    });
+    pool->wait();
+    auto output = testing::internal::GetCapturedStderr();
+
+    EXPECT_NE(output.find("Uncaught error in environment 'pool-0': native failure"), std::string::npos);
+    EXPECT_NE(output.find("js failure"), std::string::npos);
+    EXPECT_EQ(pool->load(0), 0);
+}
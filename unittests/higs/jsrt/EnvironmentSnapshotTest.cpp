@@ -0,0 +1,99 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+auto evaluateNumber(Environment& env, const std::string& script) -> double
+{
+    return env.call([&script](Environment& env) { return env.evaluateScript(script).asNumber(); });
+}
+
+class TestEnvironmentSnapshot : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        _path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-snapshot-%%%%%%");
+        _host = Runtime::create();
+    }
+
+    void TearDown() override
+    {
+        _host.reset();
+        boost::filesystem::remove(_path);
+    }
+
+    auto restore(const EnvironmentSnapshot& snapshot) -> Environment&
+    {
+        return _host->createEnvironment("restored", _host->options().defaultEnvironmentOptions(), snapshot);
+    }
+
+    boost::filesystem::path _path;
+    Runtime::Ptr _host;
+};
+
+}
+
+TEST_F(TestEnvironmentSnapshot, ReplaysRecordedScripts)
+{
+    auto& recorded = _host->createEnvironment("recorded");
+    auto snapshot = recorded.call([](Environment& env) {
+        env.startRecordingSnapshot();
+        env.evaluateScript("var answer = 21;", "answer.js");
+        env.evaluateScript("function twice(x) { return 2 * x; }", "twice.js");
+        return env.finishRecordingSnapshot();
+    });
+    ASSERT_EQ(snapshot->scripts().size(), 2U);
+    EXPECT_EQ(snapshot->scripts()[0].name, "answer.js");
+
+    snapshot->writeToFile(_path.string());
+    auto& env = restore(*EnvironmentSnapshot::readFromFile(_path.string()));
+
+    EXPECT_EQ(evaluateNumber(env, "twice(answer)"), 42);
+}
+
+TEST_F(TestEnvironmentSnapshot, MaterializesLazyGlobalOnFirstAccess)
+{
+    auto snapshot = EnvironmentSnapshot::Builder()
+                        .addScript("counter.js", "var initialized = 0;")
+                        .addLazyGlobal("config", "(function () { initialized++; return { answer: 42 }; })()")
+                        .build();
+    auto& env = restore(*snapshot);
+
+    EXPECT_EQ(evaluateNumber(env, "initialized"), 0);
+    EXPECT_EQ(evaluateNumber(env, "config.answer + config.answer"), 84);
+    EXPECT_EQ(evaluateNumber(env, "initialized"), 1);
+
+    // Accessor is replaced by a data property holding the value
+    EXPECT_EQ(evaluateNumber(env, "Object.getOwnPropertyDescriptor(globalThis, 'config').value.answer"), 42);
+}
+
+TEST_F(TestEnvironmentSnapshot, FailsWhenScriptThrows)
+{
+    auto snapshot = EnvironmentSnapshot::Builder().addScript("broken.js", "throw new Error('broken');").build();
+
+    EXPECT_THROW((void) restore(*snapshot), jsi::JSError);
+
+    // Runtime is still usable, as the partially restored environment is destroyed
+    auto& env = restore(*EnvironmentSnapshot::Builder().addScript("fine.js", "var fine = 1;").build());
+    EXPECT_EQ(evaluateNumber(env, "fine"), 1);
+}
+
+TEST_F(TestEnvironmentSnapshot, RefusesTruncatedFile)
+{
+    EnvironmentSnapshot::Builder().addScript("bundle.js", "var bundled = true;").build()->writeToFile(_path.string());
+    boost::filesystem::resize_file(_path, boost::filesystem::file_size(_path) - 4);
+
+    auto result = EnvironmentSnapshot::tryReadFromFile(_path.string());
+
+    ASSERT_TRUE(result.hasError());
+    EXPECT_NE(result.error().message.find("malformed"), std::string::npos);
+}
@@ -0,0 +1,154 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <fcntl.h>
+
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <folly/executors/IOThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+#include <higs/jsrt/FileEngine.hpp>
+
+using namespace higs;
+
+namespace {
+
+class TestFileEngine : public ::testing::TestWithParam<FileEngineKind> {
+protected:
+    void SetUp() override
+    {
+        if (GetParam() == FileEngineKind::IoUring) {
+            _engine = createIoUringFileEngine(8);
+            if (_engine == nullptr) {
+                GTEST_SKIP() << "io_uring is not available";
+            }
+        }
+        else {
+            _engine = createThreadPoolFileEngine(folly::getKeepAliveToken(_executor));
+        }
+
+        _path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-engine-%%%%%%")).string();
+    }
+
+    void TearDown() override
+    {
+        boost::filesystem::remove(_path);
+    }
+
+    folly::IOThreadPoolExecutor _executor { 1 };
+    std::unique_ptr<FileEngine> _engine;
+    std::string _path;
+};
+
+}
+
+TEST_P(TestFileEngine, ReadsFileInChunks)
+{
+    std::string contents;
+    for (int i = 0; i < 1000; ++i) {
+        contents += std::to_string(i);
+    }
+    folly::writeFile(contents, _path.c_str());
+
+    auto buffer = _engine->readFile(_path, 64).get();
+
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()), contents);
+}
+
+TEST_P(TestFileEngine, ReadsBatchAndStopsAtEndOfFile)
+{
+    folly::writeFile(std::string("abcdef"), _path.c_str());
+    auto fd = folly::openNoInt(_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    std::array<uint8_t, 4> first {};
+    std::array<uint8_t, 4> second {};
+    std::array<FileReadRequest, 2> requests { {
+        { .fd = fd, .buffer = first, .offset = 0 },
+        { .fd = fd, .buffer = second, .offset = 4 },
+    } };
+    auto results = _engine->read(requests);
+
+    EXPECT_EQ(std::move(results[0]).get(), 4);
+    EXPECT_EQ(std::move(results[1]).get(), 2);
+    EXPECT_EQ(std::string(second.begin(), second.begin() + 2), "ef");
+    folly::closeNoInt(fd);
+}
+
+TEST_P(TestFileEngine, ReadsFileWithMoreChunksThanRingHolds)
+{
+    // Completion queue of a ring of 8 entries holds 16 completions, the file is read in 1024 chunks at once
+    std::string contents;
+    for (int i = 0; contents.size() < 1024 * 64; ++i) {
+        contents += std::to_string(i);
+    }
+    contents.resize(1024 * 64);
+    folly::writeFile(contents, _path.c_str());
+
+    auto buffer = _engine->readFile(_path, 64).get();
+
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(buffer->data()), buffer->size()), contents);
+}
+
+TEST_P(TestFileEngine, ReadsIntoRegisteredBuffers)
+{
+    folly::writeFile(std::string("abcdefgh"), _path.c_str());
+    auto fd = folly::openNoInt(_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    std::array<uint8_t, 8> memory {};
+    std::array<std::span<uint8_t>, 1> buffers { memory };
+    auto registered = _engine->registerBuffers(buffers);
+    EXPECT_EQ(registered, GetParam() == FileEngineKind::IoUring);
+
+    std::array<FileReadRequest, 2> requests { {
+        { .fd = fd, .buffer = std::span(memory).first(4), .offset = 4, .registeredBuffer = 0 },
+        { .fd = fd, .buffer = std::span(memory).last(4), .offset = 0, .registeredBuffer = 0 },
+    } };
+    auto results = _engine->read(requests);
+
+    EXPECT_EQ(std::move(results[0]).get(), 4);
+    EXPECT_EQ(std::move(results[1]).get(), 4);
+    EXPECT_EQ(std::string(memory.begin(), memory.end()), "efghabcd");
+    EXPECT_TRUE(_engine->registerBuffers({}));
+    folly::closeNoInt(fd);
+}
+
+TEST_P(TestFileEngine, FailsOnMissingFile)
+{
+    EXPECT_THROW(_engine->readFile(_path + ".missing").get(), std::system_error);
+}
+
+TEST_P(TestFileEngine, FailsReadOfInvalidDescriptor)
+{
+    std::array<uint8_t, 4> buffer {};
+    EXPECT_THROW(_engine->read(-1, buffer, 0).get(), std::system_error);
+}
+
+TEST_P(TestFileEngine, CompletesPendingReadsWhenDestroyed)
+{
+    folly::writeFile(std::string(1 << 20, 'x'), _path.c_str());
+    auto fd = folly::openNoInt(_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    // More reads than entries of the ring, still in flight when the engine is destroyed
+    std::vector<std::array<uint8_t, 4096>> buffers(64);
+    std::vector<FileReadRequest> requests;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        requests.push_back({ .fd = fd, .buffer = buffers[i], .offset = i * 4096 });
+    }
+    auto results = _engine->read(requests);
+    _engine.reset();
+    _executor.join();
+
+    for (auto& result : results) {
+        ASSERT_TRUE(result.isReady());
+        EXPECT_EQ(std::move(result).get(), 4096);
+    }
+    folly::closeNoInt(fd);
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines, TestFileEngine, ::testing::Values(FileEngineKind::ThreadPool, FileEngineKind::IoUring));
@@ -0,0 +1,49 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <higs/jsrt/HeapMetrics.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+using namespace std::chrono_literals;
+
+TEST(TestGCTimer, TimesOverlappingCollectionsPerGeneration)
+{
+    GCTimer timer;
+
+    // Young generation collection runs while the old generation is collected concurrently
+    timer.collectionStarted("GC Old Gen");
+    std::this_thread::sleep_for(20ms);
+    timer.collectionStarted("GC Young Gen");
+    std::this_thread::sleep_for(5ms);
+    timer.collectionFinished("GC Young Gen");
+    timer.collectionFinished("GC Old Gen");
+
+    HeapMetrics metrics;
+    timer.fill(metrics);
+
+    EXPECT_GE(metrics.totalGCPauseTime, 5ms);
+    EXPECT_LT(metrics.totalGCPauseTime, 20ms);
+    EXPECT_EQ(metrics.maxGCPauseTime, metrics.totalGCPauseTime);
+    EXPECT_GE(metrics.totalOldGenGCTime, 25ms);
+}
+
+TEST(TestGCTimer, MeasuresPausesOfEnvironment)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("gc");
+
+    auto metrics = env.call([](Environment& env) {
+        env.evaluateScript("for (let i = 0; i < 100000; ++i) { globalThis.last = { i, s: 'x' + i }; }");
+        env.collectGarbage("test");
+        return env.heapMetrics();
+    });
+
+    EXPECT_GT(metrics.numCollections, 0U);
+    EXPECT_LE(metrics.maxGCPauseTime, metrics.totalGCPauseTime);
+}
@@ -0,0 +1,72 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+template<ThreadSafetyOption ThreadSafety>
+struct Tracked : RefCounted<Tracked<ThreadSafety>, ThreadSafety> {
+    explicit Tracked(bool& destroyed) : destroyed(destroyed) {}
+    ~Tracked() { destroyed = true; }
+
+    bool& destroyed;
+};
+
+using SharedTracked = Tracked<ThreadSafetyOption::enable>;
+using ConfinedTracked = Tracked<ThreadSafetyOption::disable>;
+
+}
+
+TEST(TestRefCounted, ThreadSafetyIsConfigurable)
+{
+    EXPECT_TRUE(SharedTracked::IsThreadSafe);
+    EXPECT_FALSE(ConfinedTracked::IsThreadSafe);
+}
+
+TEST(TestRefCounted, SharedCountsReferences)
+{
+    bool destroyed = false;
+    auto ref = SharedTracked::create(destroyed);
+    {
+        auto copy = ref;
+        EXPECT_EQ(ref->refCount(), 2U);
+    }
+    EXPECT_EQ(ref->refCount(), 1U);
+
+    ref.reset();
+    EXPECT_TRUE(destroyed);
+}
+
+TEST(TestRefCounted, ConfinedCountsReferences)
+{
+    bool destroyed = false;
+    auto ref = ConfinedTracked::create(destroyed);
+    {
+        auto copy = ref;
+        EXPECT_EQ(ref->refCount(), 2U);
+    }
+    EXPECT_EQ(ref->refCount(), 1U);
+
+    ref.reset();
+    EXPECT_TRUE(destroyed);
+}
+
+TEST(TestRefCounted, ConfinedOwnershipCanBeTransferred)
+{
+    bool destroyed = false;
+    auto ref = ConfinedTracked::create(destroyed);
+
+    auto host = Runtime::create();
+    host->mainEnvironment().agent().runNowBlocking([&ref] {
+        ref->transferOwnership();
+        auto copy = ref;
+        ref.reset();
+    });
+
+    EXPECT_TRUE(destroyed);
+}
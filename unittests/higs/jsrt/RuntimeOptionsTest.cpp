@@ -0,0 +1,33 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+TEST(TestRuntimeOptions, CreatedEnvironmentsAreIsolated)
+{
+    auto host = Runtime::create();
+    auto&& main = host->mainEnvironment();
+    auto&& other = host->createEnvironment("other");
+
+    main.evaluateScript("globalThis.marker = 1");
+
+    EXPECT_EQ(other.name(), "other");
+    EXPECT_EQ(other.evaluateScript("typeof marker").asString(other).utf8(other), "undefined");
+}
+
+TEST(TestRuntimeOptions, HeapStaysWithinMaxHeapSize)
+{
+    auto options = EnvironmentOptions().withInitHeapSize(1 << 20).withMaxHeapSize(8 << 20);
+    auto host = Runtime::create(RuntimeOptions().withDefaultEnvironmentOptions(options));
+    auto&& env = host->mainEnvironment();
+
+    env.evaluateScript("for (let i = 0; i < 10000; ++i) { new Array(1024).fill(i); }");
+
+    EXPECT_EQ(env.options().maxHeapSize(), 8U << 20);
+    EXPECT_LE(env.heapMetrics().heapSize, 8U << 20);
+    EXPECT_GT(env.heapMetrics().numCollections, 0U);
+}
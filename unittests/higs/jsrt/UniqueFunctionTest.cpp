@@ -0,0 +1,84 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <array>
+#include <functional>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+TEST(TestUniqueFunction, HoldsMoveOnlyCaptures)
+{
+    auto value = std::make_unique<int>(42);
+    jsrt::UniqueFunction<int()> func = [value = std::move(value)] { return *value; };
+    auto moved = std::move(func);
+
+    EXPECT_FALSE(func);
+    ASSERT_TRUE(moved);
+    EXPECT_EQ(moved(), 42);
+}
+
+TEST(TestUniqueFunction, StoresSmallCallablesInline)
+{
+    auto small = [value = 1] { return value; };
+    auto large = [value = std::array<char, 256> {}] { return value[0]; };
+
+    EXPECT_TRUE(jsrt::UniqueFunction<int()>::isStoredInline<decltype(small)>);
+    EXPECT_FALSE(jsrt::UniqueFunction<char()>::isStoredInline<decltype(large)>);
+
+    jsrt::UniqueFunction<char()> func = large;
+    EXPECT_EQ(func(), 0);
+}
+
+TEST(TestUniqueFunction, DestroysCallable)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        jsrt::UniqueFunction<void()> func = [counter] {};
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(TestUniqueFunction, EmptyFromNull)
+{
+    std::function<void()> empty;
+    jsrt::UniqueFunction<void()> fromStdFunction = empty;
+    jsrt::UniqueFunction<void()> fromNull = nullptr;
+
+    EXPECT_FALSE(fromStdFunction);
+    EXPECT_FALSE(fromNull);
+    EXPECT_THROW(fromNull(), std::bad_function_call);
+}
+
+TEST(TestUniqueFunction, EnvironmentTaskFitsAgentTask)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    // Same shape as the task `Environment::runLater` schedules on its agent
+    auto task = [func = jsrt::ScheduledJSFunction {}, ref = env.asRef()] {};
+    EXPECT_TRUE(jsrt::AgentTask::isStoredInline<decltype(task)>);
+}
+
+TEST(TestUniqueFunction, SchedulesMoveOnlyTask)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+    auto value = std::make_unique<int>(7);
+    folly::Baton<> done;
+    int seen = 0;
+
+    env.runLater([value = std::move(value), &seen, &done](jsrt::Environment&) {
+        seen = *value;
+        done.post();
+    });
+    done.wait();
+
+    EXPECT_EQ(seen, 7);
+}
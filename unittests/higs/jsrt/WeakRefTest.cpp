@@ -0,0 +1,74 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+struct Observed : RefCounted<Observed> {};
+
+}
+
+TEST(TestWeakRef, LocksWhileObjectIsAlive)
+{
+    auto ref = Observed::create();
+    WeakRef<Observed> weak { ref };
+
+    EXPECT_FALSE(weak.expired());
+    {
+        auto locked = weak.lock();
+        EXPECT_EQ(locked.get(), ref.get());
+        EXPECT_EQ(ref->refCount(), 2U);
+    }
+    EXPECT_EQ(ref->refCount(), 1U);
+}
+
+TEST(TestWeakRef, ExpiresWithObject)
+{
+    auto ref = Observed::create();
+    WeakRef<Observed> weak { ref };
+    auto copy = weak;
+
+    ref.reset();
+
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(weak.lock(), nullptr);
+    EXPECT_EQ(copy.lock(), nullptr);
+}
+
+TEST(TestWeakRef, OutlivedByObject)
+{
+    auto ref = Observed::create();
+    {
+        WeakRef<Observed> weak { ref };
+    }
+    WeakRef<Observed> weak { ref };
+
+    EXPECT_EQ(weak.lock().get(), ref.get());
+    EXPECT_EQ(ref->refCount(), 1U);
+}
+
+TEST(TestWeakRef, EmptyIsExpired)
+{
+    WeakRef<Observed> weak;
+
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(weak.lock(), nullptr);
+}
+
+TEST(TestWeakRef, ExpiresWhenEnvironmentIsDestroyed)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("observed");
+    WeakRef<Environment> weak { &env };
+
+    EXPECT_NE(weak.lock(), nullptr);
+
+    host->destroyEnvironment(env);
+
+    EXPECT_TRUE(weak.expired());
+}
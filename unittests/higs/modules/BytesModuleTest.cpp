@@ -0,0 +1,144 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+
+namespace {
+
+auto evaluateString(Environment& env, const std::string& body) -> std::string
+{
+    return env.call([&body](Environment& env) {
+        auto script = "(() => { const bytes = require('bytes'); " + body + " })()";
+        return env.evaluateScript(script).getString(env).utf8(env);
+    });
+}
+
+}
+
+TEST(TestBytesModule, EncodesAndDecodesHex)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const data = Uint8Array.from({ length: 100 }, (_, i) => i * 7);
+        const hex = bytes.toHex(data);
+        const decoded = new Uint8Array(bytes.fromHex(hex.toUpperCase()));
+        let invalid = false;
+        try {
+            bytes.fromHex('0g');
+        }
+        catch (e) {
+            invalid = true;
+        }
+        return hex.slice(0, 10) + ':' + (bytes.compare(decoded, data) === 0) + ':' + invalid;
+    )");
+
+    EXPECT_EQ(result, "00070e151c:true:true");
+}
+
+TEST(TestBytesModule, EncodesAndDecodesBase64)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const data = new Uint8Array([0xFB, 0xFF, 0x61]);
+        const decoded = new Uint8Array(bytes.fromBase64('aGVsbG8='));
+        return [
+            bytes.toBase64(data),
+            bytes.toBase64(data, { alphabet: 'base64url' }),
+            String.fromCharCode(...decoded),
+        ].join('|');
+    )");
+
+    EXPECT_EQ(result, "+/9h|-_9h|hello");
+}
+
+TEST(TestBytesModule, FindsAndComparesBytes)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const data = new TextEncoder().encode('x'.repeat(100) + 'needle' + 'x'.repeat(100) + 'needle');
+        return [
+            bytes.indexOf(data, 'needle'),
+            bytes.indexOf(data, 'needle', 101),
+            bytes.indexOf(data, 0x6E),
+            bytes.indexOf(data, 'absent'),
+            bytes.compare(new Uint8Array([1, 2]), new Uint8Array([1, 3])),
+            bytes.compare(new Uint8Array([1, 2, 0]), new Uint8Array([1, 2])),
+        ].join(',');
+    )");
+
+    EXPECT_EQ(result, "100,206,100,-1,-1,1");
+}
+
+TEST(TestBytesModule, FillsConcatenatesAndReads)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        const head = bytes.fill(new Uint8Array(4), 0xAB, 1, 3);
+        const joined = new Uint8Array(bytes.concat([head, new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8]).buffer]));
+        return [
+            Array.from(joined.subarray(0, 5)).join(' '),
+            bytes.readUint16(joined, 1).toString(16),
+            bytes.readInt16(joined, 1, true),
+            bytes.readUint32(joined, 4),
+            bytes.readBigUint64(joined, 4, true).toString(16),
+            bytes.readInt8(head, 1),
+        ].join(',');
+    )");
+
+    EXPECT_EQ(result, "0 171 171 0 1,abab,-21589,16909060,807060504030201,-85");
+    EXPECT_THROW(evaluateString(env, "return bytes.readUint32(new Uint8Array(4), 1);"), jsi::JSError);
+    EXPECT_THROW(evaluateString(env, "return bytes.readUint32(new Uint8Array(4), NaN);"), jsi::JSError);
+    EXPECT_THROW(evaluateString(env, "return bytes.readUint8(new Uint8Array(4), 0.5);"), jsi::JSError);
+}
+
+TEST(TestBytesModule, WrapsBytesOutOfIntegerRange)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    auto result = evaluateString(env, R"(
+        return [1e300, -1, -257.5, 2 ** 64 + 4096, 300].map((byte) => bytes.fill(new Uint8Array(1), byte)[0]).join(',');
+    )");
+
+    EXPECT_EQ(result, "0,255,255,0,44");
+}
+
+TEST(TestBytesModule, RejectsViewsOutsideTheirBuffer)
+{
+    auto host = Runtime::create();
+    auto& env = host->mainEnvironment();
+
+    // Views are recognized by their properties, which getters may report as anything
+    auto result = evaluateString(env, R"(
+        const buffer = new ArrayBuffer(8);
+        const errors = [];
+        for (const [byteOffset, byteLength] of [[NaN, 1], [0, Infinity], [-1, 1], [4, 8]]) {
+            try {
+                bytes.concat([new Uint8Array(2), { buffer, byteOffset, byteLength }]);
+            } catch (error) {
+                errors.push(error.message);
+            }
+        }
+        return errors.join('|');
+    )");
+
+    EXPECT_EQ(
+        result,
+        "Expected an ArrayBuffer, a typed array or a DataView|Expected an ArrayBuffer, a typed array or a DataView|"
+        "Expected an ArrayBuffer, a typed array or a DataView|View is outside the bounds of its ArrayBuffer"
+    );
+}
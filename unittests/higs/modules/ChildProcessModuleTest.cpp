@@ -0,0 +1,131 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "ModuleTestCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+auto evaluate(Environment& env, const std::string& body) -> std::string
+{
+    return test::evaluateWithModule(env, "child_process", body, test::kReadAll);
+}
+
+}
+
+TEST(TestChildProcessModule, StreamsOutput)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("child_process");
+
+    auto result = evaluate(env, R"(
+        const child = child_process.spawn('sh', ['-c', 'echo "out $0"; echo err >&2', 'arg'], { env: { LANG: 'C' } });
+        const [out, err, status] = await Promise.all([readAll(child.stdout), readAll(child.stderr), child.exited]);
+        return [child.pid > 0, JSON.stringify(out), JSON.stringify(err), status.code, status.signal].join(',');
+    )");
+
+    EXPECT_EQ(result, R"(true,"out arg\n","err\n",0,)");
+}
+
+TEST(TestChildProcessModule, ReportsExitCodeAndSignal)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("child_process");
+
+    auto result = evaluate(env, R"(
+        const failing = child_process.spawn('sh', ['-c', 'exit 3'], { stdio: 'ignore' });
+        const sleeping = child_process.spawn('sleep', ['30'], { stdio: ['ignore', 'pipe', 'inherit'] });
+        const invalid = [NaN, 1.5, -1].map((signal) => {
+            try {
+                sleeping.kill(signal);
+            } catch (error) {
+                return error.name;
+            }
+        });
+        sleeping.kill('SIGKILL');
+        const [failed, killed] = await Promise.all([failing.exited, sleeping.exited]);
+        return [failed.code, killed.code, killed.signal, failing.stdout, sleeping.stderr, ...invalid].join(',');
+    )");
+
+    EXPECT_EQ(result, "3,,SIGKILL,,,RangeError,RangeError,RangeError");
+}
+
+TEST(TestChildProcessModule, PipesLargeStreamThroughSlowReader)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("child_process");
+
+    // Reader falls behind `cat`, so reading of its stdout pauses at the high water mark, and `cat` blocks
+    auto result = evaluate(env, R"(
+        const highWaterMark = 1 << 14;
+        const child = child_process.spawn('cat', [], { highWaterMark });
+        const data = new Uint8Array(4 << 20).fill(7);
+        const written = child.write(data).then(() => child.end());
+
+        let total = 0;
+        let largest = 0;
+        for (let chunk; (chunk = await child.stdout.read()) !== null;) {
+            total += chunk.byteLength;
+            largest = Math.max(largest, chunk.byteLength);
+            for (let i = 0; i < 100; ++i) {
+                await null;
+            }
+        }
+        await written;
+        const status = await child.exited;
+        return [total === data.byteLength, largest > 0 && largest <= highWaterMark, status.code].join(',');
+    )");
+
+    EXPECT_EQ(result, "true,true,0");
+}
+
+TEST(TestChildProcessModule, RunsProcessesInParallel)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("child_process");
+
+    auto result = evaluate(env, R"(
+        const children = Array.from({ length: 32 }, (_, i) => child_process.spawn('sh', ['-c', 'sleep 0.1; echo $0', String(i)]));
+        const outputs = await Promise.all(children.map((child) => readAll(child.stdout)));
+        const statuses = await Promise.all(children.map((child) => child.exited));
+        return [outputs.map(Number).reduce((a, b) => a + b), statuses.every((status) => status.code === 0)].join(',');
+    )");
+
+    EXPECT_EQ(result, "496,true");
+}
+
+TEST(TestChildProcessModule, RejectsInvalidSpawns)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("child_process");
+
+    auto result = evaluate(env, R"(
+        const errors = [];
+        for (const [file, args, options] of [
+            ['higs-no-such-command', [], {}],
+            ['sh', 'not an array', {}],
+            ['sh', [], { stdio: 'socket' }],
+            ['sh', [], { highWaterMark: Infinity }],
+        ]) {
+            try {
+                child_process.spawn(file, args, options);
+            } catch (error) {
+                errors.push(error.message);
+            }
+        }
+        return errors.join('|');
+    )");
+
+    EXPECT_EQ(
+        result,
+        "Cannot spawn 'higs-no-such-command': No such file or directory|Argument 'args' must be an array of strings|"
+        "Option 'stdio' must be 'pipe', 'inherit' or 'ignore', or an array of these|"
+        "'highWaterMark' must be an integer from 1 to 1073741824"
+    );
+}
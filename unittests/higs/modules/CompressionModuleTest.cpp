@@ -0,0 +1,86 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "ModuleTestCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+auto evaluate(Environment& env, const std::string& body) -> std::string
+{
+    return test::evaluateWithModule(env, "compression", body);
+}
+
+}
+
+TEST(TestCompressionModule, RoundTripsSynchronouslyAndInStreams)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("compression");
+
+    auto result = evaluate(env, R"(
+        const text = 'hello compression '.repeat(100);
+        const decoder = new TextDecoder();
+        const gzip = compression.compress('gzip', text, { level: 9 });
+
+        const compressor = compression.createCompressor('zstd');
+        const parts = [compressor.write(text), compressor.end()];
+        const decompressor = compression.createDecompressor('zstd');
+        const restored = parts.map((part) => decoder.decode(decompressor.write(part))).join('')
+            + decoder.decode(decompressor.end());
+
+        return [
+            gzip.byteLength < text.length,
+            decoder.decode(compression.decompress('gzip', gzip)) === text,
+            restored === text,
+        ].join(',');
+    )");
+
+    EXPECT_EQ(result, "true,true,true");
+}
+
+TEST(TestCompressionModule, CompressesLargeInputsInParallel)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("compression");
+
+    auto result = evaluate(env, R"(
+        const data = new Uint8Array(1 << 20).map((_, i) => i % 251);
+        const compressed = await compression.compressAsync('zstd', data, { parallel: true, blockSize: 1 << 16 });
+        data[0] = 1;
+        const restored = new Uint8Array(await compression.decompressAsync('zstd', compressed));
+        const deflated = await compression.compressAsync('deflate', restored);
+        const inflated = new Uint8Array(await compression.decompressAsync('deflate', deflated));
+        return [restored.length, restored[0], restored[300], inflated.length].join(',');
+    )");
+
+    EXPECT_EQ(result, "1048576,0,49,1048576");
+}
+
+TEST(TestCompressionModule, ValidatesOptions)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("compression");
+
+    auto result = evaluate(env, R"(
+        const errors = [];
+        for (const options of [{ blockSize: NaN }, { blockSize: 0.5 }, { blockSize: Infinity }, { blockSize: 1024 }, { level: NaN }]) {
+            try {
+                await compression.compressAsync('zstd', 'data', { parallel: true, ...options });
+            } catch (error) {
+                errors.push(error.name);
+            }
+        }
+        const clamped = compression.compress('zstd', 'data', { level: 1e9 });
+        const restored = new TextDecoder().decode(compression.decompress('zstd', clamped));
+        return [...errors, restored].join(',');
+    )");
+
+    EXPECT_EQ(result, "RangeError,RangeError,RangeError,RangeError,RangeError,data");
+}
@@ -0,0 +1,62 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "ModuleTestCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+auto evaluate(Environment& env, const std::string& body) -> std::string
+{
+    return test::evaluateWithModule(env, "digest", body);
+}
+
+}
+
+TEST(TestDigestModule, HashesSynchronouslyAndIncrementally)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("digest");
+
+    auto result = evaluate(env, R"(
+        const hash = digest.createHash('sha-256');
+        hash.update('a');
+        hash.update(new TextEncoder().encode('bc'));
+        return [
+            digest.hash('sha256', 'abc', 'hex'),
+            hash.digest('hex'),
+            hash.algorithm,
+            new Uint8Array(digest.hash('crc32c', '123456789')).join(','),
+        ].join('|');
+    )");
+
+    EXPECT_EQ(
+        result,
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad|"
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad|sha256|227,6,146,131"
+    );
+}
+
+TEST(TestDigestModule, HashesLargeInputsInBackground)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("digest");
+
+    // Input is modified right after the call, which must not affect the digest
+    auto result = evaluate(env, R"(
+        const data = new Uint8Array(1 << 20).fill(7);
+        const expected = digest.hash('xxh3', data, 'hex');
+        const pending = digest.hashAsync('xxh3', data, 'hex');
+        data.fill(0);
+        const small = await digest.hashAsync('sha1', 'abc', 'hex');
+        return [(await pending) === expected, small].join('|');
+    )");
+
+    EXPECT_EQ(result, "true|a9993e364706816aba3e25717850c26c9cd0d89d");
+}
@@ -0,0 +1,80 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <gtest/gtest.h>
+#include <higs/modules/FileReadStream.hpp>
+#include <higs/runtime.hpp>
+
+using namespace higs;
+using modules::FileReadStream;
+
+namespace {
+
+class TestFileReadStream : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        _path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-stream-%%%%%%");
+    }
+
+    void TearDown() override
+    {
+        boost::filesystem::remove(_path);
+    }
+
+    /**
+     * Gets following chunk of `stream`, blocking until it is read.
+     */
+    static auto next(Environment& env, FileReadStream& stream) -> modules::FileChunk
+    {
+        return env.call([&stream](Environment&) { return stream.next(); }).get();
+    }
+
+    boost::filesystem::path _path;
+};
+
+}
+
+TEST_F(TestFileReadStream, ClosesFileAtEnd)
+{
+    ASSERT_TRUE(folly::writeFile(std::string(1000, 'x'), _path.c_str()));
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("stream");
+
+    auto stream = env.call([this](Environment& env) {
+        return FileReadStream::open(env, _path.string(), { .chunkSize = 64, .readahead = 2 });
+    });
+
+    size_t chunks = 0;
+    size_t total = 0;
+    for (auto chunk = next(env, *stream); !chunk.done; chunk = next(env, *stream)) {
+        ++chunks;
+        total += chunk.buffer->size();
+        if (chunks < 16) {
+            EXPECT_EQ(env.call([&](Environment&) { return stream->bufferCount(); }), 3);
+            EXPECT_TRUE(env.call([&](Environment&) { return stream->isFileOpen(); }));
+        }
+    }
+
+    EXPECT_EQ(chunks, 16);
+    EXPECT_EQ(total, 1000);
+    EXPECT_EQ(env.call([&](Environment&) { return stream->bufferCount(); }), 0);
+    EXPECT_FALSE(env.call([&](Environment&) { return stream->isFileOpen(); }));
+}
+
+TEST_F(TestFileReadStream, ClosesEmptyFile)
+{
+    ASSERT_TRUE(folly::writeFile(std::string(), _path.c_str()));
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("stream");
+
+    auto stream = env.call([this](Environment& env) { return FileReadStream::open(env, _path.string(), {}); });
+
+    EXPECT_TRUE(next(env, *stream).done);
+    EXPECT_FALSE(env.call([&](Environment&) { return stream->isFileOpen(); }));
+}
@@ -0,0 +1,194 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "ModuleTestCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+class TestFileSystemModule : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        _dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-fs-%%%%%%");
+        boost::filesystem::create_directories(_dir);
+    }
+
+    void TearDown() override
+    {
+        boost::filesystem::remove_all(_dir);
+    }
+
+    auto path(const std::string& name) const -> std::string
+    {
+        return (_dir / name).string();
+    }
+
+    template<typename T>
+    auto evaluate(Environment& env, const std::string& body) -> T
+    {
+        return test::evaluateWithModule<T>(env, "fs", body, fmt::format("const dir = '{}';", _dir.string()));
+    }
+
+    boost::filesystem::path _dir;
+};
+
+}
+
+TEST_F(TestFileSystemModule, WritesAndReadsText)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto contents = evaluate<std::string>(env, R"(
+        await fs.writeFile(dir + '/a.txt', 'hello');
+        return await fs.readFile(dir + '/a.txt', 'utf8');
+    )");
+
+    EXPECT_EQ(contents, "hello");
+}
+
+TEST_F(TestFileSystemModule, ReadsArrayBuffer)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto bytes = evaluate<std::string>(env, R"(
+        await fs.writeFile(dir + '/b.bin', new Uint8Array([1, 2, 3]));
+        const buffer = await fs.readFile(dir + '/b.bin');
+        return (buffer instanceof ArrayBuffer) + ':' + Array.from(new Uint8Array(buffer)).join(',');
+    )");
+
+    EXPECT_EQ(bytes, "true:1,2,3");
+}
+
+TEST_F(TestFileSystemModule, StatsAndListsDirectory)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = evaluate<std::string>(env, R"(
+        await fs.writeFile(dir + '/c.txt', '1234');
+        const stat = await fs.stat(dir + '/c.txt');
+        const names = await fs.readdir(dir);
+        return stat.size + ':' + stat.isFile + ':' + (await fs.stat(dir)).isDirectory + ':' + names.join(',');
+    )");
+
+    EXPECT_EQ(result, "4:true:true:c.txt");
+}
+
+TEST_F(TestFileSystemModule, ReadsAndWritesAtPositions)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = evaluate<std::string>(env, R"(
+        const fd = await fs.open(dir + '/d.txt', 'w+');
+        await fs.write(fd, 'abcdef', 0);
+        await fs.write(fd, 'XY', 2);
+        const chunk = await fs.read(fd, 3, 1);
+        const tail = await fs.read(fd, 10, 6);
+        await fs.close(fd);
+        return String.fromCharCode(...new Uint8Array(chunk)) + ':' + tail.byteLength;
+    )");
+
+    EXPECT_EQ(result, "bXY:0");
+}
+
+TEST_F(TestFileSystemModule, RejectsInvalidIntegers)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = evaluate<std::string>(env, R"(
+        const fd = await fs.open(dir + '/g.txt', 'w+');
+        const errors = [];
+        for (const [length, position] of [[-1, 0], [1.5, 0], [NaN, 0], [Infinity, 0], [1, -1], [1, 0.5]]) {
+            try {
+                await fs.read(fd, length, position);
+            } catch (error) {
+                errors.push(error.name);
+            }
+        }
+        await fs.close(fd);
+        return errors.join(',');
+    )");
+
+    EXPECT_EQ(result, "RangeError,RangeError,RangeError,RangeError,RangeError,RangeError");
+}
+
+TEST_F(TestFileSystemModule, RejectsMissingFile)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto message = evaluate<std::string>(env, R"(
+        return await fs.readFile(dir + '/missing').then(() => 'resolved', e => e.message);
+    )");
+
+    EXPECT_NE(message.find("missing"), std::string::npos);
+}
+
+TEST_F(TestFileSystemModule, RequireCachesModule)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = env.call([](Environment& env) {
+        return env.evaluateScript("require('fs') === require('higs:fs')").getBool();
+    });
+
+    EXPECT_TRUE(result);
+    EXPECT_THROW(env.call([](Environment& env) { return env.evaluateScript("require('missing')"); }), jsi::JSError);
+}
+
+TEST_F(TestFileSystemModule, StreamsFileInChunks)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = evaluate<std::string>(env, R"(
+        const contents = Array.from({ length: 1000 }, (_, i) => String(i % 10)).join('');
+        await fs.writeFile(dir + '/e.txt', contents);
+
+        const sizes = [];
+        let text = '';
+        for await (const chunk of fs.createReadStream(dir + '/e.txt', { chunkSize: 64, readahead: 2 })) {
+            sizes.push(chunk.byteLength);
+            text += String.fromCharCode(...new Uint8Array(chunk));
+        }
+        return sizes.length + ':' + sizes[sizes.length - 1] + ':' + (text === contents);
+    )");
+
+    EXPECT_EQ(result, "16:40:true");
+}
+
+TEST_F(TestFileSystemModule, StopsStreamWhenLoopIsLeft)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("fs");
+
+    auto result = evaluate<std::string>(env, R"(
+        await fs.writeFile(dir + '/f.txt', 'x'.repeat(1000));
+        const stream = fs.createReadStream(dir + '/f.txt', { chunkSize: 100 });
+        let chunks = 0;
+        for await (const chunk of stream) {
+            if (++chunks === 2) {
+                break;
+            }
+        }
+        const after = await stream.next();
+        const missing = await fs.createReadStream(dir + '/missing').next().then(() => 'resolved', e => e.message);
+        return chunks + ':' + after.done + ':' + missing.includes('missing');
+    )");
+
+    EXPECT_EQ(result, "2:true:true");
+}
@@ -0,0 +1,46 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+
+#pragma once
+
+#include <string>
+
+#include <fmt/format.h>
+#include <folly/coro/BlockingWait.h>
+#include <higs/runtime.hpp>
+
+namespace higs::test {
+
+/**
+ * Defines `readAll(stream)`, reading a stream with `read()` (e.g. a socket, or output of a process) until end of
+ * stream as a string.
+ */
+constexpr auto kReadAll = R"(
+    const readAll = async (stream) => {
+        const decoder = new TextDecoder();
+        let text = '';
+        for (let chunk; (chunk = await stream.read()) !== null;) {
+            text += decoder.decode(chunk, { stream: true });
+        }
+        return text;
+    };
+)";
+
+/**
+ * Evaluates `body` of an async function, in which built-in module `module` is a constant of the same name, and
+ * waits for its result.
+ *
+ * @param prelude Code preceding the body, e.g. definitions of helpers
+ */
+template<typename T = std::string>
+auto evaluateWithModule(Environment& env, const char* module, const std::string& body, const std::string& prelude = {})
+    -> T
+{
+    return folly::coro::blockingWait(env.evaluateAsync<T>(
+        fmt::format("(async () => {{ const {0} = require('{0}'); {1} {2} }})()", module, prelude, body)
+    ));
+}
+
+}
@@ -0,0 +1,152 @@
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <higs/runtime.hpp>
+#include "ModuleTestCommon.hpp"
+
+using namespace higs;
+
+namespace {
+
+/**
+ * Defines `echo(socket)`, writing back all data received by the socket.
+ */
+constexpr auto kEcho = R"(
+    const echo = async (socket) => {
+        for (let chunk; (chunk = await socket.read()) !== null;) {
+            await socket.write(chunk);
+        }
+        socket.end();
+    };
+)";
+
+auto evaluate(Environment& env, const std::string& body) -> std::string
+{
+    return test::evaluateWithModule(env, "net", body, std::string(kEcho) + test::kReadAll);
+}
+
+}
+
+TEST(TestNetModule, EchoesOverTcp)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("net");
+
+    auto result = evaluate(env, R"(
+        const server = net.listen({ host: '127.0.0.1', port: 0 }, echo);
+        const socket = await net.connect({ host: 'localhost', port: server.port });
+        const text = 'hello net '.repeat(10000);
+        await socket.write(text);
+        socket.end();
+        const echoed = await readAll(socket);
+        server.close();
+        return [server.port > 0, echoed === text, socket.remoteAddress.startsWith('127.0.0.1')].join(',');
+    )");
+
+    EXPECT_EQ(result, "true,true,true");
+}
+
+TEST(TestNetModule, EchoesOverUnixSocket)
+{
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("higs-net-%%%%%%.sock");
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("net");
+
+    auto result = evaluate(env, "const path = '" + path.string() + R"(';
+        const server = net.listen({ path }, echo);
+        const socket = await net.connect({ path });
+        await socket.write(new Uint8Array([1, 2, 3]));
+        socket.end();
+        const echoed = new Uint8Array(await socket.read());
+        const end = await socket.read();
+        server.close();
+        return [server.path === path, echoed.join(':'), end].join(',');
+    )");
+    boost::filesystem::remove(path);
+
+    EXPECT_EQ(result, "true,1:2:3,null");
+}
+
+TEST(TestNetModule, DeliversLargeStreamToSlowReader)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("net");
+
+    // Reader falls behind the writer, so the server socket pauses reading at its high water mark, and resumes
+    auto result = evaluate(env, R"(
+        let total = 0;
+        let done;
+        const finished = new Promise((resolve) => { done = resolve; });
+        const server = net.listen({ host: '127.0.0.1', port: 0, highWaterMark: 1 << 16 }, async (socket) => {
+            for (let chunk; (chunk = await socket.read()) !== null;) {
+                total += chunk.byteLength;
+                for (let i = 0; i < 100; ++i) {
+                    await null;
+                }
+            }
+            done();
+        });
+
+        const socket = await net.connect({ host: '127.0.0.1', port: server.port });
+        const data = new Uint8Array(16 << 20);
+        await socket.write(data);
+        socket.end();
+        await finished;
+        server.close();
+        return String(total === data.byteLength);
+    )");
+
+    EXPECT_EQ(result, "true");
+}
+
+TEST(TestNetModule, RejectsInvalidAddresses)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("net");
+
+    auto result = evaluate(env, R"(
+        const errors = [];
+        for (const address of [{ host: 'example.com', port: 80 }, { port: 70000 }]) {
+            try {
+                await net.connect(address);
+            } catch (error) {
+                errors.push(error.message);
+            }
+        }
+        try {
+            await net.connect({ host: '127.0.0.1', port: 1 });
+        } catch (error) {
+            errors.push('refused');
+        }
+        return errors.join('|');
+    )");
+
+    EXPECT_EQ(result, "Host 'example.com' is not an IP address|'port' must be an integer from 0 to 65535|refused");
+}
+
+TEST(TestNetModule, ReportsErrorsOfConnectionCallback)
+{
+    auto host = Runtime::create();
+    auto& env = host->createEnvironment("net");
+
+    testing::internal::CaptureStderr();
+    auto result = evaluate(env, R"(
+        const server = net.listen({ host: '127.0.0.1', port: 0 }, () => {
+            throw new Error('callback failed');
+        });
+        const socket = await net.connect({ host: '127.0.0.1', port: server.port });
+        const end = await socket.read();
+        server.close();
+        return String(end);
+    )");
+    auto output = testing::internal::GetCapturedStderr();
+
+    EXPECT_EQ(result, "null");
+    EXPECT_NE(output.find("Uncaught error in environment 'net'"), std::string::npos);
+    EXPECT_NE(output.find("callback failed"), std::string::npos);
+}